@@ -1,25 +1,53 @@
-// daisy - a simple, tiny, very fast, well-documented, Windows only, header-only library for 2D primitive and text rendering using D3D9 & GDI, written in C++17
+// daisy - a simple, tiny, very fast, well-documented, header-only library for 2D primitive and text rendering using D3D9 & GDI on Windows, written in C++17
+// - define DAISY_NO_D3D9 for just the platform-neutral geometry and batching core, which also builds headless on other platforms (eg. linux)
 // - written by munteanu octavian-adrian (https://github.com/sse2/daisy)
 // - MIT license (see end of file or github repo LICENSE.txt if you're unfamiliar with it)
 #ifndef _SSE2_DAISY_INCLUDE_GUARD
 #define _SSE2_DAISY_INCLUDE_GUARD
 
 // you can replace this with your own includes if you don't want to use the standard library,
-// however you'll need to provide your own implementations for the stl containers and they need to be at least mostly compatible with the ones provided by the standard library
+// however you'll need to provide your own implementations for the stl containers and they need to be at least mostly compatible with the ones provided by the standard library.
+// the README lists every name daisy takes from the stl namespace (containers, pmr resources, atomics, async, sorting and float math)
 #ifndef DAISY_NO_STL
 // stl includes
 #include <unordered_map> // std::unordered_map
+#include <memory_resource> // std::pmr::memory_resource, std::pmr::vector, std::pmr::unordered_map
 #include <string_view>   // std::string_view
 #include <vector>        // std::vector
 #include <array>         // std::array
 #include <atomic>        // std::atomic
+#include <future>        // std::future, std::async
 #include <memory>        // std::unique_ptr, std::make_unique
-#include <cstdint>       // uint/int types, fabsf, fmodf, sinf, cosf, floorf
-namespace stl = std;
+#include <new>           // placement new
+#include <initializer_list> // std::initializer_list
+#include <algorithm>     // std::sort, std::is_sorted
+#include <cstdint>       // uint/int types
+#include <cstddef>       // std::max_align_t
+#include <cmath>         // fabsf, fmodf, sinf, cosf, floorf
+#include <cstring>       // memcpy
+#include <cfloat>        // FLT_MAX, FLT_EPSILON
+#include <math.h>        // fabsf, fmodf, sinf, cosf, floorf in the global namespace
+namespace stl
+{
+  using namespace std;
+
+#if defined( __GLIBCXX__ )
+  // libstdc++ only declares the float versions of the c math functions globally
+  using ::acosf, ::atan2f, ::ceilf, ::cosf, ::erff, ::expf, ::fabsf, ::floorf, ::fmaxf, ::fminf, ::fmodf, ::powf, ::roundf, ::sinf, ::sqrtf;
+#endif // __GLIBCXX__
+} // namespace stl
 #endif // DAISY_NO_STL
 
-// d3d9
+// d3d9, define DAISY_NO_D3D9 to only get the platform-neutral core (c_drawlist and everything it needs), which also builds off windows
+#ifndef DAISY_NO_D3D9
 #include <d3d9.h>
+#endif // DAISY_NO_D3D9
+
+// simd, define DAISY_NO_SIMD if you want to stick to plain scalar code
+#if !defined( DAISY_NO_SIMD ) && ( defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined( __SSE2__ ) )
+#include <emmintrin.h> // sse2 intrinsics
+#define DAISY_SIMD_SSE2
+#endif // DAISY_NO_SIMD
 
 namespace daisy
 {
@@ -27,6 +55,52 @@ namespace daisy
   {
     constexpr static inline auto PI = 3.14159265358979323846f;
     constexpr static inline auto PI_SQUARED = PI * PI;
+
+    // frees buffers allocated by make_buffer
+    struct resource_deleter_t
+    {
+      stl::pmr::memory_resource *m_resource;
+      size_t m_bytes;
+
+      void operator( ) ( void *data ) const noexcept
+      {
+        // buffers without a resource only borrow their memory (eg. an adopted snapshot)
+        if ( this->m_resource )
+          this->m_resource->deallocate ( data, this->m_bytes, alignof ( stl::max_align_t ) );
+      }
+    };
+
+    // array owned by daisy, allocated from a memory resource
+    template < typename t >
+    using resource_buffer_t = stl::unique_ptr< t[], resource_deleter_t >;
+
+    /// <summary>
+    /// allocates a zeroed array from a memory resource, like make_unique would from the heap
+    /// </summary>
+    /// <typeparam name="t">element type, has to be trivial</typeparam>
+    /// <param name="resource">resource to allocate from</param>
+    /// <param name="count">number of elements</param>
+    /// <returns>array, empty if the resource couldn't allocate it</returns>
+    template < typename t >
+    inline resource_buffer_t< t > make_buffer ( stl::pmr::memory_resource *resource, const size_t count ) noexcept
+    {
+      const size_t bytes = sizeof ( t ) * count;
+
+      // resources report failure by throwing (std::bad_alloc for the standard ones), callers are noexcept and check for an empty buffer instead
+      t *data = nullptr;
+      try
+      {
+        data = static_cast< t * > ( resource->allocate ( bytes, alignof ( stl::max_align_t ) ) );
+      }
+      catch ( ... )
+      {
+        return resource_buffer_t< t > ( nullptr, resource_deleter_t { resource, 0 } );
+      }
+
+      memset ( data, 0, bytes );
+
+      return resource_buffer_t< t > ( data, resource_deleter_t { resource, bytes } );
+    }
   } // namespace detail
 
   // our color struct
@@ -102,14 +176,14 @@ namespace daisy
   struct daisy_vtx_t
   {
     float m_pos[ 4 ]; // x,y,z,rhw
-    D3DCOLOR m_col;
+    uint32_t m_col;   // bgra, same as D3DCOLOR
     float m_uv[ 2 ];
   };
 
   // buffer
   struct renderbuffer_t
   {
-    stl::unique_ptr< uint8_t[] > m_data { nullptr };
+    detail::resource_buffer_t< uint8_t > m_data { nullptr };
     uint32_t m_capacity { 0 }, m_size { 0 };
   };
 
@@ -122,6 +196,13 @@ namespace daisy
     CALL_SCISSOR
   };
 
+  // vertex and index range of a draw call. ranges are absolute instead of running sums, so calls can be reordered or spliced without walking
+  // the list. calls that don't draw anything keep their payload here instead, scissor calls the index of their rectangle in m_first_vertex
+  struct daisy_call_range_t
+  {
+    uint32_t m_first_vertex, m_vertices, m_first_index, m_indices;
+  };
+
   // used for text calls
   enum daisy_text_align : uint16_t
   {
@@ -142,933 +223,7541 @@ namespace daisy
     FONT_ITALIC = 1 << 1
   };
 
-  using uv_t = stl::array< float, 4 >;
-
-  struct point_t
+  // where a c_fontwrapper is in its creation, see c_fontwrapper::prepare
+  enum class daisy_font_state : uint8_t
   {
-    float x, y;
+    FONT_STATE_EMPTY = 0,
+    FONT_STATE_PREPARING, // glyphs are being rasterized, possibly on another thread
+    FONT_STATE_PREPARED,  // glyphs are rasterized, waiting for finalize() on the render thread
+    FONT_STATE_READY,     // texture is uploaded, font can be drawn with
+    FONT_STATE_FAILED
   };
 
-  struct daisy_drawcall_t
+  // pixel formats accepted by streaming textures
+  enum class daisy_stream_format : uint8_t
   {
-    daisy_call_kind m_kind;
+    STREAM_BGRA = 0, // 4 bytes per pixel, same layout as the texture (A8R8G8B8), copied as-is
+    STREAM_RGBA,     // 4 bytes per pixel, same layout as c_texatlas::append input
+    STREAM_GRAY      // 1 byte per pixel, expanded to opaque gray
+  };
 
-    union {
-      // for CALL_TRI
-      struct
-      {
-        IDirect3DTexture9 *m_texture_handle;
-        uint32_t m_primitives, m_vertices, m_indices;
-      } m_tri;
+  // how marker batches get drawn, picked on flush based on device caps
+  enum class daisy_marker_mode : uint8_t
+  {
+    MARKER_POINTSPRITE = 0, // one point sprite per marker, needs the marker to cover a whole texture
+    MARKER_INSTANCED,       // one instance of a shared quad per marker, needs vs_3_0/ps_3_0
+    MARKER_QUADS            // plain textured quads, works everywhere
+  };
 
-      // for shader pop/push calls
-      struct
-      {
-        void *m_shader_handle;
-      } m_shader;
+  // how c_renderqueue lays out vertices on the gpu
+  enum class daisy_vertex_layout : uint8_t
+  {
+    LAYOUT_INTERLEAVED = 0, // one buffer of daisy_vtx_t
+    LAYOUT_STREAMS          // separate position, color and uv buffers, so patches only upload the parts of vertices they touched
+  };
 
-      // for scissor pop/push calls
-      struct
-      {
-        point_t m_position, m_size;
-      } m_scissor;
-    };
+  // kind of commands recorded by a path
+  enum class daisy_path_cmd : uint8_t
+  {
+    PATH_MOVE = 0,
+    PATH_LINE,
+    PATH_QUAD,
+    PATH_CUBIC,
+    PATH_ARC,
+    PATH_CLOSE
   };
 
-  // this is the only global object. we need this because the alternative would be passing around the pointer to each texture atlas and font wrapper instance
-  // we don't really *need* it but it makes the code more readable
-  struct daisy_t
+  using uv_t = stl::array< float, 4 >;
+
+  struct point_t
   {
-    static inline IDirect3DDevice9 *s_device = nullptr;
+    float x, y;
   };
 
-  class c_daisy_resettable_object
+  // 2d affine transform, maps (x, y) to (a * x + c * y + tx, b * x + d * y + ty)
+  struct transform_t
   {
-  public:
+    float a, b, c, d, tx, ty;
+
     /// <summary>
-    /// called on device reset (pre/post)
+    /// returns identity transform
     /// </summary>
-    /// <param name="pre_reset">if this is called before device is reset</param>
-    /// <returns>true on success, false otherwise</returns>
-    virtual bool reset ( bool pre_reset = false ) noexcept = 0;
-  };
+    /// <returns>transform that doesn't change points</returns>
+    static constexpr transform_t identity ( ) noexcept
+    {
+      return { 1.f, 0.f, 0.f, 1.f, 0.f, 0.f };
+    }
 
-  // our font wrapper class
-  class c_fontwrapper : public c_daisy_resettable_object
-  {
-  private:
-    // members
-    stl::unordered_map< wchar_t, uv_t > m_coords;
-    stl::string_view m_family;
-    IDirect3DTexture9 *m_texture_handle;
-    float m_scale;
-    uint32_t m_width, m_height, m_spacing, m_size, m_quality;
-    uint8_t m_flags;
+    /// <summary>
+    /// returns translation transform
+    /// </summary>
+    /// <param name="offset">offset to move points by</param>
+    /// <returns>translation transform</returns>
+    static constexpr transform_t translation ( const point_t &offset ) noexcept
+    {
+      return { 1.f, 0.f, 0.f, 1.f, offset.x, offset.y };
+    }
 
-  private:
-    // methods
     /// <summary>
-    /// actually creates font instance and atlas
+    /// returns scale transform
     /// </summary>
-    /// <returns>true on succesful font creation, false otherwise</returns>
-    bool create_ex ( ) noexcept
+    /// <param name="scale">scale on each axis</param>
+    /// <returns>scale transform</returns>
+    static constexpr transform_t scaling ( const point_t &scale ) noexcept
     {
-      if ( !daisy_t::s_device )
-        return false;
+      return { scale.x, 0.f, 0.f, scale.y, 0.f, 0.f };
+    }
 
-      HDC gdi_ctx = nullptr;
-      HGDIOBJ gdi_font = nullptr, prev_gdi_font = nullptr, prev_bitmap = nullptr;
-      HBITMAP bitmap = nullptr;
+    /// <summary>
+    /// returns rotation transform
+    /// </summary>
+    /// <param name="angle">angle in radians</param>
+    /// <returns>rotation transform</returns>
+    static transform_t rotation ( const float angle ) noexcept
+    {
+      const float sin_angle = stl::sinf ( angle ), cos_angle = stl::cosf ( angle );
+      return { cos_angle, sin_angle, -sin_angle, cos_angle, 0.f, 0.f };
+    }
 
-      // function could be possibly called by reset handler
-      if ( this->m_texture_handle )
-        this->m_texture_handle->Release ( );
+    /// <summary>
+    /// combines two transforms, the right hand side transform is applied first
+    /// </summary>
+    /// <param name="rhs">transform to apply before this one</param>
+    /// <returns>combined transform</returns>
+    constexpr transform_t operator* ( const transform_t &rhs ) const noexcept
+    {
+      return { a * rhs.a + c * rhs.b, b * rhs.a + d * rhs.b,
+               a * rhs.c + c * rhs.d, b * rhs.c + d * rhs.d,
+               a * rhs.tx + c * rhs.ty + tx, b * rhs.tx + d * rhs.ty + ty };
+    }
 
-      // create GDI context
-      gdi_ctx = CreateCompatibleDC ( nullptr );
-      SetMapMode ( gdi_ctx, MM_TEXT );
+    /// <summary>
+    /// transforms a point
+    /// </summary>
+    /// <param name="point">point to transform</param>
+    /// <returns>transformed point</returns>
+    constexpr point_t apply ( const point_t &point ) const noexcept
+    {
+      return { a * point.x + c * point.y + tx, b * point.x + d * point.y + ty };
+    }
 
-      // create GDI font
-      this->create_gdi_font ( gdi_ctx, &gdi_font );
+    /// <summary>
+    /// returns the largest factor lengths get scaled by on either axis
+    /// </summary>
+    /// <returns>max axis scale</returns>
+    float max_scale ( ) const noexcept
+    {
+      const float sx = a * a + b * b, sy = c * c + d * d;
+      return stl::sqrtf ( sx > sy ? sx : sy );
+    }
+  };
 
-      prev_gdi_font = SelectObject ( gdi_ctx, gdi_font );
+  namespace detail
+  {
+    // max recursion depth when flattening bezier curves; 2^10 segments is more than enough for anything that fits on a screen
+    constexpr static inline auto BEZIER_MAX_DEPTH = 10;
 
-      // set default atlas size
-      this->m_width = this->m_height = 128;
+    // max length of a polyline miter join, relative to half of the line width
+    constexpr static inline auto MITER_LIMIT = 4.f;
 
-      // ensure our atlas is big enough
-      while ( this->paint_or_measure_alphabet ( gdi_ctx, true ) == 2 )
+    // max points stroked in one batch, each point takes two vertices and batches can't go over what 16 bit indices can address
+    constexpr static inline uint32_t POLYLINE_MAX_RUN = 0x10000 / 2;
+
+    // max columns of a plot drawn in one batch, each column takes four vertices
+    constexpr static inline uint32_t PLOT_MAX_COLUMNS = 0x10000 / 4;
+
+    /// <summary>
+    /// fnv-1a hash of a block of memory
+    /// </summary>
+    /// <param name="data">data to hash</param>
+    /// <param name="size">size of data in bytes</param>
+    /// <param name="seed">hash to continue from (by default the fnv-1a offset basis)</param>
+    /// <returns>64 bit hash of data</returns>
+    inline uint64_t hash_bytes ( const void *data, const size_t size, uint64_t seed = 0xcbf29ce484222325ull ) noexcept
+    {
+      const auto bytes = static_cast< const uint8_t * > ( data );
+
+      for ( size_t i = 0; i < size; ++i )
       {
-        this->m_width *= 2;
-        this->m_height *= 2;
+        seed ^= bytes[ i ];
+        seed *= 0x100000001b3ull;
       }
 
-      D3DCAPS9 caps { };
-      HRESULT res = daisy_t::s_device->GetDeviceCaps ( &caps );
-      if ( res != D3D_OK )
-        return false;
+      return seed;
+    }
 
-      // ensure our atlas isn't above max texture cap
-      // @todo; use texatlas
-      if ( this->m_width > static_cast< uint32_t > ( caps.MaxTextureWidth ) )
-      {
-        this->m_scale = static_cast< float > ( caps.MaxTextureWidth ) / this->m_width;
-        this->m_width = this->m_height = caps.MaxTextureWidth;
+    /// <summary>
+    /// adaptively flattens a quadratic bezier curve, appends every point except the first one
+    /// </summary>
+    /// <param name="p1">start point</param>
+    /// <param name="p2">control point</param>
+    /// <param name="p3">end point</param>
+    /// <param name="tolerance">squared flatness tolerance in pixels</param>
+    /// <param name="depth">current subdivision depth</param>
+    /// <param name="out">container the points are appended to</param>
+    inline void flatten_quad_bezier ( const point_t &p1, const point_t &p2, const point_t &p3, const float tolerance, const int depth, stl::pmr::vector< point_t > &out )
+    {
+      point_t delta = { p3.x - p1.x, p3.y - p1.y };
 
-        bool first_iteration = true;
+      // distance of the control point from the chord, scaled by the chord length
+      float d = stl::fabsf ( ( p2.x - p3.x ) * delta.y - ( p2.y - p3.y ) * delta.x );
 
-        do
-        {
-          if ( !first_iteration )
-            this->m_scale *= 0.9f;
+      if ( d * d <= tolerance * ( delta.x * delta.x + delta.y * delta.y ) || depth >= BEZIER_MAX_DEPTH )
+      {
+        out.push_back ( p3 );
+        return;
+      }
 
-          DeleteObject ( SelectObject ( gdi_ctx, prev_gdi_font ) );
+      // de casteljau split at t = 0.5
+      point_t p12 = { ( p1.x + p2.x ) * 0.5f, ( p1.y + p2.y ) * 0.5f };
+      point_t p23 = { ( p2.x + p3.x ) * 0.5f, ( p2.y + p3.y ) * 0.5f };
+      point_t p123 = { ( p12.x + p23.x ) * 0.5f, ( p12.y + p23.y ) * 0.5f };
 
-          this->create_gdi_font ( gdi_ctx, &gdi_font );
+      flatten_quad_bezier ( p1, p12, p123, tolerance, depth + 1, out );
+      flatten_quad_bezier ( p123, p23, p3, tolerance, depth + 1, out );
+    }
 
-          prev_gdi_font = SelectObject ( gdi_ctx, gdi_font );
+    /// <summary>
+    /// adaptively flattens a cubic bezier curve, appends every point except the first one
+    /// </summary>
+    /// <param name="p1">start point</param>
+    /// <param name="p2">first control point</param>
+    /// <param name="p3">second control point</param>
+    /// <param name="p4">end point</param>
+    /// <param name="tolerance">squared flatness tolerance in pixels</param>
+    /// <param name="depth">current subdivision depth</param>
+    /// <param name="out">container the points are appended to</param>
+    inline void flatten_cubic_bezier ( const point_t &p1, const point_t &p2, const point_t &p3, const point_t &p4, const float tolerance, const int depth, stl::pmr::vector< point_t > &out )
+    {
+      point_t delta = { p4.x - p1.x, p4.y - p1.y };
 
-          first_iteration = false;
-        } while ( this->paint_or_measure_alphabet ( gdi_ctx, true ) == 2 );
+      // distance of both control points from the chord, scaled by the chord length
+      float d2 = stl::fabsf ( ( p2.x - p4.x ) * delta.y - ( p2.y - p4.y ) * delta.x );
+      float d3 = stl::fabsf ( ( p3.x - p4.x ) * delta.y - ( p3.y - p4.y ) * delta.x );
+
+      if ( ( d2 + d3 ) * ( d2 + d3 ) <= tolerance * ( delta.x * delta.x + delta.y * delta.y ) || depth >= BEZIER_MAX_DEPTH )
+      {
+        out.push_back ( p4 );
+        return;
       }
 
-      // create dx9 tex
-      res = daisy_t::s_device->CreateTexture ( this->m_width, this->m_height, 1, D3DUSAGE_DYNAMIC, D3DFMT_A4R4G4B4, D3DPOOL_DEFAULT, &this->m_texture_handle, nullptr );
-      if ( res != D3D_OK || !this->m_texture_handle )
-        return false;
+      // de casteljau split at t = 0.5
+      point_t p12 = { ( p1.x + p2.x ) * 0.5f, ( p1.y + p2.y ) * 0.5f };
+      point_t p23 = { ( p2.x + p3.x ) * 0.5f, ( p2.y + p3.y ) * 0.5f };
+      point_t p34 = { ( p3.x + p4.x ) * 0.5f, ( p3.y + p4.y ) * 0.5f };
+      point_t p123 = { ( p12.x + p23.x ) * 0.5f, ( p12.y + p23.y ) * 0.5f };
+      point_t p234 = { ( p23.x + p34.x ) * 0.5f, ( p23.y + p34.y ) * 0.5f };
+      point_t p1234 = { ( p123.x + p234.x ) * 0.5f, ( p123.y + p234.y ) * 0.5f };
 
-      DWORD *bitmap_bits = nullptr;
+      flatten_cubic_bezier ( p1, p12, p123, p1234, tolerance, depth + 1, out );
+      flatten_cubic_bezier ( p1234, p234, p34, p4, tolerance, depth + 1, out );
+    }
 
-      BITMAPINFO bitmap_ctx { };
-      bitmap_ctx.bmiHeader.biSize = sizeof ( BITMAPINFOHEADER );
-      bitmap_ctx.bmiHeader.biWidth = this->m_width;
-      bitmap_ctx.bmiHeader.biHeight = -static_cast< int32_t > ( this->m_height );
-      bitmap_ctx.bmiHeader.biPlanes = 1;
-      bitmap_ctx.bmiHeader.biCompression = BI_RGB;
-      bitmap_ctx.bmiHeader.biBitCount = 32;
+    /// <summary>
+    /// triangulates a simple (possibly concave or self-touching) polygon by ear clipping
+    /// </summary>
+    /// <param name="points">points of polygon, in any winding order</param>
+    /// <param name="count">number of points (at most 65535)</param>
+    /// <param name="out">container the triangle indices are appended to, (count - 2) * 3 indices are always written</param>
+    inline void triangulate_polygon ( const point_t *points, const uint32_t count, stl::pmr::vector< uint16_t > &out )
+    {
+      if ( count < 3 )
+        return;
 
-      bitmap = CreateDIBSection ( gdi_ctx, &bitmap_ctx, DIB_RGB_COLORS, reinterpret_cast< void ** > ( &bitmap_bits ), nullptr, 0 );
-      if ( !bitmap )
-        return false;
+      // doubled signed area, tells us the winding order
+      float area = 0.f;
+      for ( uint32_t i = 0, j = count - 1; i < count; j = i++ )
+        area += points[ j ].x * points[ i ].y - points[ i ].x * points[ j ].y;
 
-      prev_bitmap = SelectObject ( gdi_ctx, bitmap );
+      const float winding = area < 0.f ? -1.f : 1.f;
 
-      SetTextColor ( gdi_ctx, RGB ( 255, 255, 255 ) );
-      SetBkColor ( gdi_ctx, 0x00000000 );
-      SetTextAlign ( gdi_ctx, TA_TOP );
+      const auto cross = [ & ] ( const point_t &a, const point_t &b, const point_t &c ) -> float {
+        return ( ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x ) ) * winding;
+      };
 
-      // to note: paint_alphabet returns 0 on success
-      if ( this->paint_or_measure_alphabet ( gdi_ctx, false ) )
-        return false;
+      const auto same = [ ] ( const point_t &a, const point_t &b ) -> bool {
+        return a.x == b.x && a.y == b.y;
+      };
 
-      D3DLOCKED_RECT locked_rect;
-      if ( this->m_texture_handle->LockRect ( 0, &locked_rect, nullptr, 0 ) != D3D_OK )
-        return false;
+      stl::pmr::vector< uint16_t > remaining ( count, out.get_allocator ( ) );
+      for ( uint32_t i = 0; i < count; ++i )
+        remaining[ i ] = static_cast< uint16_t > ( i );
 
-      uint8_t *dst_row = static_cast< uint8_t * > ( locked_rect.pBits );
-      BYTE alpha;
+      uint32_t cursor = 0;
+      uint32_t misses = 0;
 
-      // write to texture
-      for ( uint32_t y = 0; y < this->m_height; y++ )
+      while ( remaining.size ( ) > 3 )
       {
-        uint16_t *dst = reinterpret_cast< uint16_t * > ( dst_row );
-        for ( uint32_t x = 0; x < this->m_width; x++ )
+        const auto size = static_cast< uint32_t > ( remaining.size ( ) );
+        const auto prev = remaining[ ( cursor + size - 1 ) % size ];
+        const auto cur = remaining[ cursor % size ];
+        const auto next = remaining[ ( cursor + 1 ) % size ];
+
+        const auto &a = points[ prev ];
+        const auto &b = points[ cur ];
+        const auto &c = points[ next ];
+
+        bool is_ear = cross ( a, b, c ) > 0.f;
+
+        // an ear can't contain or touch any other vertex, vertices sitting right on the ear's corners are fine (self-touching polygons)
+        for ( uint32_t i = 0; is_ear && i < size; ++i )
         {
-          alpha = ( ( bitmap_bits[ this->m_width * y + x ] & 0xff ) >> 4 );
-          if ( alpha > 0 )
-          {
-            *dst++ = ( ( alpha << 12 ) | 0x0fff );
-          }
-          else
-          {
-            *dst++ = 0x0000;
-          }
+          const auto &p = points[ remaining[ i ] ];
+
+          if ( same ( p, a ) || same ( p, b ) || same ( p, c ) )
+            continue;
+
+          if ( cross ( a, b, p ) >= 0.f && cross ( b, c, p ) >= 0.f && cross ( c, a, p ) >= 0.f )
+            is_ear = false;
         }
-        dst_row += locked_rect.Pitch;
-      }
 
-      if ( this->m_texture_handle->UnlockRect ( 0 ) != D3D_OK )
-        return false;
+        // if we went around the whole polygon without finding an ear the input is degenerate or self-intersecting,
+        // clip the current vertex anyways so we always terminate with the expected amount of triangles
+        if ( is_ear || misses >= size )
+        {
+          out.push_back ( prev );
+          out.push_back ( cur );
+          out.push_back ( next );
 
-      // clean up
-      SelectObject ( gdi_ctx, prev_bitmap );
-      SelectObject ( gdi_ctx, prev_gdi_font );
-      DeleteObject ( bitmap );
-      DeleteObject ( gdi_font );
-      DeleteDC ( gdi_ctx );
+          remaining.erase ( remaining.begin ( ) + ( cursor % size ) );
 
-      return true;
-    }
+          // step back so the previous vertex gets re-tested, it might have become an ear
+          cursor = ( cursor + size - 2 ) % ( size - 1 );
+          misses = 0;
+        }
+        else
+        {
+          cursor = ( cursor + 1 ) % size;
+          ++misses;
+        }
+      }
 
-    /// <summary>
-    /// creates GDI font
-    /// </summary>
-    /// <param name="context">GDI context</param>
-    /// <param name="gdi_font">font GDI object</param>
-    void create_gdi_font ( HDC context, HGDIOBJ *gdi_font ) noexcept
-    {
-      *gdi_font = CreateFontA ( -MulDiv ( this->m_size, static_cast< int > ( GetDeviceCaps ( context, LOGPIXELSY ) * this->m_scale ), 72 ),
-                                0, 0, 0, ( this->m_flags & daisy_font_flags::FONT_BOLD ) ? FW_BOLD : FW_NORMAL, ( this->m_flags & daisy_font_flags::FONT_ITALIC ) ? TRUE : FALSE,
-                                FALSE, FALSE, DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, this->m_quality, VARIABLE_PITCH, this->m_family.data ( ) );
+      out.push_back ( remaining[ 0 ] );
+      out.push_back ( remaining[ 1 ] );
+      out.push_back ( remaining[ 2 ] );
     }
 
     /// <summary>
-    /// measures or paints alphabet
+    /// accumulates signed area covered by a line into a coverage accumulation buffer (scanline rasterizer with analytic coverage).
+    /// once every edge of a closed shape is accumulated, a running sum over the buffer yields per-pixel coverage
     /// </summary>
-    /// <param name="context">GDI context</param>
-    /// <param name="measure">if we should only measure, not paint alphabet</param>
-    /// <returns>0 on success, 1 on GDI error, 2 if texture atlas can't contain our glyphs</returns>
-    int paint_or_measure_alphabet ( HDC context, bool measure = false ) noexcept
+    /// <param name="acc">accumulation buffer of width * height + 2 floats (lines touching the right border spill over by up to 2)</param>
+    /// <param name="width">width of buffer in pixels</param>
+    /// <param name="height">height of buffer in pixels</param>
+    /// <param name="p1">start of line</param>
+    /// <param name="p2">end of line</param>
+    inline void accumulate_line ( float *acc, const uint32_t width, const uint32_t height, point_t p1, point_t p2 ) noexcept
     {
-      SIZE size;
-      wchar_t chr[] = L"x\0\0";
+      const float w = static_cast< float > ( width );
 
-      if ( !GetTextExtentPoint32W ( context, chr, 1, &size ) )
-        return 1;
+      // split lines crossing the left or right border, parts that fall outside get flattened onto the border
+      for ( const float border : { 0.f, w } )
+      {
+        if ( ( p1.x < border && p2.x > border ) || ( p1.x > border && p2.x < border ) )
+        {
+          const float t = ( border - p1.x ) / ( p2.x - p1.x );
+          const point_t mid { border, p1.y + ( p2.y - p1.y ) * t };
 
-      // thanks dex for help with this
-      const auto unicode_ranges_size = GetFontUnicodeRanges ( context, nullptr );
-      if ( !unicode_ranges_size )
-        return 1;
+          accumulate_line ( acc, width, height, p1, mid );
+          accumulate_line ( acc, width, height, mid, p2 );
+          return;
+        }
+      }
 
-      auto glyph_sets_memory = stl::make_unique< uint8_t[] > ( unicode_ranges_size );
-      if ( !glyph_sets_memory )
-        return 1;
+      p1.x = p1.x < 0.f ? 0.f : ( p1.x > w ? w : p1.x );
+      p2.x = p2.x < 0.f ? 0.f : ( p2.x > w ? w : p2.x );
 
-      auto glyph_sets = reinterpret_cast< GLYPHSET * > ( glyph_sets_memory.get ( ) );
+      if ( p1.y == p2.y )
+        return;
 
-      if ( !GetFontUnicodeRanges ( context, glyph_sets ) )
-        return 1;
+      float dir = 1.f;
+      if ( p1.y > p2.y )
+      {
+        dir = -1.f;
+        stl::swap ( p1, p2 );
+      }
 
-      this->m_spacing = static_cast< uint32_t > ( ceil ( size.cy * 0.3f ) );
+      const float dxdy = ( p2.x - p1.x ) / ( p2.y - p1.y );
 
-      uint32_t x = this->m_spacing;
-      uint32_t y = 0;
+      float x = p1.x;
+      if ( p1.y < 0.f )
+        x -= p1.y * dxdy;
 
-      // iterate glyph ranges
-      for ( uint32_t r = 0; r < glyph_sets->cRanges; ++r )
+      const int y_start = p1.y > 0.f ? static_cast< int > ( p1.y ) : 0;
+      const int y_end = p2.y < static_cast< float > ( height ) ? static_cast< int > ( stl::ceilf ( p2.y ) ) : static_cast< int > ( height );
+
+      for ( int y = y_start; y < y_end; ++y )
       {
-        // iterate glyphs
-        for ( auto ch = glyph_sets->ranges[ r ].wcLow; ch < ( glyph_sets->ranges[ r ].wcLow + glyph_sets->ranges[ r ].cGlyphs ); ++ch )
+        const uint32_t line_start = static_cast< uint32_t > ( y ) * width;
+
+        const float fy = static_cast< float > ( y );
+        const float dy = ( p2.y < fy + 1.f ? p2.y : fy + 1.f ) - ( p1.y > fy ? p1.y : fy );
+        const float x_next = x + dxdy * dy;
+        const float d = dy * dir;
+
+        const float x0 = x < x_next ? x : x_next;
+        const float x1 = x < x_next ? x_next : x;
+        const float x0_floor = stl::floorf ( x0 );
+        const float x1_ceil = stl::ceilf ( x1 );
+        const uint32_t x0i = static_cast< uint32_t > ( x0_floor );
+        const uint32_t x1i = static_cast< uint32_t > ( x1_ceil );
+
+        // line stays within a single pixel on this row
+        if ( x1i <= x0i + 1 )
         {
-          // get metrics of the current character
-          if ( !GetTextExtentPoint32W ( context, &ch, 1, &size ) )
-            continue;
+          const float xmf = 0.5f * ( x + x_next ) - x0_floor;
 
-          if ( x + size.cx + this->m_spacing > this->m_width )
-          {
-            x = this->m_spacing;
-            y += size.cy + 1;
-          }
+          acc[ line_start + x0i ] += d - d * xmf;
+          acc[ line_start + x0i + 1 ] += d * xmf;
+        }
+        else
+        {
+          const float inv_span = 1.f / ( x1 - x0 );
+          const float x0f = x0 - x0_floor;
+          const float a0 = 0.5f * inv_span * ( 1.f - x0f ) * ( 1.f - x0f );
+          const float x1f = x1 - x1_ceil + 1.f;
+          const float am = 0.5f * inv_span * x1f * x1f;
 
-          // ran out of space in texture
-          if ( y + size.cy > this->m_height )
-            return 2;
+          acc[ line_start + x0i ] += d * a0;
 
-          if ( !measure )
+          if ( x1i == x0i + 2 )
+            acc[ line_start + x0i + 1 ] += d * ( 1.f - a0 - am );
+          else
           {
-            if ( !ExtTextOutW ( context, x + 0, y + 0, ETO_OPAQUE, nullptr, &ch, 1, nullptr ) )
-              return 1;
+            const float a1 = inv_span * ( 1.5f - x0f );
+            acc[ line_start + x0i + 1 ] += d * ( a1 - a0 );
 
-            this->m_coords[ static_cast< uint16_t > ( ch ) ][ 0 ] = ( static_cast< float > ( x + 0 - this->m_spacing ) ) / this->m_width;
-            this->m_coords[ static_cast< uint16_t > ( ch ) ][ 1 ] = ( static_cast< float > ( y + 0 + 0 ) ) / this->m_height;
-            this->m_coords[ static_cast< uint16_t > ( ch ) ][ 2 ] = ( static_cast< float > ( x + size.cx + this->m_spacing ) ) / this->m_width;
-            this->m_coords[ static_cast< uint16_t > ( ch ) ][ 3 ] = ( static_cast< float > ( y + size.cy + 0 ) ) / this->m_height;
+            for ( uint32_t xi = x0i + 2; xi < x1i - 1; ++xi )
+              acc[ line_start + xi ] += d * inv_span;
+
+            const float a2 = a1 + static_cast< float > ( x1i - x0i - 3 ) * inv_span;
+            acc[ line_start + x1i - 1 ] += d * ( 1.f - a2 - am );
           }
 
-          x += size.cx + ( 2 * this->m_spacing );
+          acc[ line_start + x1i ] += d * am;
         }
-      }
-
-      return 0;
-    }
 
-  public:
-    // inits everything with 0
-    c_fontwrapper ( ) noexcept
-        : m_family ( ), m_texture_handle ( nullptr ), m_scale ( 0.f ), m_width ( 0 ), m_height ( 0 ), m_spacing ( 0 ), m_size ( 0 ), m_quality ( NONANTIALIASED_QUALITY ), m_flags ( 0 )
-    {
+        x = x_next;
+      }
     }
 
-    // disallow copying
-    c_fontwrapper ( const c_fontwrapper & ) = delete;
-    c_fontwrapper &operator= ( const c_fontwrapper & ) = delete;
-
     /// <summary>
-    /// creates font instance and atlas
+    /// finds min and max of a range of floats
     /// </summary>
-    /// <param name="family">font family name, for example "Arial" (to note; fonts added by AddFontMemResourceEx also work)</param>
-    /// <param name="height">font height</param>
-    /// <param name="quality">font quality (NONANTIALIASED_QUALITY, CLEARTYPE_NATURAL_QUALITY etc.)</param>
-    /// <param name="flags">font flags (see enum daisy_font_flags; FONT_DEFAULT, FONT_BOLD, FONT_ITALIC)</param>
-    /// <returns>true on succesful font creation, false otherwise</returns>
-    [[nodiscard]] bool create ( const stl::string_view family, uint32_t height, uint32_t quality, uint8_t flags ) noexcept
+    /// <param name="data">values</param>
+    /// <param name="count">number of values (at least 1)</param>
+    /// <param name="lo">min value</param>
+    /// <param name="hi">max value</param>
+    inline void min_max ( const float *data, const uint32_t count, float &lo, float &hi ) noexcept
     {
-      this->m_family = family;
-      this->m_size = height;
-      this->m_flags = flags;
-      this->m_quality = quality;
-      this->m_scale = 1.f;
-      this->m_spacing = 0;
+      uint32_t i = 0;
+      lo = hi = data[ 0 ];
 
-      return this->create_ex ( );
+#ifdef DAISY_SIMD_SSE2
+      if ( count >= 8 )
+      {
+        __m128 vlo = _mm_loadu_ps ( data ), vhi = vlo;
+
+        for ( i = 4; i + 4 <= count; i += 4 )
+        {
+          const __m128 v = _mm_loadu_ps ( data + i );
+          vlo = _mm_min_ps ( vlo, v );
+          vhi = _mm_max_ps ( vhi, v );
+        }
+
+        // horizontal reduction
+        vlo = _mm_min_ps ( vlo, _mm_shuffle_ps ( vlo, vlo, _MM_SHUFFLE ( 1, 0, 3, 2 ) ) );
+        vlo = _mm_min_ps ( vlo, _mm_shuffle_ps ( vlo, vlo, _MM_SHUFFLE ( 2, 3, 0, 1 ) ) );
+        vhi = _mm_max_ps ( vhi, _mm_shuffle_ps ( vhi, vhi, _MM_SHUFFLE ( 1, 0, 3, 2 ) ) );
+        vhi = _mm_max_ps ( vhi, _mm_shuffle_ps ( vhi, vhi, _MM_SHUFFLE ( 2, 3, 0, 1 ) ) );
+
+        lo = _mm_cvtss_f32 ( vlo );
+        hi = _mm_cvtss_f32 ( vhi );
+      }
+#endif // DAISY_SIMD_SSE2
+
+      for ( ; i < count; ++i )
+      {
+        if ( data[ i ] < lo )
+          lo = data[ i ];
+
+        if ( data[ i ] > hi )
+          hi = data[ i ];
+      }
     }
 
     /// <summary>
-    /// returns measured text extent in pixels
+    /// converts a row of pixels to A8R8G8B8 (bgra in memory)
     /// </summary>
-    /// <typeparam name="t">iteratable text container (only char and wchar_t accepted currently)</typeparam>
-    /// <param name="text">text to measure</param>
-    /// <returns>point_t containing width and height of measured text</returns>
-    template < typename t = stl::string_view >
-    point_t text_extent ( t text ) noexcept
+    /// <param name="src">source pixels</param>
+    /// <param name="dst">destination pixels</param>
+    /// <param name="width">number of pixels</param>
+    /// <param name="format">format of source pixels</param>
+    inline void convert_row ( const uint8_t *src, uint8_t *dst, const uint32_t width, const daisy_stream_format format ) noexcept
     {
-      float row_width = 0.f;
-      float row_height = ( this->m_coords[ static_cast< wchar_t > ( 32 ) ][ 3 ] - this->m_coords[ static_cast< wchar_t > ( 32 ) ][ 1 ] ) * this->m_height;
-      float width = 0.f;
-      float height = row_height;
+      uint32_t x = 0;
 
-      for ( const auto c : text )
+      switch ( format )
       {
-        if ( c == '\n' )
+      case daisy_stream_format::STREAM_BGRA:
+        memcpy ( dst, src, width * 4 );
+        break;
+      case daisy_stream_format::STREAM_RGBA:
+#ifdef DAISY_SIMD_SSE2
+        // swap red and blue of 4 pixels at a time
+        for ( ; x + 4 <= width; x += 4 )
         {
-          row_width = 0.f;
-          height += row_height;
+          const __m128i v = _mm_loadu_si128 ( reinterpret_cast< const __m128i * > ( src + x * 4 ) );
+          const __m128i ga = _mm_and_si128 ( v, _mm_set1_epi32 ( static_cast< int > ( 0xff00ff00 ) ) );
+          const __m128i r = _mm_and_si128 ( _mm_srli_epi32 ( v, 16 ), _mm_set1_epi32 ( 0x000000ff ) );
+          const __m128i b = _mm_slli_epi32 ( _mm_and_si128 ( v, _mm_set1_epi32 ( 0x000000ff ) ), 16 );
+
+          _mm_storeu_si128 ( reinterpret_cast< __m128i * > ( dst + x * 4 ), _mm_or_si128 ( ga, _mm_or_si128 ( r, b ) ) );
         }
+#endif // DAISY_SIMD_SSE2
 
-        if ( c < ' ' )
-          continue;
+        for ( ; x < width; ++x )
+        {
+          dst[ x * 4 + 0 ] = src[ x * 4 + 2 ];
+          dst[ x * 4 + 1 ] = src[ x * 4 + 1 ];
+          dst[ x * 4 + 2 ] = src[ x * 4 + 0 ];
+          dst[ x * 4 + 3 ] = src[ x * 4 + 3 ];
+        }
+        break;
+      case daisy_stream_format::STREAM_GRAY:
+#ifdef DAISY_SIMD_SSE2
+        // expand 16 pixels at a time; gg pairs interleaved with g/ff pairs give g, g, g, ff
+        for ( ; x + 16 <= width; x += 16 )
+        {
+          const __m128i v = _mm_loadu_si128 ( reinterpret_cast< const __m128i * > ( src + x ) );
+          const __m128i opaque = _mm_set1_epi8 ( static_cast< char > ( 0xff ) );
 
-        float tx1 = this->m_coords[ static_cast< wchar_t > ( c ) ][ 0 ];
-        float tx2 = this->m_coords[ static_cast< wchar_t > ( c ) ][ 2 ];
+          const __m128i gg_lo = _mm_unpacklo_epi8 ( v, v ), gg_hi = _mm_unpackhi_epi8 ( v, v );
+          const __m128i ga_lo = _mm_unpacklo_epi8 ( v, opaque ), ga_hi = _mm_unpackhi_epi8 ( v, opaque );
 
-        row_width += ( tx2 - tx1 ) * this->m_width - 2.f * this->m_spacing;
+          __m128i *out = reinterpret_cast< __m128i * > ( dst + x * 4 );
+          _mm_storeu_si128 ( out + 0, _mm_unpacklo_epi16 ( gg_lo, ga_lo ) );
+          _mm_storeu_si128 ( out + 1, _mm_unpackhi_epi16 ( gg_lo, ga_lo ) );
+          _mm_storeu_si128 ( out + 2, _mm_unpacklo_epi16 ( gg_hi, ga_hi ) );
+          _mm_storeu_si128 ( out + 3, _mm_unpackhi_epi16 ( gg_hi, ga_hi ) );
+        }
+#endif // DAISY_SIMD_SSE2
 
-        if ( row_width > width )
-          width = row_width;
+        for ( ; x < width; ++x )
+        {
+          dst[ x * 4 + 0 ] = dst[ x * 4 + 1 ] = dst[ x * 4 + 2 ] = src[ x ];
+          dst[ x * 4 + 3 ] = 255;
+        }
+        break;
       }
-
-      return { width, height };
     }
 
+#ifndef DAISY_NO_D3D9
+    // hand assembled shader bytecode, used for hardware instancing which needs the programmable pipeline (and vs_3_0 has to be paired with ps_3_0)
+
+    // vs_3_0
+    // dcl_texcoord0 v0 (quad corner, [-0.5, 0.5]), dcl_texcoord1 v1 (instance position), dcl_color0 v2 (instance color)
+    // c0 = { 2 / viewport width, -2 / viewport height, 1 / viewport width - 1, 1 - 1 / viewport height }, maps pixels to clip space like pre-transformed vertices
+    // c1 = { marker width, marker height, 0, 0 }, c2 = { uv center x, uv center y, uv width, uv height }, c3 = { 0, 0, 0, 1 }
+    constexpr static inline DWORD MARKER_VS[] = {
+        0xfffe0300,                                     // vs_3_0
+        0x0200001f, 0x80000005, 0x900f0000,             // dcl_texcoord0 v0
+        0x0200001f, 0x80010005, 0x900f0001,             // dcl_texcoord1 v1
+        0x0200001f, 0x8000000a, 0x900f0002,             // dcl_color0 v2
+        0x0200001f, 0x80000000, 0xe00f0000,             // dcl_position o0
+        0x0200001f, 0x8000000a, 0xe00f0001,             // dcl_color0 o1
+        0x0200001f, 0x80000005, 0xe0030002,             // dcl_texcoord0 o2.xy
+        0x04000004, 0x80030000, 0x90e40000, 0xa0e40001, 0x90e40001, // mad r0.xy, v0, c1, v1
+        0x04000004, 0xe0030000, 0x80e40000, 0xa0e40000, 0xa0ee0000, // mad o0.xy, r0, c0, c0.zwzw
+        0x02000001, 0xe00c0000, 0xa0e40003,             // mov o0.zw, c3
+        0x02000001, 0xe00f0001, 0x90e40002,             // mov o1, v2
+        0x04000004, 0xe0030002, 0x90e40000, 0xa0ee0002, 0xa0e40002, // mad o2.xy, v0, c2.zwzw, c2
+        0x0000ffff                                      // end
+    };
+
+    // ps_3_0, modulates texture with diffuse color like the fixed function setup in daisy_prepare
+    constexpr static inline DWORD TEXTURED_PS[] = {
+        0xffff0300,                                     // ps_3_0
+        0x0200001f, 0x8000000a, 0x900f0000,             // dcl_color0 v0
+        0x0200001f, 0x80000005, 0x90030001,             // dcl_texcoord0 v1.xy
+        0x0200001f, 0x90000000, 0xa00f0800,             // dcl_2d s0
+        0x03000042, 0x800f0000, 0x90e40001, 0xa0e40800, // texld r0, v1, s0
+        0x03000005, 0x800f0800, 0x80e40000, 0x90e40000, // mul oC0, r0, v0
+        0x0000ffff                                      // end
+    };
+
+    // vs_3_0
+    // dcl_texcoord0 v0 (quad corner, [0, 1]), dcl_texcoord1 v1 (instance rect, x y w h), dcl_texcoord2 v2 (instance uv rect, u1 v1 u2 v2), dcl_color0 v3 (instance color)
+    // c0 = same viewport mapping as MARKER_VS, c1 = { 0, 0, 0, 1 }
+    constexpr static inline DWORD QUAD_VS[] = {
+        0xfffe0300,                                     // vs_3_0
+        0x0200001f, 0x80000005, 0x900f0000,             // dcl_texcoord0 v0
+        0x0200001f, 0x80010005, 0x900f0001,             // dcl_texcoord1 v1
+        0x0200001f, 0x80020005, 0x900f0002,             // dcl_texcoord2 v2
+        0x0200001f, 0x8000000a, 0x900f0003,             // dcl_color0 v3
+        0x0200001f, 0x80000000, 0xe00f0000,             // dcl_position o0
+        0x0200001f, 0x8000000a, 0xe00f0001,             // dcl_color0 o1
+        0x0200001f, 0x80000005, 0xe0030002,             // dcl_texcoord0 o2.xy
+        0x04000004, 0x80030000, 0x90e40000, 0x90ee0001, 0x90e40001, // mad r0.xy, v0, v1.zwzw, v1
+        0x04000004, 0xe0030000, 0x80e40000, 0xa0e40000, 0xa0ee0000, // mad o0.xy, r0, c0, c0.zwzw
+        0x02000001, 0xe00c0000, 0xa0e40001,             // mov o0.zw, c1
+        0x02000001, 0xe00f0001, 0x90e40003,             // mov o1, v3
+        0x03000002, 0x80030001, 0x90ee0002, 0x91e40002, // add r1.xy, v2.zwzw, -v2
+        0x04000004, 0xe0030002, 0x90e40000, 0x80e40001, 0x90e40002, // mad o2.xy, v0, r1, v2
+        0x0000ffff                                      // end
+    };
+
     /// <summary>
-    /// called on device reset (pre/post)
+    /// returns bit pattern of a float, for render states that take floats
     /// </summary>
-    /// <param name="pre_reset">if this is called before device is reset</param>
-    /// <returns>true on success, false otherwise</returns>
-    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    /// <param name="value">float value</param>
+    /// <returns>bit pattern of value</returns>
+    inline DWORD float_bits ( const float value ) noexcept
     {
-      if ( !pre_reset )
-        return this->create_ex ( );
-      else if ( this->m_texture_handle )
-        this->m_texture_handle->Release ( );
+      DWORD bits;
+      memcpy ( &bits, &value, sizeof ( float ) );
+      return bits;
+    }
+#endif // DAISY_NO_D3D9
 
-      return true;
+    // layout of the shared memory section between c_sharedqueue_producer and c_sharedqueue. the section is mapped at different addresses in
+    // each process, so everything in it is addressed by offsets: the header, followed by SHARED_QUEUE_SLOTS frame slots of
+    // [shared_slot_t][vertices][draw calls][indices]
+    constexpr static inline uint32_t SHARED_QUEUE_MAGIC = 0x71797364; // "dsyq"
+    constexpr static inline uint32_t SHARED_QUEUE_SLOTS = 3;
+    constexpr static inline uint32_t SHARED_QUEUE_FRESH = 1 << 2; // set on the ready slot until the consumer picks it up
+    constexpr static inline uint32_t SHARED_QUEUE_ALIGN = 64;
+
+    struct shared_drawcall_t
+    {
+      uint32_t m_texture, m_vertices, m_indices, m_primitives;
+    };
+
+    struct shared_slot_t
+    {
+      uint32_t m_vertices, m_indices, m_drawcalls;
+    };
+
+    struct shared_header_t
+    {
+      uint32_t m_magic, m_vertex_size, m_max_vertices, m_max_indices, m_max_drawcalls, m_slot_size;
+
+      // slot holding the latest complete frame. producer and consumer each own one of the other two slots, and swap theirs with this one
+      stl::atomic< uint32_t > m_ready;
+
+      // slot the consumer currently draws from, so a restarted producer doesn't pick it
+      stl::atomic< uint32_t > m_reading;
+    };
+
+    // capacities of a section. each side keeps its own copy, validated once, and computes every offset from that, since the other process
+    // can still write to the header
+    struct shared_layout_t
+    {
+      uint32_t m_max_vertices, m_max_indices, m_max_drawcalls, m_slot_size;
+    };
+
+    /// <summary>
+    /// rounds size up to SHARED_QUEUE_ALIGN
+    /// </summary>
+    /// <param name="size">size in bytes</param>
+    /// <returns>aligned size</returns>
+    constexpr uint32_t shared_align ( const uint32_t size ) noexcept
+    {
+      return ( size + SHARED_QUEUE_ALIGN - 1 ) & ~( SHARED_QUEUE_ALIGN - 1 );
     }
 
     /// <summary>
-    /// erases the font
+    /// computes size of one frame slot. done in 64 bits, the capacities may come from another process
     /// </summary>
-    void erase ( ) noexcept
+    /// <param name="layout">capacities of section, m_slot_size is ignored</param>
+    /// <returns>size in bytes</returns>
+    inline uint64_t shared_slot_size ( const shared_layout_t &layout ) noexcept
     {
-      if ( this->m_texture_handle )
-        this->m_texture_handle->Release ( );
+      const uint64_t sizes[] = { sizeof ( shared_slot_t ), uint64_t { layout.m_max_vertices } * sizeof ( daisy_vtx_t ), uint64_t { layout.m_max_drawcalls } * sizeof ( shared_drawcall_t ),
+                                 uint64_t { layout.m_max_indices } * sizeof ( uint16_t ) };
 
-      this->m_coords.clear ( );
+      uint64_t size = 0;
+      for ( const auto part : sizes )
+        size += ( part + SHARED_QUEUE_ALIGN - 1 ) & ~uint64_t { SHARED_QUEUE_ALIGN - 1 };
 
-      this->m_size = this->m_spacing = this->m_flags = 0;
-      this->m_scale = 1.f;
-      this->m_family = "";
+      return size;
     }
 
-    // getters
-
     /// <summary>
-    /// get UV coordinates of glyph
+    /// computes size of a whole section
     /// </summary>
-    /// <typeparam name="t">char, wchar_t</typeparam>
-    /// <param name="glyph">character to get glyph UV coordinates for</param>
-    /// <returns>UV coordinates of glyph</returns>
-    template < typename t = char >
-    const uv_t &coords ( t glyph ) const noexcept
+    /// <param name="slot_size">size of one frame slot</param>
+    /// <returns>size in bytes</returns>
+    inline uint64_t shared_section_size ( const uint64_t slot_size ) noexcept
     {
-      if ( this->m_coords.find ( glyph ) != this->m_coords.end ( ) )
-        return this->m_coords.at ( glyph );
-
-      static uv_t null_uv { 0.f, 0.f, 0.f, 0.f };
-      return null_uv;
+      return shared_align ( sizeof ( shared_header_t ) ) + SHARED_QUEUE_SLOTS * slot_size;
     }
 
     /// <summary>
-    /// get font spacing
+    /// get frame slot of a mapped section
     /// </summary>
-    /// <returns>font spacing</returns>
-    uint32_t spacing ( ) const noexcept
+    /// <param name="view">start of mapped section</param>
+    /// <param name="layout">capacities of section</param>
+    /// <param name="slot">index of slot</param>
+    /// <returns>slot</returns>
+    inline shared_slot_t *shared_slot ( uint8_t *view, const shared_layout_t &layout, const uint32_t slot ) noexcept
     {
-      return this->m_spacing;
+      return reinterpret_cast< shared_slot_t * > ( view + shared_align ( sizeof ( shared_header_t ) ) + slot * layout.m_slot_size );
     }
 
     /// <summary>
-    /// get font width
+    /// get vertices of a frame slot
     /// </summary>
-    /// <returns>font width</returns>
-    uint32_t width ( ) const noexcept
+    /// <param name="slot">slot</param>
+    /// <returns>first vertex</returns>
+    inline daisy_vtx_t *shared_vertices ( shared_slot_t *slot ) noexcept
     {
-      return this->m_width;
+      return reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uint8_t * > ( slot ) + shared_align ( sizeof ( shared_slot_t ) ) );
     }
 
     /// <summary>
-    /// get font height
+    /// get draw calls of a frame slot
     /// </summary>
-    /// <returns>font height</returns>
-    uint32_t height ( ) const noexcept
+    /// <param name="layout">capacities of section</param>
+    /// <param name="slot">slot</param>
+    /// <returns>first draw call</returns>
+    inline shared_drawcall_t *shared_drawcalls ( const shared_layout_t &layout, shared_slot_t *slot ) noexcept
     {
-      return this->m_height;
+      return reinterpret_cast< shared_drawcall_t * > ( reinterpret_cast< uint8_t * > ( shared_vertices ( slot ) ) + shared_align ( layout.m_max_vertices * sizeof ( daisy_vtx_t ) ) );
     }
 
     /// <summary>
-    /// get font scale
+    /// get indices of a frame slot
     /// </summary>
-    /// <returns>font scale</returns>
-    float scale ( ) const noexcept
+    /// <param name="layout">capacities of section</param>
+    /// <param name="slot">slot</param>
+    /// <returns>first index</returns>
+    inline uint16_t *shared_indices ( const shared_layout_t &layout, shared_slot_t *slot ) noexcept
     {
-      return this->m_scale;
+      return reinterpret_cast< uint16_t * > ( reinterpret_cast< uint8_t * > ( shared_drawcalls ( layout, slot ) ) + shared_align ( layout.m_max_drawcalls * sizeof ( shared_drawcall_t ) ) );
     }
 
+    // layout of a drawlist snapshot (see c_drawlist::save_snapshot): the header followed by the arrays listed in snapshot_section_t, each one
+    // aligned like the sections of shared queues. arrays are stored exactly as the drawlist keeps them, so a loaded blob can be used in place
+    constexpr static inline uint32_t SNAPSHOT_MAGIC = 0x70737964; // "dysp"
+    constexpr static inline uint32_t SNAPSHOT_VERSION = 1;
+
+    enum snapshot_section_t : uint32_t
+    {
+      SNAPSHOT_VERTICES = 0,
+      SNAPSHOT_INDICES,
+      SNAPSHOT_KINDS,
+      SNAPSHOT_KEYS,
+      SNAPSHOT_HANDLES,
+      SNAPSHOT_RANGES,
+      SNAPSHOT_SCISSORS,
+      SNAPSHOT_SECTIONS
+    };
+
+    struct snapshot_header_t
+    {
+      uint32_t m_magic, m_version, m_vertex_size, m_size;
+      uint32_t m_vertices, m_indices, m_calls, m_scissors;
+      uint32_t m_offsets[ SNAPSHOT_SECTIONS ];
+    };
+
     /// <summary>
-    /// get texture handle
+    /// computes section offsets and total size of a snapshot from its counts
     /// </summary>
-    /// <returns>texture handle</returns>
-    IDirect3DTexture9 *texture_handle ( ) const noexcept
+    /// <param name="header">header with counts set, offsets and size get filled in</param>
+    inline void snapshot_layout ( snapshot_header_t &header ) noexcept
     {
-      return this->m_texture_handle;
+      const uint64_t sizes[ SNAPSHOT_SECTIONS ] = { uint64_t { header.m_vertices } * sizeof ( daisy_vtx_t ), uint64_t { header.m_indices } * sizeof ( uint16_t ),
+                                                   uint64_t { header.m_calls } * sizeof ( daisy_call_kind ),  uint64_t { header.m_calls } * sizeof ( uint32_t ),
+                                                   uint64_t { header.m_calls } * sizeof ( uint32_t ),         uint64_t { header.m_calls } * sizeof ( daisy_call_range_t ),
+                                                   uint64_t { header.m_scissors } * sizeof ( point_t ) * 2 };
+
+      uint64_t offset = shared_align ( sizeof ( snapshot_header_t ) );
+      for ( uint32_t i = 0; i < SNAPSHOT_SECTIONS; ++i )
+      {
+        header.m_offsets[ i ] = static_cast< uint32_t > ( offset );
+        offset += ( sizes[ i ] + SHARED_QUEUE_ALIGN - 1 ) & ~uint64_t { SHARED_QUEUE_ALIGN - 1 };
+      }
+
+      // blobs are addressed by 32 bit offsets
+      header.m_size = offset <= UINT32_MAX ? static_cast< uint32_t > ( offset ) : 0;
     }
-  };
+  } // namespace detail
 
-  class c_texatlas : public c_daisy_resettable_object
+  // linear allocator for transient data that only lives for a frame: allocations bump a pointer through one block that's taken from the
+  // upstream resource once, deallocations do nothing and reset() frees everything at once. whatever doesn't fit goes to the upstream resource,
+  // overflow() tells how much did, so the block can be sized to make steady state frames allocation free. not thread safe
+  class c_framearena : public stl::pmr::memory_resource
   {
   private:
-    stl::unordered_map< uint32_t, uv_t > m_coords;
-    point_t m_cursor, m_dimensions;
-    IDirect3DTexture9 *m_texture_handle;
-    float m_max_height;
+    stl::pmr::memory_resource *m_upstream;
+    uint8_t *m_block;
+    size_t m_capacity, m_used, m_overflow;
+
+  protected:
+    void *do_allocate ( size_t bytes, size_t alignment ) override
+    {
+      const auto address = reinterpret_cast< uintptr_t > ( this->m_block ) + this->m_used;
+      const size_t padding = ( alignment - address % alignment ) % alignment;
+
+      if ( this->m_block && this->m_used + padding + bytes <= this->m_capacity )
+      {
+        this->m_used += padding + bytes;
+        return reinterpret_cast< void * > ( address + padding );
+      }
+
+      this->m_overflow += bytes;
+      return this->m_upstream->allocate ( bytes, alignment );
+    }
+
+    void do_deallocate ( void *data, size_t bytes, size_t alignment ) override
+    {
+      // memory of the block is only given back by reset()
+      if ( data >= this->m_block && data < this->m_block + this->m_capacity )
+        return;
+
+      this->m_upstream->deallocate ( data, bytes, alignment );
+    }
+
+    bool do_is_equal ( const stl::pmr::memory_resource &other ) const noexcept override
+    {
+      return this == &other;
+    }
 
   public:
-    c_texatlas ( ) noexcept
-        : m_cursor ( { 0.f, 0.f } ), m_dimensions ( { 0.f, 0.f } ), m_texture_handle ( nullptr ), m_max_height ( 0.f )
+    c_framearena ( stl::pmr::memory_resource *upstream = stl::pmr::get_default_resource ( ) ) noexcept
+        : m_upstream ( upstream ), m_block ( nullptr ), m_capacity ( 0 ), m_used ( 0 ), m_overflow ( 0 )
     {
     }
 
-    // disable copying
-    c_texatlas ( const c_texatlas & ) = delete;
-    c_texatlas &operator= ( const c_texatlas & ) = delete;
+    // disallow copying
+    c_framearena ( const c_framearena & ) = delete;
+    c_framearena &operator= ( const c_framearena & ) = delete;
 
     /// <summary>
-    /// creates a texture atlas
+    /// takes block from upstream resource
     /// </summary>
-    /// <param name="dimensions">texture atlas dimensions</param>
+    /// <param name="capacity">size of block in bytes</param>
     /// <returns>true on success, false otherwise</returns>
-    [[nodiscard]] bool create ( const point_t &dimensions ) noexcept
+    [[nodiscard]] bool create ( const size_t capacity ) noexcept
     {
-      if ( !daisy_t::s_device )
-        return false;
+      this->release ( );
 
-      this->m_dimensions = dimensions;
-      this->m_cursor = point_t { 0.f, 0.f };
-      this->m_max_height = 0.f;
+      // upstream resources report failure by throwing, like in detail::make_buffer
+      try
+      {
+        this->m_block = static_cast< uint8_t * > ( this->m_upstream->allocate ( capacity, alignof ( stl::max_align_t ) ) );
+      }
+      catch ( ... )
+      {
+        this->m_block = nullptr;
+      }
 
-      if ( daisy_t::s_device->CreateTexture ( static_cast< UINT > ( dimensions.x ), static_cast< UINT > ( dimensions.y ), 1, D3DUSAGE_DYNAMIC, D3DFMT_A8R8G8B8, D3DPOOL_DEFAULT, &this->m_texture_handle, nullptr ) != D3D_OK )
-        return false;
+      this->m_capacity = this->m_block ? capacity : 0;
 
-      return true;
+      return this->m_block != nullptr;
     }
 
     /// <summary>
-    /// called on device reset (pre/post)
+    /// gives block back to upstream resource, nothing allocated from the block may be used afterwards
     /// </summary>
-    /// <param name="pre_reset">if this is called before device is reset</param>
-    /// <returns>true on success, false otherwise</returns>
-    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    void release ( ) noexcept
     {
-      if ( !pre_reset )
-        return this->create ( this->m_dimensions );
-      else if ( this->m_texture_handle )
-        this->m_texture_handle->Release ( );
+      if ( this->m_block )
+        this->m_upstream->deallocate ( this->m_block, this->m_capacity, alignof ( stl::max_align_t ) );
 
-      return true;
+      this->m_block = nullptr;
+      this->m_capacity = this->m_used = this->m_overflow = 0;
     }
 
     /// <summary>
-    /// appends a texture to the texture atlas
+    /// frees everything allocated from the block at once, call it at the start of each frame. nothing allocated from the block may be used afterwards
     /// </summary>
-    /// <param name="uuid">uuid of texture (can be whatever you want as long as it's unique per texture)</param>
-    /// <param name="dimensions">dimensions of texture in pixels</param>
-    /// <param name="tex_data">A8R8G8B8 texture data</param>
-    /// <param name="tex_size">size of texture data in bytes</param>
-    /// <returns>true on success, false otherwise</returns>
-    bool append ( const uint32_t uuid, const point_t &dimensions, uint8_t *tex_data, uint32_t tex_size ) noexcept
+    void reset ( ) noexcept
     {
-      if ( !tex_data || !tex_size )
-        return false;
+      this->m_used = this->m_overflow = 0;
+    }
 
-      // go down if not enough space left
-      if ( this->m_cursor.x + dimensions.x > this->m_dimensions.x )
+    /// <summary>
+    /// get bytes allocated from block since the last reset
+    /// </summary>
+    /// <returns>used bytes</returns>
+    size_t used ( ) const noexcept
+    {
+      return this->m_used;
+    }
+
+    /// <summary>
+    /// get bytes that didn't fit into the block since the last reset, and were allocated from upstream instead
+    /// </summary>
+    /// <returns>overflowed bytes</returns>
+    size_t overflow ( ) const noexcept
+    {
+      return this->m_overflow;
+    }
+  };
+
+  // cache of flattened curves, keyed by control points and tolerance
+  class c_curvecache
+  {
+  private:
+    struct entry_t
+    {
+      // lets the map hand its resource down to the points
+      using allocator_type = stl::pmr::polymorphic_allocator< point_t >;
+
+      stl::array< point_t, 4 > m_controls;
+      float m_tolerance;
+      uint32_t m_order;
+      stl::pmr::vector< point_t > m_points;
+
+      entry_t ( const allocator_type &allocator ) noexcept : m_controls { }, m_tolerance ( 0.f ), m_order ( 0 ), m_points ( allocator ) { }
+      entry_t ( entry_t &&other, const allocator_type &allocator ) noexcept
+          : m_controls ( other.m_controls ), m_tolerance ( other.m_tolerance ), m_order ( other.m_order ), m_points ( stl::move ( other.m_points ), allocator )
       {
-        this->m_cursor.y += this->m_max_height;
-        this->m_cursor.x = this->m_max_height = 0.f;
       }
+    };
 
-      // not enough space left
-      if ( this->m_cursor.y + dimensions.y > this->m_dimensions.y )
-        return false;
+    stl::pmr::unordered_map< uint64_t, entry_t > m_entries;
+    uint32_t m_max_entries;
 
-      // ensure we set max height
-      if ( this->m_max_height < dimensions.y )
-        this->m_max_height = dimensions.y;
+  private:
+    /// <summary>
+    /// finds cache entry for given control points, or prepares an empty one if it doesn't exist (or if it's stale)
+    /// </summary>
+    /// <param name="controls">curve control points (unused ones must be zeroed)</param>
+    /// <param name="order">number of control points used by the curve</param>
+    /// <param name="tolerance">flatness tolerance</param>
+    /// <param name="hit">set to true if the entry already holds the flattened curve</param>
+    /// <returns>cache entry</returns>
+    entry_t &lookup ( const stl::array< point_t, 4 > &controls, const uint32_t order, const float tolerance, bool &hit )
+    {
+      uint64_t key = detail::hash_bytes ( controls.data ( ), sizeof ( point_t ) * controls.size ( ) );
+      key = detail::hash_bytes ( &tolerance, sizeof ( float ), key );
+      key = detail::hash_bytes ( &order, sizeof ( uint32_t ), key );
 
-      // lock tex
-      D3DLOCKED_RECT tex_locked_rect;
+      auto it = this->m_entries.find ( key );
+      if ( it != this->m_entries.end ( ) )
+      {
+        // guard against hash collisions
+        hit = it->second.m_order == order && it->second.m_tolerance == tolerance && memcmp ( it->second.m_controls.data ( ), controls.data ( ), sizeof ( point_t ) * controls.size ( ) ) == 0;
 
-      if ( this->m_texture_handle->LockRect ( 0, &tex_locked_rect, NULL, 0 ) != D3D_OK )
-        return false;
+        if ( !hit )
+          it->second.m_points.clear ( );
 
-      // copy tex data over
-      for ( int y = 0; y < dimensions.y; ++y )
-      {
-        for ( int x = 0; x < dimensions.x; ++x )
-        {
-          const uint8_t *source_pixel = tex_data + static_cast< uint32_t > ( dimensions.x ) * 4 * y + x * 4;
+        it->second.m_controls = controls;
+        it->second.m_tolerance = tolerance;
+        it->second.m_order = order;
 
-          // ensure the texture size matches what we expect
-          if ( static_cast< uint32_t > ( dimensions.x ) * 4 * y + x * 4 > tex_size )
-            return false;
+        return it->second;
+      }
 
-          uint8_t *destination_pixel = static_cast< uint8_t * > ( tex_locked_rect.pBits ) + tex_locked_rect.Pitch * ( static_cast< uint32_t > ( this->m_cursor.y ) + y ) + ( static_cast< uint32_t > ( this->m_cursor.x ) + x ) * 4;
+      // don't let animated curves grow the cache forever
+      if ( this->m_entries.size ( ) >= this->m_max_entries )
+        this->m_entries.clear ( );
 
-          destination_pixel[ 0 ] = source_pixel[ 2 ];
-          destination_pixel[ 1 ] = source_pixel[ 1 ];
-          destination_pixel[ 2 ] = source_pixel[ 0 ];
-          destination_pixel[ 3 ] = source_pixel[ 3 ];
-        }
-      }
+      hit = false;
 
-      this->m_texture_handle->UnlockRect ( 0 );
+      auto &entry = this->m_entries[ key ];
+      entry.m_controls = controls;
+      entry.m_tolerance = tolerance;
+      entry.m_order = order;
 
-      // set uv mins/maxs
-      auto start_uv = point_t { this->m_cursor.x / this->m_dimensions.x, this->m_cursor.y / this->m_dimensions.y };
-      auto end_uv = point_t { start_uv.x + dimensions.x / this->m_dimensions.x, start_uv.y + dimensions.y / this->m_dimensions.y };
-      this->m_coords[ uuid ] = uv_t { start_uv.x, start_uv.y, end_uv.x, end_uv.y };
+      return entry;
+    }
 
-      // move cursor over
-      this->m_cursor.x += dimensions.x;
+  public:
+    c_curvecache ( stl::pmr::memory_resource *resource = stl::pmr::get_default_resource ( ), const uint32_t max_entries = 4096 ) noexcept
+        : m_entries ( resource ), m_max_entries ( max_entries )
+    {
+    }
 
-      return true;
+    // disallow copying
+    c_curvecache ( const c_curvecache & ) = delete;
+    c_curvecache &operator= ( const c_curvecache & ) = delete;
+
+    /// <summary>
+    /// returns flattened points of a quadratic bezier curve, flattening it only if it isn't cached already
+    /// </summary>
+    /// <param name="p1">start point</param>
+    /// <param name="p2">control point</param>
+    /// <param name="p3">end point</param>
+    /// <param name="tolerance">max distance in pixels between the curve and its flattened version</param>
+    /// <returns>flattened points, including start and end points</returns>
+    const stl::pmr::vector< point_t > &quad_bezier ( const point_t &p1, const point_t &p2, const point_t &p3, const float tolerance )
+    {
+      bool hit;
+      auto &entry = this->lookup ( { p1, p2, p3, point_t { 0.f, 0.f } }, 3, tolerance, hit );
+
+      if ( !hit )
+      {
+        entry.m_points.push_back ( p1 );
+        detail::flatten_quad_bezier ( p1, p2, p3, tolerance * tolerance, 0, entry.m_points );
+      }
+
+      return entry.m_points;
     }
 
     /// <summary>
-    /// get UV coordinates of texture
+    /// returns flattened points of a cubic bezier curve, flattening it only if it isn't cached already
     /// </summary>
-    /// <param name="glyph">character to get texture UV coordinates for</param>
-    /// <returns>UV coordinates of texture</returns>
-    const uv_t &coords ( uint32_t uuid ) const noexcept
+    /// <param name="p1">start point</param>
+    /// <param name="p2">first control point</param>
+    /// <param name="p3">second control point</param>
+    /// <param name="p4">end point</param>
+    /// <param name="tolerance">max distance in pixels between the curve and its flattened version</param>
+    /// <returns>flattened points, including start and end points</returns>
+    const stl::pmr::vector< point_t > &cubic_bezier ( const point_t &p1, const point_t &p2, const point_t &p3, const point_t &p4, const float tolerance )
     {
-      if ( this->m_coords.find ( uuid ) != this->m_coords.end ( ) )
-        return this->m_coords.at ( uuid );
+      bool hit;
+      auto &entry = this->lookup ( { p1, p2, p3, p4 }, 4, tolerance, hit );
 
-      static uv_t null_uv { 0.f, 0.f, 0.f, 0.f };
-      return null_uv;
+      if ( !hit )
+      {
+        entry.m_points.push_back ( p1 );
+        detail::flatten_cubic_bezier ( p1, p2, p3, p4, tolerance * tolerance, 0, entry.m_points );
+      }
+
+      return entry.m_points;
     }
 
     /// <summary>
-    /// get texture handle
+    /// wipes all cached curves
     /// </summary>
-    /// <returns>texture handle</returns>
-    IDirect3DTexture9 *texture_handle ( ) const noexcept
+    void clear ( ) noexcept
     {
-      return this->m_texture_handle;
+      this->m_entries.clear ( );
     }
   };
 
-  class c_renderqueue : public c_daisy_resettable_object
+  // cache of polygon triangulations, keyed by point set
+  class c_polygoncache
   {
   private:
-    IDirect3DVertexBuffer9 *m_vertex_buffer;
-    IDirect3DIndexBuffer9 *m_index_buffer;
+    struct entry_t
+    {
+      // lets the map hand its resource down to the vectors
+      using allocator_type = stl::pmr::polymorphic_allocator< point_t >;
 
-    renderbuffer_t m_vtxs, m_idxs;
+      stl::pmr::vector< point_t > m_points;
+      stl::pmr::vector< uint16_t > m_indices;
 
-    stl::vector< daisy_drawcall_t > m_drawcalls;
+      entry_t ( const allocator_type &allocator ) noexcept : m_points ( allocator ), m_indices ( allocator ) { }
+      entry_t ( entry_t &&other, const allocator_type &allocator ) noexcept
+          : m_points ( stl::move ( other.m_points ), allocator ), m_indices ( stl::move ( other.m_indices ), allocator )
+      {
+      }
+    };
 
-    // update d3d9 sided vtx/idx buffers
-    bool m_update;
+    stl::pmr::unordered_map< uint64_t, entry_t > m_entries;
+    uint32_t m_max_entries;
 
-    // reallocate d3d9 buffers
-    bool m_realloc_vtx, m_realloc_idx;
+  public:
+    c_polygoncache ( stl::pmr::memory_resource *resource = stl::pmr::get_default_resource ( ), const uint32_t max_entries = 1024 ) noexcept
+        : m_entries ( resource ), m_max_entries ( max_entries )
+    {
+    }
+
+    // disallow copying
+    c_polygoncache ( const c_polygoncache & ) = delete;
+    c_polygoncache &operator= ( const c_polygoncache & ) = delete;
 
-  private:
     /// <summary>
-    /// ensures buffers have enough capacity for the draw call
+    /// returns triangle indices of a polygon, triangulating it only if it isn't cached already
     /// </summary>
-    /// <param name="vertices_to_add">vertices to be added to buffer</param>
-    /// <param name="indices_to_add">indices to be added to buffer</param>
-    void ensure_buffers_capacity ( const uint32_t vertices_to_add, const uint32_t indices_to_add ) noexcept
+    /// <param name="points">points of polygon</param>
+    /// <param name="count">number of points (at most 65535)</param>
+    /// <returns>triangle indices, relative to the first point of the polygon</returns>
+    const stl::pmr::vector< uint16_t > &triangulate ( const point_t *points, const uint32_t count )
     {
-      // check vtxbuf
-      if ( this->m_vtxs.m_size + vertices_to_add >= this->m_vtxs.m_capacity )
+      const uint64_t key = detail::hash_bytes ( points, sizeof ( point_t ) * count );
+
+      auto it = this->m_entries.find ( key );
+      if ( it != this->m_entries.end ( ) )
       {
-        // set new capacity
-        while ( this->m_vtxs.m_size + vertices_to_add >= this->m_vtxs.m_capacity )
-          this->m_vtxs.m_capacity = this->m_vtxs.m_capacity * 2;
+        // guard against hash collisions
+        if ( it->second.m_points.size ( ) == count && memcmp ( it->second.m_points.data ( ), points, sizeof ( point_t ) * count ) == 0 )
+          return it->second.m_indices;
 
-        // create new vertex buf
-        auto new_vtx = stl::make_unique< uint8_t[] > ( this->m_vtxs.m_capacity * sizeof ( daisy_vtx_t ) );
+        this->m_entries.erase ( it );
+      }
 
-        if ( new_vtx )
-        {
-          // copy old data over
-          memcpy ( new_vtx.get ( ), this->m_vtxs.m_data.get ( ), this->m_vtxs.m_size * sizeof ( daisy_vtx_t ) );
+      // don't let animated shapes grow the cache forever
+      if ( this->m_entries.size ( ) >= this->m_max_entries )
+        this->m_entries.clear ( );
 
-          // d3d9 buf needs to be reallocated on new flush (we could do this here, however this ensures we're in the d3d9 rendering thread)
-          this->m_realloc_vtx = true;
+      auto &entry = this->m_entries[ key ];
+      entry.m_points.assign ( points, points + count );
+      detail::triangulate_polygon ( points, count, entry.m_indices );
 
-          // replace old data
-          this->m_vtxs.m_data.swap ( new_vtx );
-        }
-      }
+      return entry.m_indices;
+    }
 
-      // check idxbuf
-      if ( this->m_idxs.m_size + indices_to_add >= this->m_idxs.m_capacity )
-      {
-        // set capacity
-        while ( this->m_idxs.m_size + indices_to_add >= this->m_idxs.m_capacity )
-          this->m_idxs.m_capacity = this->m_idxs.m_capacity * 2;
+    /// <summary>
+    /// wipes all cached triangulations
+    /// </summary>
+    void clear ( ) noexcept
+    {
+      this->m_entries.clear ( );
+    }
+  };
 
-        // create new index buf
-        auto new_idx = stl::make_unique< uint8_t[] > ( this->m_idxs.m_capacity * sizeof ( uint16_t ) );
+  // retained vector path; its flattening and fill triangulation are cached and only redone when the path changes
+  // or when it gets drawn at a scale that needs a noticeably different level of detail
+  class c_path
+  {
+  private:
+    struct cmd_t
+    {
+      daisy_path_cmd m_kind;
 
-        if ( new_idx )
-        {
-          // copy old data over
-          memcpy ( new_idx.get ( ), this->m_idxs.m_data.get ( ), this->m_idxs.m_size * sizeof ( uint16_t ) );
+      // PATH_ARC stores center, { radius, 0 }, { start angle, end angle }
+      point_t m_points[ 3 ];
+    };
 
-          // d3d9 buf needs to be reallocated on new flush (we could do this here, however this ensures we're in the d3d9 rendering thread)
-          this->m_realloc_idx = true;
+    struct subpath_t
+    {
+      uint32_t m_first, m_count;
+      bool m_closed;
+    };
 
-          // replace old data
-          this->m_idxs.m_data.swap ( new_idx );
-        }
-      }
-    }
+    stl::pmr::vector< cmd_t > m_cmds;
 
+    // cached tessellation
+    stl::pmr::vector< point_t > m_points;
+    stl::pmr::vector< subpath_t > m_subpaths;
+    stl::pmr::vector< uint16_t > m_fill_indices;
+    float m_tolerance;
+    bool m_flattened, m_triangulated;
+
+  private:
     /// <summary>
-    /// checks if call can be batched
+    /// records a command and invalidates cached tessellation
     /// </summary>
-    /// <param name="texture_handle">texture handle</param>
-    /// <returns>0 if we can't batch this call, index offset on success</returns>
-    uint32_t begin_batch ( IDirect3DTexture9 *texture_handle = nullptr ) const noexcept
+    /// <param name="kind">command kind</param>
+    /// <param name="p1">first point</param>
+    /// <param name="p2">second point</param>
+    /// <param name="p3">third point</param>
+    /// <returns>this path</returns>
+    c_path &record ( const daisy_path_cmd kind, const point_t &p1 = { 0.f, 0.f }, const point_t &p2 = { 0.f, 0.f }, const point_t &p3 = { 0.f, 0.f } )
     {
-      uint32_t additional = 0;
+      this->m_cmds.push_back ( cmd_t { kind, { p1, p2, p3 } } );
+      this->m_flattened = this->m_triangulated = false;
 
-      // attempt to batch drawcall
-      if ( !this->m_drawcalls.empty ( ) )
-      {
-        auto &last_call = this->m_drawcalls.back ( );
-        if ( last_call.m_kind == daisy_call_kind::CALL_TRI && last_call.m_tri.m_texture_handle == texture_handle )
-        {
-          // we can batch this call
-          additional = last_call.m_tri.m_vertices;
-        }
-      }
-
-      return additional;
+      return *this;
     }
 
     /// <summary>
-    /// appends call to batch if possible
+    /// flattens all commands into subpaths
     /// </summary>
-    /// <param name="additional_indices">return value of begin_batch() call</param>
-    /// <param name="vertices">vertices in call</param>
-    /// <param name="indices">indices in call</param>
-    /// <param name="primitives">primitives in call</param>
-    /// <param name="texture_handle">texutre handle</param>
-    void end_batch ( uint32_t additional_indices, uint32_t vertices, uint32_t indices, uint32_t primitives, IDirect3DTexture9 *texture_handle = nullptr )
+    /// <param name="tolerance">max distance in path units between the path and its flattened version</param>
+    void flatten ( const float tolerance )
     {
-      // call can't be batched
-      if ( !additional_indices )
-      {
-        daisy_drawcall_t d { };
-        d.m_kind = daisy_call_kind::CALL_TRI;
-        d.m_tri.m_indices = indices;
-        d.m_tri.m_vertices = vertices;
-        d.m_tri.m_texture_handle = texture_handle;
-        d.m_tri.m_primitives = primitives;
+      this->m_points.clear ( );
+      this->m_subpaths.clear ( );
+      this->m_fill_indices.clear ( );
 
-        this->m_drawcalls.push_back ( stl::move ( d ) );
-      }
-      // call is batched
-      else
+      point_t start { 0.f, 0.f };
+      bool open = false;
+
+      // starts a new subpath at given point if we don't have one going
+      const auto ensure_subpath = [ & ] ( const point_t &at ) {
+        if ( open )
+          return;
+
+        this->m_subpaths.push_back ( subpath_t { static_cast< uint32_t > ( this->m_points.size ( ) ), 0, false } );
+        this->m_points.push_back ( at );
+
+        start = at;
+        open = true;
+      };
+
+      for ( const auto &cmd : this->m_cmds )
       {
-        auto &last_call = this->m_drawcalls.back ( );
+        const point_t current = this->m_points.empty ( ) ? point_t { 0.f, 0.f } : ( open ? this->m_points.back ( ) : start );
+
+        switch ( cmd.m_kind )
+        {
+        case daisy_path_cmd::PATH_MOVE:
+          open = false;
+          ensure_subpath ( cmd.m_points[ 0 ] );
+          break;
+        case daisy_path_cmd::PATH_LINE:
+          ensure_subpath ( current );
+          this->m_points.push_back ( cmd.m_points[ 0 ] );
+          break;
+        case daisy_path_cmd::PATH_QUAD:
+          ensure_subpath ( current );
+          detail::flatten_quad_bezier ( current, cmd.m_points[ 0 ], cmd.m_points[ 1 ], tolerance * tolerance, 0, this->m_points );
+          break;
+        case daisy_path_cmd::PATH_CUBIC:
+          ensure_subpath ( current );
+          detail::flatten_cubic_bezier ( current, cmd.m_points[ 0 ], cmd.m_points[ 1 ], cmd.m_points[ 2 ], tolerance * tolerance, 0, this->m_points );
+          break;
+        case daisy_path_cmd::PATH_ARC: {
+          const auto &center = cmd.m_points[ 0 ];
+          const float radius = cmd.m_points[ 1 ].x;
+          const float from = cmd.m_points[ 2 ].x, to = cmd.m_points[ 2 ].y;
+
+          // angle step that keeps the chord within tolerance of the arc
+          const float ratio = radius > tolerance ? 1.f - tolerance / radius : 0.f;
+          const float step = 2.f * stl::acosf ( ratio );
+          const float sweep = stl::fabsf ( to - from );
+
+          int segments = static_cast< int > ( stl::ceilf ( sweep / ( step > FLT_EPSILON ? step : FLT_EPSILON ) ) );
+          if ( segments < 1 )
+            segments = 1;
+          else if ( segments > ( 1 << detail::BEZIER_MAX_DEPTH ) )
+            segments = 1 << detail::BEZIER_MAX_DEPTH;
+
+          // same orientation as push_filled_arc
+          const point_t arc_start { center.x + radius * stl::cosf ( from ), center.y - radius * stl::sinf ( from ) };
+
+          // arcs connect to the current point with a straight line
+          ensure_subpath ( arc_start );
+          if ( this->m_points.back ( ).x != arc_start.x || this->m_points.back ( ).y != arc_start.y )
+            this->m_points.push_back ( arc_start );
+
+          for ( int i = 1; i <= segments; ++i )
+          {
+            const float theta = from + ( to - from ) * static_cast< float > ( i ) / static_cast< float > ( segments );
+            this->m_points.push_back ( point_t { center.x + radius * stl::cosf ( theta ), center.y - radius * stl::sinf ( theta ) } );
+          }
+        }
+        break;
+        case daisy_path_cmd::PATH_CLOSE:
+          if ( open )
+            this->m_subpaths.back ( ).m_closed = true;
+
+          open = false;
+          break;
+        }
 
-        last_call.m_tri.m_vertices += vertices;
-        last_call.m_tri.m_indices += indices;
-        last_call.m_tri.m_primitives += primitives;
+        if ( !this->m_subpaths.empty ( ) )
+          this->m_subpaths.back ( ).m_count = static_cast< uint32_t > ( this->m_points.size ( ) ) - this->m_subpaths.back ( ).m_first;
       }
 
-      // need to update gpu-side buffers
-      this->m_update = true;
+      this->m_tolerance = tolerance;
+      this->m_flattened = true;
+      this->m_triangulated = false;
     }
 
   public:
-    c_renderqueue ( ) noexcept
-        : m_vertex_buffer ( nullptr ), m_index_buffer ( nullptr ), m_update ( true ), m_realloc_vtx ( false ), m_realloc_idx ( false )
+    c_path ( stl::pmr::memory_resource *resource = stl::pmr::get_default_resource ( ) ) noexcept
+        : m_cmds ( resource ), m_points ( resource ), m_subpaths ( resource ), m_fill_indices ( resource ), m_tolerance ( 0.f ), m_flattened ( false ), m_triangulated ( false )
     {
     }
 
-    // disallow copying
-    c_renderqueue ( const c_renderqueue & ) = delete;
-    c_renderqueue &operator= ( const c_renderqueue & ) = delete;
-
     /// <summary>
-    /// initializes current queue by initializing vertex and index buffers
+    /// starts a new subpath
     /// </summary>
-    /// <param name="max_verts">max capacity of vertex buffer</param>
-    /// <param name="max_indices">max capacity of index buffer</param>
-    /// <returns>true on success, false otherwise</returns>
-    [[nodiscard]] bool create ( const uint32_t max_verts = 32767, const uint32_t max_indices = 65535 ) noexcept
+    /// <param name="point">start point of subpath</param>
+    /// <returns>this path</returns>
+    c_path &move_to ( const point_t &point )
     {
-      if ( !daisy_t::s_device )
-        return false;
-
-      // create d3d9 buffers
-      if ( !this->m_vertex_buffer )
-        if ( daisy_t::s_device->CreateVertexBuffer ( sizeof ( daisy_vtx_t ) * max_verts, D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, ( D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 ), D3DPOOL_DEFAULT, &this->m_vertex_buffer, nullptr ) < 0 )
-          return false;
+      return this->record ( daisy_path_cmd::PATH_MOVE, point );
+    }
 
-      if ( !this->m_index_buffer )
-        if ( daisy_t::s_device->CreateIndexBuffer ( sizeof ( uint16_t ) * max_indices, D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &this->m_index_buffer, nullptr ) < 0 )
-          return false;
+    /// <summary>
+    /// adds a straight line from the current point
+    /// </summary>
+    /// <param name="point">end point of line</param>
+    /// <returns>this path</returns>
+    c_path &line_to ( const point_t &point )
+    {
+      return this->record ( daisy_path_cmd::PATH_LINE, point );
+    }
 
-      // create local buffers
-      if ( !this->m_vtxs.m_data.get ( ) )
-      {
-        this->m_vtxs.m_data = stl::make_unique< uint8_t[] > ( sizeof ( daisy_vtx_t ) * max_verts );
-        this->m_vtxs.m_capacity = max_verts;
-        this->m_vtxs.m_size = 0;
-      }
+    /// <summary>
+    /// adds a quadratic bezier curve from the current point
+    /// </summary>
+    /// <param name="control">control point of curve</param>
+    /// <param name="point">end point of curve</param>
+    /// <returns>this path</returns>
+    c_path &quad_to ( const point_t &control, const point_t &point )
+    {
+      return this->record ( daisy_path_cmd::PATH_QUAD, control, point );
+    }
 
-      if ( !this->m_idxs.m_data )
-      {
-        this->m_idxs.m_data = stl::make_unique< uint8_t[] > ( sizeof ( uint16_t ) * max_indices );
-        this->m_idxs.m_capacity = max_indices;
-        this->m_idxs.m_size = 0;
-      }
+    /// <summary>
+    /// adds a cubic bezier curve from the current point
+    /// </summary>
+    /// <param name="control1">first control point of curve</param>
+    /// <param name="control2">second control point of curve</param>
+    /// <param name="point">end point of curve</param>
+    /// <returns>this path</returns>
+    c_path &cubic_to ( const point_t &control1, const point_t &control2, const point_t &point )
+    {
+      return this->record ( daisy_path_cmd::PATH_CUBIC, control1, control2, point );
+    }
 
-      if ( !this->m_vtxs.m_data || !this->m_idxs.m_data )
-        return false;
+    /// <summary>
+    /// adds a circular arc, connected to the current point with a straight line
+    /// </summary>
+    /// <param name="center">center of arc</param>
+    /// <param name="radius">radius of arc</param>
+    /// <param name="start_angle">start angle in radians</param>
+    /// <param name="end_angle">end angle in radians, the arc goes counter-clockwise on screen if this is bigger than start_angle</param>
+    /// <returns>this path</returns>
+    c_path &arc_to ( const point_t &center, const float radius, const float start_angle, const float end_angle )
+    {
+      return this->record ( daisy_path_cmd::PATH_ARC, center, { radius, 0.f }, { start_angle, end_angle } );
+    }
 
-      return true;
+    /// <summary>
+    /// closes the current subpath, the next command starts a new one at the same start point
+    /// </summary>
+    /// <returns>this path</returns>
+    c_path &close ( )
+    {
+      return this->record ( daisy_path_cmd::PATH_CLOSE );
     }
 
     /// <summary>
-    /// wipes data from local buffers
+    /// wipes all commands and cached tessellation
     /// </summary>
     void clear ( ) noexcept
     {
-      this->m_vtxs.m_size = 0;
-      this->m_idxs.m_size = 0;
-
-      if ( !this->m_drawcalls.empty ( ) )
-        this->m_drawcalls.clear ( );
+      this->m_cmds.clear ( );
+      this->m_points.clear ( );
+      this->m_subpaths.clear ( );
+      this->m_fill_indices.clear ( );
+      this->m_flattened = this->m_triangulated = false;
     }
 
     /// <summary>
-    /// called on device reset (pre/post)
+    /// ensures cached tessellation is good enough for given tolerance, re-tessellates only if needed
     /// </summary>
-    /// <param name="pre_reset">if this is called before device is reset</param>
-    /// <returns>true on success, false otherwise</returns>
-    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    /// <param name="tolerance">max distance in path units between the path and its flattened version</param>
+    /// <param name="fill">if fill triangulation is also needed</param>
+    /// <returns>true if the tessellation fits in 16 bit indices, false otherwise</returns>
+    bool tessellate ( const float tolerance, const bool fill )
     {
-      if ( !pre_reset )
-        return this->create ( this->m_vtxs.m_capacity, this->m_idxs.m_capacity );
-      else
+      // allow some slack so zooming around doesn't re-tessellate every frame
+      if ( !this->m_flattened || tolerance < this->m_tolerance * 0.5f || tolerance > this->m_tolerance * 2.f )
+        this->flatten ( tolerance );
+
+      if ( this->m_points.size ( ) > 0xffff )
+        return false;
+
+      if ( fill && !this->m_triangulated )
       {
-        if ( this->m_vertex_buffer )
-        {
-          this->m_vertex_buffer->Release ( );
-          this->m_vertex_buffer = nullptr;
-        }
+        this->m_fill_indices.clear ( );
 
-        if ( this->m_index_buffer )
+        // subpaths are filled independently, holes aren't cut out
+        for ( const auto &subpath : this->m_subpaths )
         {
-          this->m_index_buffer->Release ( );
-          this->m_index_buffer = nullptr;
+          const auto first_index = this->m_fill_indices.size ( );
+
+          detail::triangulate_polygon ( this->m_points.data ( ) + subpath.m_first, subpath.m_count, this->m_fill_indices );
+
+          for ( auto i = first_index; i < this->m_fill_indices.size ( ); ++i )
+            this->m_fill_indices[ i ] = static_cast< uint16_t > ( this->m_fill_indices[ i ] + subpath.m_first );
         }
+
+        this->m_triangulated = true;
       }
 
       return true;
     }
 
+    // getters
+
     /// <summary>
-    /// copies data from local buffer to d3d9 buffers
+    /// get flattened points of all subpaths
     /// </summary>
-    void update ( ) noexcept
+    /// <returns>flattened points</returns>
+    const stl::pmr::vector< point_t > &points ( ) const noexcept
     {
-      if ( !daisy_t::s_device )
-        return;
+      return this->m_points;
+    }
 
-      // checking realloc
-      if ( this->m_realloc_vtx )
-      {
-        this->m_vertex_buffer->Release ( );
+    /// <summary>
+    /// get fill triangle indices
+    /// </summary>
+    /// <returns>triangle indices, relative to the first flattened point</returns>
+    const stl::pmr::vector< uint16_t > &fill_indices ( ) const noexcept
+    {
+      return this->m_fill_indices;
+    }
 
-        if ( daisy_t::s_device->CreateVertexBuffer ( static_cast< UINT > ( this->m_vtxs.m_capacity * sizeof ( daisy_vtx_t ) ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, ( D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 ), D3DPOOL_DEFAULT, &this->m_vertex_buffer, nullptr ) < 0 )
-          return;
+    /// <summary>
+    /// get number of subpaths
+    /// </summary>
+    /// <returns>number of subpaths</returns>
+    uint32_t subpath_count ( ) const noexcept
+    {
+      return static_cast< uint32_t > ( this->m_subpaths.size ( ) );
+    }
 
-        this->m_realloc_vtx = false;
-      }
+    /// <summary>
+    /// get flattened subpath
+    /// </summary>
+    /// <param name="index">index of subpath</param>
+    /// <param name="first">index of first point of subpath</param>
+    /// <param name="count">number of points in subpath</param>
+    /// <param name="closed">if subpath is closed</param>
+    void subpath ( const uint32_t index, uint32_t &first, uint32_t &count, bool &closed ) const noexcept
+    {
+      first = this->m_subpaths[ index ].m_first;
+      count = this->m_subpaths[ index ].m_count;
+      closed = this->m_subpaths[ index ].m_closed;
+    }
+  };
 
-      if ( this->m_realloc_idx )
-      {
-        this->m_index_buffer->Release ( );
+  // opaque texture handle of draw calls. the d3d9 layer stores IDirect3DTexture9 pointers in it, other backends whatever identifies their textures
+  using daisy_texture_t = void *;
 
-        if ( daisy_t::s_device->CreateIndexBuffer ( static_cast< UINT > ( this->m_idxs.m_capacity * sizeof ( uint16_t ) ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &this->m_index_buffer, nullptr ) < 0 )
-          return;
+  // draw calls of a c_drawlist, stored as parallel arrays: kinds, sort keys, handles (textures of CALL_TRI, shaders of shader calls) and ranges.
+  // consumers only touch the streams they need, and reordering calls moves small elements instead of whole calls
+  class c_drawcalls
+  {
+  private:
+    stl::pmr::vector< daisy_call_kind > m_kinds;
+    stl::pmr::vector< uint32_t > m_keys;
+    stl::pmr::vector< void * > m_handles;
+    stl::pmr::vector< daisy_call_range_t > m_ranges;
 
-        this->m_realloc_idx = false;
-      }
+    // rectangles of scissor calls, as position and size pairs
+    stl::pmr::vector< point_t > m_scissors;
 
-      daisy_vtx_t *vert;
-      uint16_t *indx;
+    // permutation built by sort()
+    stl::pmr::vector< uint32_t > m_order;
 
-      // lock buffers
-      if ( this->m_vertex_buffer->Lock ( 0, static_cast< UINT > ( this->m_vtxs.m_size * sizeof ( daisy_vtx_t ) ), ( void ** ) &vert, D3DLOCK_DISCARD ) < 0 )
-        return;
+    /// <summary>
+    /// appends a call to all streams. throws if they can't grow, they are left unchanged then
+    /// </summary>
+    /// <param name="kind">call kind</param>
+    /// <param name="key">sort key</param>
+    /// <param name="handle">texture or shader handle</param>
+    /// <param name="range">range or payload</param>
+    void push ( const daisy_call_kind kind, const uint32_t key, void *handle, const daisy_call_range_t &range )
+    {
+      const auto count = this->m_ranges.size ( );
 
-      if ( this->m_index_buffer->Lock ( 0, static_cast< UINT > ( this->m_idxs.m_size * sizeof ( uint16_t ) ), ( void ** ) &indx, D3DLOCK_DISCARD ) < 0 )
+      try
       {
-        this->m_vertex_buffer->Unlock ( );
-        return;
+        this->m_kinds.push_back ( kind );
+        this->m_keys.push_back ( key );
+        this->m_handles.push_back ( handle );
+        this->m_ranges.push_back ( range );
+      }
+      catch ( ... )
+      {
+        // streams grow one after another, drop whatever made it in so their lengths stay equal
+        this->m_kinds.resize ( count );
+        this->m_keys.resize ( count );
+        this->m_handles.resize ( count );
+        this->m_ranges.resize ( count );
+        throw;
       }
+    }
+
+  public:
+    c_drawcalls ( stl::pmr::memory_resource *resource = stl::pmr::get_default_resource ( ) ) noexcept
+        : m_kinds ( resource ), m_keys ( resource ), m_handles ( resource ), m_ranges ( resource ), m_scissors ( resource ), m_order ( resource )
+    {
+    }
+
+    /// <summary>
+    /// removes all calls
+    /// </summary>
+    void clear ( ) noexcept
+    {
+      this->m_kinds.clear ( );
+      this->m_keys.clear ( );
+      this->m_handles.clear ( );
+      this->m_ranges.clear ( );
+      this->m_scissors.clear ( );
+    }
+
+    /// <summary>
+    /// appends a CALL_TRI call. throws if the streams can't grow, they are left unchanged then
+    /// </summary>
+    /// <param name="key">sort key</param>
+    /// <param name="texture_handle">texture handle</param>
+    /// <param name="range">vertices and indices of the call</param>
+    void push_tri ( const uint32_t key, daisy_texture_t texture_handle, const daisy_call_range_t &range )
+    {
+      this->push ( daisy_call_kind::CALL_TRI, key, texture_handle, range );
+    }
+
+    /// <summary>
+    /// appends a shader call. throws if the streams can't grow, they are left unchanged then
+    /// </summary>
+    /// <param name="kind">CALL_VTXSHADER or CALL_PIXSHADER</param>
+    /// <param name="key">sort key</param>
+    /// <param name="shader_handle">shader handle, nullptr to go back to the fixed function pipeline</param>
+    void push_shader ( const daisy_call_kind kind, const uint32_t key, void *shader_handle )
+    {
+      this->push ( kind, key, shader_handle, daisy_call_range_t { } );
+    }
+
+    /// <summary>
+    /// appends a scissor call. throws if the streams can't grow, they are left unchanged then
+    /// </summary>
+    /// <param name="key">sort key</param>
+    /// <param name="position">rectangle position</param>
+    /// <param name="size">rectangle size</param>
+    void push_scissor ( const uint32_t key, const point_t &position, const point_t &size )
+    {
+      const auto scissors = this->m_scissors.size ( );
+      const daisy_call_range_t range { this->scissor_count ( ), 0, 0, 0 };
+
+      try
+      {
+        this->m_scissors.push_back ( position );
+        this->m_scissors.push_back ( size );
+        this->push ( daisy_call_kind::CALL_SCISSOR, key, nullptr, range );
+      }
+      catch ( ... )
+      {
+        this->m_scissors.resize ( scissors );
+        throw;
+      }
+    }
+
+    /// <summary>
+    /// grows the last call by vertices and indices pushed right after it (used for batching)
+    /// </summary>
+    /// <param name="vertices">vertices to add</param>
+    /// <param name="indices">indices to add</param>
+    void extend_back ( const uint32_t vertices, const uint32_t indices ) noexcept
+    {
+      auto &range = this->m_ranges.back ( );
+
+      range.m_vertices += vertices;
+      range.m_indices += indices;
+    }
+
+    /// <summary>
+    /// appends calls of another list. throws if the streams can't grow, they are left unchanged then
+    /// </summary>
+    /// <param name="other">calls to append</param>
+    /// <param name="vertex_offset">offset added to the vertex ranges of appended calls</param>
+    /// <param name="index_offset">offset added to the index ranges of appended calls</param>
+    void append ( const c_drawcalls &other, const uint32_t vertex_offset, const uint32_t index_offset )
+    {
+      const auto first = this->m_ranges.size ( );
+      const auto first_scissor = this->scissor_count ( );
+
+      // grow every stream before touching any, so a failed allocation can't leave them with different lengths
+      this->m_kinds.reserve ( first + other.m_kinds.size ( ) );
+      this->m_keys.reserve ( first + other.m_keys.size ( ) );
+      this->m_handles.reserve ( first + other.m_handles.size ( ) );
+      this->m_ranges.reserve ( first + other.m_ranges.size ( ) );
+      this->m_scissors.reserve ( this->m_scissors.size ( ) + other.m_scissors.size ( ) );
+
+      this->m_kinds.insert ( this->m_kinds.end ( ), other.m_kinds.begin ( ), other.m_kinds.end ( ) );
+      this->m_keys.insert ( this->m_keys.end ( ), other.m_keys.begin ( ), other.m_keys.end ( ) );
+      this->m_handles.insert ( this->m_handles.end ( ), other.m_handles.begin ( ), other.m_handles.end ( ) );
+      this->m_ranges.insert ( this->m_ranges.end ( ), other.m_ranges.begin ( ), other.m_ranges.end ( ) );
+      this->m_scissors.insert ( this->m_scissors.end ( ), other.m_scissors.begin ( ), other.m_scissors.end ( ) );
+
+      for ( auto i = first; i < this->m_ranges.size ( ); ++i )
+      {
+        auto &range = this->m_ranges[ i ];
+
+        if ( this->m_kinds[ i ] == daisy_call_kind::CALL_TRI )
+        {
+          range.m_first_vertex += vertex_offset;
+          range.m_first_index += index_offset;
+        }
+        else if ( this->m_kinds[ i ] == daisy_call_kind::CALL_SCISSOR )
+          range.m_first_vertex += first_scissor;
+      }
+    }
+
+    /// <summary>
+    /// orders calls by sort key, calls with the same key keep the order they were pushed in
+    /// </summary>
+    void sort ( )
+    {
+      if ( stl::is_sorted ( this->m_keys.begin ( ), this->m_keys.end ( ) ) )
+        return;
+
+      const auto count = static_cast< uint32_t > ( this->m_keys.size ( ) );
+
+      // order[ i ] is the call that ends up at i. ties are broken by position, so a plain sort is stable and doesn't need a temporary buffer
+      this->m_order.resize ( count );
+      for ( uint32_t i = 0; i < count; ++i )
+        this->m_order[ i ] = i;
+
+      stl::sort ( this->m_order.begin ( ), this->m_order.end ( ), [ this ] ( const uint32_t a, const uint32_t b ) { return this->m_keys[ a ] < this->m_keys[ b ] || ( this->m_keys[ a ] == this->m_keys[ b ] && a < b ); } );
+
+      // apply permutation in place, one cycle at a time
+      for ( uint32_t i = 0; i < count; ++i )
+      {
+        if ( this->m_order[ i ] == i )
+          continue;
+
+        const auto kind = this->m_kinds[ i ];
+        const auto key = this->m_keys[ i ];
+        const auto handle = this->m_handles[ i ];
+        const auto range = this->m_ranges[ i ];
+
+        uint32_t dst = i;
+        while ( this->m_order[ dst ] != i )
+        {
+          const auto src = this->m_order[ dst ];
+
+          this->m_kinds[ dst ] = this->m_kinds[ src ];
+          this->m_keys[ dst ] = this->m_keys[ src ];
+          this->m_handles[ dst ] = this->m_handles[ src ];
+          this->m_ranges[ dst ] = this->m_ranges[ src ];
+
+          this->m_order[ dst ] = dst;
+          dst = src;
+        }
+
+        this->m_kinds[ dst ] = kind;
+        this->m_keys[ dst ] = key;
+        this->m_handles[ dst ] = handle;
+        this->m_ranges[ dst ] = range;
+
+        this->m_order[ dst ] = dst;
+      }
+    }
+
+    /// <summary>
+    /// get number of calls
+    /// </summary>
+    /// <returns>call count</returns>
+    uint32_t size ( ) const noexcept
+    {
+      return static_cast< uint32_t > ( this->m_kinds.size ( ) );
+    }
+
+    /// <summary>
+    /// check if there are no calls
+    /// </summary>
+    /// <returns>true if there are no calls</returns>
+    bool empty ( ) const noexcept
+    {
+      return this->m_kinds.empty ( );
+    }
+
+    /// <summary>
+    /// get call kinds
+    /// </summary>
+    /// <returns>first kind</returns>
+    const daisy_call_kind *kinds ( ) const noexcept
+    {
+      return this->m_kinds.data ( );
+    }
+
+    /// <summary>
+    /// get sort keys of calls
+    /// </summary>
+    /// <returns>first key</returns>
+    const uint32_t *keys ( ) const noexcept
+    {
+      return this->m_keys.data ( );
+    }
+
+    /// <summary>
+    /// get handles of calls, textures for CALL_TRI and shaders for shader calls
+    /// </summary>
+    /// <returns>first handle</returns>
+    void *const *handles ( ) const noexcept
+    {
+      return this->m_handles.data ( );
+    }
+
+    /// <summary>
+    /// get ranges of calls
+    /// </summary>
+    /// <returns>first range</returns>
+    const daisy_call_range_t *ranges ( ) const noexcept
+    {
+      return this->m_ranges.data ( );
+    }
+
+    /// <summary>
+    /// get rectangle of a scissor call
+    /// </summary>
+    /// <param name="call">index of a CALL_SCISSOR call</param>
+    /// <param name="position">rectangle position</param>
+    /// <param name="size">rectangle size</param>
+    void scissor ( const uint32_t call, point_t &position, point_t &size ) const noexcept
+    {
+      const auto rect = &this->m_scissors[ this->m_ranges[ call ].m_first_vertex * 2 ];
+
+      position = rect[ 0 ];
+      size = rect[ 1 ];
+    }
+
+    /// <summary>
+    /// get number of scissor rectangles
+    /// </summary>
+    /// <returns>rectangle count</returns>
+    uint32_t scissor_count ( ) const noexcept
+    {
+      return static_cast< uint32_t > ( this->m_scissors.size ( ) / 2 );
+    }
+
+    /// <summary>
+    /// get scissor rectangles
+    /// </summary>
+    /// <returns>position of the first rectangle, followed by its size and the next rectangles</returns>
+    const point_t *scissors ( ) const noexcept
+    {
+      return this->m_scissors.data ( );
+    }
+
+    /// <summary>
+    /// replaces all calls with ones stored in flat arrays (eg. a snapshot), handles are stored as ids there
+    /// </summary>
+    /// <typeparam name="fn_t">callable turning a handle id into a handle</typeparam>
+    /// <param name="count">number of calls</param>
+    /// <param name="kinds">call kinds</param>
+    /// <param name="keys">sort keys</param>
+    /// <param name="handle_ids">handle ids, 0 for calls without a handle</param>
+    /// <param name="ranges">call ranges</param>
+    /// <param name="scissor_count">number of scissor rectangles</param>
+    /// <param name="scissors">scissor rectangles, as position and size pairs</param>
+    /// <param name="handle">called for every non-zero handle id</param>
+    template < typename fn_t >
+    void assign ( const uint32_t count, const daisy_call_kind *kinds, const uint32_t *keys, const uint32_t *handle_ids, const daisy_call_range_t *ranges, const uint32_t scissor_count,
+                  const point_t *scissors, fn_t &&handle )
+    {
+      this->m_kinds.assign ( kinds, kinds + count );
+      this->m_keys.assign ( keys, keys + count );
+      this->m_ranges.assign ( ranges, ranges + count );
+      this->m_scissors.assign ( scissors, scissors + scissor_count * 2 );
+
+      this->m_handles.resize ( count );
+      for ( uint32_t i = 0; i < count; ++i )
+        this->m_handles[ i ] = handle_ids[ i ] ? handle ( handle_ids[ i ] ) : nullptr;
+    }
+  };
+
+  // vertex range of something pushed to a c_renderqueue, used to patch it in place. handles are invalidated by c_renderqueue::clear
+  struct daisy_handle_t
+  {
+    uint32_t m_first { 0 }, m_count { 0 };
+  };
+
+  // platform-neutral half of a render queue: generates, batches and patches geometry (text layout included) in cpu-side vertex, index and draw call
+  // lists. it doesn't know about d3d9 at all (see DAISY_NO_D3D9), c_renderqueue uploads and draws what it generated. other backends (or tests,
+  // benchmarks and profilers) can consume the lists through vertices(), indices() and drawcalls()
+  class c_drawlist
+  {
+  protected:
+    // vertex streams of LAYOUT_STREAMS, also used to track which parts of patched vertices changed
+    enum vertex_stream_t : uint8_t
+    {
+      STREAM_POSITION = 0,
+      STREAM_COLOR,
+      STREAM_UV,
+      STREAM_COUNT
+    };
+
+    constexpr static inline uint8_t ALL_STREAMS = ( 1 << STREAM_COUNT ) - 1;
+
+    // vertices patched through handles since the last upload, empty if first > last
+    struct dirty_range_t
+    {
+      uint32_t m_first, m_last;
+    };
+
+    // everything the drawlist allocates comes from here
+    stl::pmr::memory_resource *m_resource;
+
+    renderbuffer_t m_vtxs, m_idxs;
+
+    c_drawcalls m_drawcalls;
+
+    // sort key given to new draw calls
+    uint32_t m_sort_key;
+
+    // flattened bezier curves
+    c_curvecache m_curves;
+
+    // triangulated concave polygons
+    c_polygoncache m_polygons;
+
+    // scratch space for transformed path points
+    stl::pmr::vector< point_t > m_scratch_points;
+
+    // generated geometry (eg. dashes) outside of this rectangle is culled
+    point_t m_cull_mins, m_cull_maxs;
+
+    stl::array< dirty_range_t, STREAM_COUNT > m_dirty;
+
+    // lists changed since the backend last uploaded them
+    bool m_update;
+
+    // local buffers grew, the backend has to reallocate its copies
+    bool m_realloc_vtx, m_realloc_idx;
+
+  protected:
+    /// <summary>
+    /// ensures buffers have enough capacity for the draw call
+    /// </summary>
+    /// <param name="vertices_to_add">vertices to be added to buffer</param>
+    /// <param name="indices_to_add">indices to be added to buffer</param>
+    /// <returns>true if both buffers fit the call, false if they couldn't grow (the call must not be pushed then)</returns>
+    [[nodiscard]] bool ensure_buffers_capacity ( const uint32_t vertices_to_add, const uint32_t indices_to_add ) noexcept
+    {
+      if ( !this->m_vtxs.m_data || !this->m_idxs.m_data )
+        return false;
+
+      // check vtxbuf
+      if ( this->m_vtxs.m_size + vertices_to_add >= this->m_vtxs.m_capacity )
+      {
+        // new capacity is only committed once the buffer is allocated. doubling past 32 bits ends up at 0
+        uint32_t capacity = this->m_vtxs.m_capacity;
+        while ( capacity && this->m_vtxs.m_size + vertices_to_add >= capacity )
+          capacity = capacity * 2;
+
+        // create new vertex buf
+        auto new_vtx = capacity ? detail::make_buffer< uint8_t > ( this->m_resource, static_cast< size_t > ( capacity ) * sizeof ( daisy_vtx_t ) ) : nullptr;
+        if ( !new_vtx )
+          return false;
+
+        // copy old data over
+        memcpy ( new_vtx.get ( ), this->m_vtxs.m_data.get ( ), this->m_vtxs.m_size * sizeof ( daisy_vtx_t ) );
+
+        // d3d9 buf needs to be reallocated on new flush (we could do this here, however this ensures we're in the d3d9 rendering thread)
+        this->m_realloc_vtx = true;
+
+        // replace old data
+        this->m_vtxs.m_data.swap ( new_vtx );
+        this->m_vtxs.m_capacity = capacity;
+      }
+
+      // check idxbuf
+      if ( this->m_idxs.m_size + indices_to_add >= this->m_idxs.m_capacity )
+      {
+        uint32_t capacity = this->m_idxs.m_capacity;
+        while ( capacity && this->m_idxs.m_size + indices_to_add >= capacity )
+          capacity = capacity * 2;
+
+        // create new index buf
+        auto new_idx = capacity ? detail::make_buffer< uint8_t > ( this->m_resource, static_cast< size_t > ( capacity ) * sizeof ( uint16_t ) ) : nullptr;
+        if ( !new_idx )
+          return false;
+
+        // copy old data over
+        memcpy ( new_idx.get ( ), this->m_idxs.m_data.get ( ), this->m_idxs.m_size * sizeof ( uint16_t ) );
+
+        // d3d9 buf needs to be reallocated on new flush (we could do this here, however this ensures we're in the d3d9 rendering thread)
+        this->m_realloc_idx = true;
+
+        // replace old data
+        this->m_idxs.m_data.swap ( new_idx );
+        this->m_idxs.m_capacity = capacity;
+      }
+
+      return true;
+    }
+
+    /// <summary>
+    /// checks if call can be batched
+    /// </summary>
+    /// <param name="texture_handle">texture handle</param>
+    /// <param name="vertices">vertices to be added by the call (batches can't go over what 16 bit indices can address)</param>
+    /// <returns>0 if we can't batch this call, index offset on success</returns>
+    uint32_t begin_batch ( daisy_texture_t texture_handle = nullptr, const uint32_t vertices = 0 ) const noexcept
+    {
+      uint32_t additional = 0;
+
+      // attempt to batch drawcall, the last call has to end right where this one starts (it doesn't after sorting or appending)
+      if ( !this->m_drawcalls.empty ( ) )
+      {
+        const auto last = this->m_drawcalls.size ( ) - 1;
+        const auto &range = this->m_drawcalls.ranges ( )[ last ];
+
+        if ( this->m_drawcalls.kinds ( )[ last ] == daisy_call_kind::CALL_TRI && this->m_drawcalls.handles ( )[ last ] == texture_handle && this->m_drawcalls.keys ( )[ last ] == this->m_sort_key &&
+             range.m_first_vertex + range.m_vertices == this->m_vtxs.m_size && range.m_first_index + range.m_indices == this->m_idxs.m_size && range.m_vertices + vertices <= 0x10000 )
+        {
+          // we can batch this call
+          additional = range.m_vertices;
+        }
+      }
+
+      return additional;
+    }
+
+    /// <summary>
+    /// appends call to batch if possible
+    /// </summary>
+    /// <param name="additional_indices">return value of begin_batch() call</param>
+    /// <param name="vertices">vertices in call, already added to the vertex buffer</param>
+    /// <param name="indices">indices in call, already added to the index buffer</param>
+    /// <param name="texture_handle">texutre handle</param>
+    /// <returns>true on success, false if the call list couldn't grow (the call's geometry is dropped again then)</returns>
+    bool end_batch ( uint32_t additional_indices, uint32_t vertices, uint32_t indices, daisy_texture_t texture_handle = nullptr ) noexcept
+    {
+      // call can't be batched
+      if ( !additional_indices )
+      {
+        try
+        {
+          this->m_drawcalls.push_tri ( this->m_sort_key, texture_handle, daisy_call_range_t { this->m_vtxs.m_size - vertices, vertices, this->m_idxs.m_size - indices, indices } );
+        }
+        catch ( ... )
+        {
+          // the call list couldn't grow, drop the geometry again so none is left without a call
+          this->m_vtxs.m_size -= vertices;
+          this->m_idxs.m_size -= indices;
+          return false;
+        }
+      }
+      // call is batched
+      else
+        this->m_drawcalls.extend_back ( vertices, indices );
+
+      // need to update gpu-side buffers
+      this->m_update = true;
+
+      return true;
+    }
+
+    /// <summary>
+    /// builds handle to vertices pushed since a given vertex
+    /// </summary>
+    /// <param name="first">first vertex pushed</param>
+    /// <returns>handle to pushed vertices</returns>
+    daisy_handle_t handle_since ( const uint32_t first ) const noexcept
+    {
+      return daisy_handle_t { first, this->m_vtxs.m_size - first };
+    }
+
+    /// <summary>
+    /// get vertices of a handle
+    /// </summary>
+    /// <param name="handle">handle returned by a push_* call</param>
+    /// <returns>pointer to first vertex of handle, nullptr if the handle is empty or no longer valid</returns>
+    daisy_vtx_t *handle_vertices ( const daisy_handle_t &handle ) const noexcept
+    {
+      if ( !handle.m_count || handle.m_first + handle.m_count > this->m_vtxs.m_size || !this->m_vtxs.m_data )
+        return nullptr;
+
+      return reinterpret_cast< daisy_vtx_t * > ( this->m_vtxs.m_data.get ( ) ) + handle.m_first;
+    }
+
+    /// <summary>
+    /// marks vertices of a handle for re-upload
+    /// </summary>
+    /// <param name="handle">patched handle</param>
+    /// <param name="streams">mask of patched vertex streams (1 &lt;&lt; STREAM_*)</param>
+    void mark_dirty ( const daisy_handle_t &handle, const uint8_t streams ) noexcept
+    {
+      const auto last = handle.m_first + handle.m_count - 1;
+
+      for ( uint32_t i = 0; i < STREAM_COUNT; ++i )
+      {
+        if ( !( streams & ( 1 << i ) ) )
+          continue;
+
+        auto &range = this->m_dirty[ i ];
+
+        if ( handle.m_first < range.m_first )
+          range.m_first = handle.m_first;
+
+        if ( last > range.m_last )
+          range.m_last = last;
+      }
+    }
+
+    /// <summary>
+    /// forgets about patched vertices, eg. after they got uploaded
+    /// </summary>
+    void reset_dirty ( ) noexcept
+    {
+      for ( auto &range : this->m_dirty )
+        range = dirty_range_t { UINT32_MAX, 0 };
+    }
+
+    /// <summary>
+    /// creates local buffers, if they don't exist yet
+    /// </summary>
+    /// <param name="max_verts">max capacity of vertex buffer</param>
+    /// <param name="max_indices">max capacity of index buffer</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool create_staging ( const uint32_t max_verts, const uint32_t max_indices ) noexcept
+    {
+      // capacities are only set for buffers that could be allocated
+      if ( !this->m_vtxs.m_data.get ( ) )
+      {
+        this->m_vtxs.m_data = detail::make_buffer< uint8_t > ( this->m_resource, sizeof ( daisy_vtx_t ) * max_verts );
+        this->m_vtxs.m_capacity = this->m_vtxs.m_data ? max_verts : 0;
+        this->m_vtxs.m_size = 0;
+      }
+
+      if ( !this->m_idxs.m_data )
+      {
+        this->m_idxs.m_data = detail::make_buffer< uint8_t > ( this->m_resource, sizeof ( uint16_t ) * max_indices );
+        this->m_idxs.m_capacity = this->m_idxs.m_data ? max_indices : 0;
+        this->m_idxs.m_size = 0;
+      }
+
+      return this->m_vtxs.m_data && this->m_idxs.m_data;
+    }
+
+    /// <summary>
+    /// writes vertices of a glyph quad
+    /// </summary>
+    /// <param name="vtx">destination of 4 vertices</param>
+    /// <param name="position">position of glyph</param>
+    /// <param name="size">size of glyph</param>
+    /// <param name="coords">UV coordinates of glyph</param>
+    /// <param name="col">color of glyph</param>
+    static void glyph_vertices ( daisy_vtx_t *vtx, const point_t &position, const point_t &size, const uv_t &coords, const uint32_t col ) noexcept
+    {
+      const float x = position.x - 0.5f, y = position.y - 0.5f;
+
+      vtx[ 0 ] = daisy_vtx_t { { x, y + size.y, 0.f, 1.f }, col, { coords[ 0 ], coords[ 3 ] } };
+      vtx[ 1 ] = daisy_vtx_t { { x, y, 0.f, 1.f }, col, { coords[ 0 ], coords[ 1 ] } };
+      vtx[ 2 ] = daisy_vtx_t { { x + size.x, y + size.y, 0.f, 1.f }, col, { coords[ 2 ], coords[ 3 ] } };
+      vtx[ 3 ] = daisy_vtx_t { { x + size.x, y, 0.f, 1.f }, col, { coords[ 2 ], coords[ 1 ] } };
+    }
+
+    /// <summary>
+    /// checks if vertices were patched since the last upload
+    /// </summary>
+    /// <returns>true if there are patched vertices</returns>
+    bool is_dirty ( ) const noexcept
+    {
+      for ( const auto &range : this->m_dirty )
+        if ( range.m_first <= range.m_last )
+          return true;
+
+      return false;
+    }
+
+    /// <summary>
+    /// strokes a run of consecutive polyline points in a single batch, joins are mitered against the neighbours of the whole polyline
+    /// </summary>
+    /// <param name="points">points of polyline</param>
+    /// <param name="count">number of points</param>
+    /// <param name="first">first point of run, closed polylines count the first point again as count</param>
+    /// <param name="run">number of points in run, at most POLYLINE_MAX_RUN</param>
+    /// <param name="col">color of polyline</param>
+    /// <param name="width">width of polyline</param>
+    /// <param name="closed">if the last point of the polyline is connected back to the first one</param>
+    /// <param name="wrap">if the last point of the run should be connected back to its first one</param>
+    void push_polyline_run ( const point_t *points, const uint32_t count, const uint32_t first, const uint32_t run, const color_t &col, const float width, const bool closed, const bool wrap ) noexcept
+    {
+      const uint32_t segments = wrap ? run : run - 1;
+
+      if ( !this->ensure_buffers_capacity ( run * 2, segments * 6 ) )
+        return;
+
+      uint32_t additional_indices = this->begin_batch ( nullptr, run * 2 );
+
+      uint32_t vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      const auto normal = [ ] ( const point_t &a, const point_t &b ) -> point_t {
+        point_t delta = { b.x - a.x, b.y - a.y };
+        float length = stl::sqrtf ( delta.x * delta.x + delta.y * delta.y );
+
+        if ( length < FLT_EPSILON )
+          return { 0.f, 0.f };
+
+        return { -delta.y / length, delta.x / length };
+      };
+
+      const float half_width = width * 0.5f;
+
+      for ( uint32_t k = 0; k < run; ++k )
+      {
+        const uint32_t i = ( first + k ) % count;
+
+        // neighbouring points, open polylines reuse the end points
+        const auto &prev = points[ i > 0 ? i - 1 : ( closed ? count - 1 : 0 ) ];
+        const auto &cur = points[ i ];
+        const auto &next = points[ i + 1 < count ? i + 1 : ( closed ? 0 : count - 1 ) ];
+
+        point_t n_in = normal ( prev, cur );
+        point_t n_out = normal ( cur, next );
+        point_t miter = { n_in.x + n_out.x, n_in.y + n_out.y };
+        point_t offset { 0.f, 0.f };
+
+        float miter_length_sq = miter.x * miter.x + miter.y * miter.y;
+        if ( miter_length_sq > FLT_EPSILON )
+        {
+          // the miter is 1 / cos(theta / 2) long, clamp it so sharp corners don't spike out
+          float miter_scale = 2.f / miter_length_sq;
+          float max_scale = detail::MITER_LIMIT / stl::sqrtf ( miter_length_sq );
+
+          if ( miter_scale > max_scale )
+            miter_scale = max_scale;
+
+          offset = { miter.x * miter_scale * half_width, miter.y * miter_scale * half_width };
+        }
+        // segments fold back on themselves or one of them is degenerate, just use whichever normal we have
+        else
+        {
+          const auto &n = ( n_in.x != 0.f || n_in.y != 0.f ) ? n_in : n_out;
+          offset = { n.x * half_width, n.y * half_width };
+        }
+
+        vtx[ vtx_counter++ ] = daisy_vtx_t { { cur.x - offset.x, cur.y - offset.y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+        vtx[ vtx_counter++ ] = daisy_vtx_t { { cur.x + offset.x, cur.y + offset.y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+      }
+
+      for ( uint32_t i = 0; i < segments; ++i )
+      {
+        const uint32_t a = additional_indices + i * 2;
+        const uint32_t b = additional_indices + ( ( i + 1 ) % run ) * 2;
+
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( a );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( a + 1 );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( b );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( b );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( b + 1 );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( a + 1 );
+      }
+
+      this->m_vtxs.m_size += vtx_counter;
+      this->m_idxs.m_size += idx_counter;
+
+      this->end_batch ( additional_indices, vtx_counter, idx_counter, nullptr );
+    }
+
+  public:
+    c_drawlist ( stl::pmr::memory_resource *resource = stl::pmr::get_default_resource ( ) ) noexcept
+        : m_resource ( resource ), m_drawcalls ( resource ), m_sort_key ( 0 ), m_curves ( resource ), m_polygons ( resource ), m_scratch_points ( resource ), m_cull_mins ( { -FLT_MAX, -FLT_MAX } ),
+          m_cull_maxs ( { FLT_MAX, FLT_MAX } ), m_update ( true ), m_realloc_vtx ( false ), m_realloc_idx ( false )
+    {
+      this->reset_dirty ( );
+    }
+
+    // disallow copying
+    c_drawlist ( const c_drawlist & ) = delete;
+    c_drawlist &operator= ( const c_drawlist & ) = delete;
+
+    /// <summary>
+    /// initializes drawlist by allocating local buffers, without any backend
+    /// </summary>
+    /// <param name="max_verts">initial capacity of vertex buffer</param>
+    /// <param name="max_indices">initial capacity of index buffer</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t max_verts = 32767, const uint32_t max_indices = 65535 ) noexcept
+    {
+      return this->create_staging ( max_verts, max_indices );
+    }
+
+    /// <summary>
+    /// wipes data from local buffers
+    /// </summary>
+    void clear ( ) noexcept
+    {
+      this->m_vtxs.m_size = 0;
+      this->m_idxs.m_size = 0;
+
+      // buffers of an adopted snapshot are borrowed from the caller's blob, pushes after clearing go into buffers of our own instead
+      if ( this->m_vtxs.m_data && !this->m_vtxs.m_data.get_deleter ( ).m_resource )
+        this->m_vtxs.m_data.reset ( );
+
+      if ( this->m_idxs.m_data && !this->m_idxs.m_data.get_deleter ( ).m_resource )
+        this->m_idxs.m_data.reset ( );
+
+      // nothing to do unless one was dropped, pushes fail if they can't be allocated
+      (void)this->create_staging ( this->m_vtxs.m_capacity, this->m_idxs.m_capacity );
+
+      this->reset_dirty ( );
+
+      if ( !this->m_drawcalls.empty ( ) )
+        this->m_drawcalls.clear ( );
+    }
+
+    /// <summary>
+    /// get generated vertices
+    /// </summary>
+    /// <returns>first vertex, nullptr if there are no local buffers</returns>
+    const daisy_vtx_t *vertices ( ) const noexcept
+    {
+      return reinterpret_cast< const daisy_vtx_t * > ( this->m_vtxs.m_data.get ( ) );
+    }
+
+    /// <summary>
+    /// get number of generated vertices
+    /// </summary>
+    /// <returns>vertex count</returns>
+    uint32_t vertex_count ( ) const noexcept
+    {
+      return this->m_vtxs.m_size;
+    }
+
+    /// <summary>
+    /// get generated indices, relative to the first vertex of their draw call
+    /// </summary>
+    /// <returns>first index, nullptr if there are no local buffers</returns>
+    const uint16_t *indices ( ) const noexcept
+    {
+      return reinterpret_cast< const uint16_t * > ( this->m_idxs.m_data.get ( ) );
+    }
+
+    /// <summary>
+    /// get number of generated indices
+    /// </summary>
+    /// <returns>index count</returns>
+    uint32_t index_count ( ) const noexcept
+    {
+      return this->m_idxs.m_size;
+    }
+
+    /// <summary>
+    /// get memory resource the drawlist allocates from
+    /// </summary>
+    /// <returns>memory resource</returns>
+    stl::pmr::memory_resource *resource ( ) const noexcept
+    {
+      return this->m_resource;
+    }
+
+    /// <summary>
+    /// get draw calls
+    /// </summary>
+    /// <returns>draw calls</returns>
+    const c_drawcalls &drawcalls ( ) const noexcept
+    {
+      return this->m_drawcalls;
+    }
+
+    /// <summary>
+    /// sets sort key of draw calls pushed from now on (eg. a layer), see sort(). the key is kept across clear()
+    /// </summary>
+    /// <param name="key">sort key, 0 by default</param>
+    void set_sort_key ( const uint32_t key ) noexcept
+    {
+      this->m_sort_key = key;
+    }
+
+    /// <summary>
+    /// get sort key of draw calls pushed from now on
+    /// </summary>
+    /// <returns>sort key</returns>
+    uint32_t sort_key ( ) const noexcept
+    {
+      return this->m_sort_key;
+    }
+
+    /// <summary>
+    /// orders draw calls by their sort key, calls with the same key keep the order they were pushed in. only the call list is reordered,
+    /// geometry stays where it is. scissor calls are ordered like any other call, so every key that needs one should push its own
+    /// </summary>
+    void sort ( )
+    {
+      this->m_drawcalls.sort ( );
+    }
+
+    /// <summary>
+    /// appends geometry and draw calls of another drawlist, keeping their sort keys. textures are shared, so both lists have to target the same backend
+    /// </summary>
+    /// <param name="other">drawlist to append</param>
+    /// <returns>true on success (appending nothing counts), false if this list couldn't grow (it's left unchanged then)</returns>
+    [[nodiscard]] bool append ( const c_drawlist &other ) noexcept
+    {
+      if ( &other == this || other.m_drawcalls.empty ( ) || !other.m_vtxs.m_data || !other.m_idxs.m_data )
+        return true;
+
+      if ( !this->ensure_buffers_capacity ( other.m_vtxs.m_size, other.m_idxs.m_size ) || !this->m_vtxs.m_data || !this->m_idxs.m_data )
+        return false;
+
+      try
+      {
+        this->m_drawcalls.append ( other.m_drawcalls, this->m_vtxs.m_size, this->m_idxs.m_size );
+      }
+      catch ( ... )
+      {
+        return false;
+      }
+
+      // indices are relative to the first vertex of their call, so only the ranges need to be offset
+      memcpy ( this->m_vtxs.m_data.get ( ) + this->m_vtxs.m_size * sizeof ( daisy_vtx_t ), other.m_vtxs.m_data.get ( ), other.m_vtxs.m_size * sizeof ( daisy_vtx_t ) );
+      memcpy ( this->m_idxs.m_data.get ( ) + this->m_idxs.m_size * sizeof ( uint16_t ), other.m_idxs.m_data.get ( ), other.m_idxs.m_size * sizeof ( uint16_t ) );
+
+      this->m_vtxs.m_size += other.m_vtxs.m_size;
+      this->m_idxs.m_size += other.m_idxs.m_size;
+
+      this->m_update = true;
+
+      return true;
+    }
+
+    /// <summary>
+    /// saves geometry and draw calls into a versioned binary blob that adopt_snapshot() can use in place. textures (and shaders) are stored as
+    /// ids, so the blob can outlive them (eg. be cached across sessions)
+    /// </summary>
+    /// <typeparam name="fn_t">callable turning a handle into an id</typeparam>
+    /// <param name="out">blob, replaced</param>
+    /// <param name="handle_id">called for every handle other than nullptr, has to return a non-zero id</param>
+    /// <returns>true on success, false otherwise (eg. there's nothing to save or a handle has no id)</returns>
+    template < typename fn_t >
+    [[nodiscard]] bool save_snapshot ( stl::pmr::vector< uint8_t > &out, fn_t &&handle_id ) const
+    {
+      if ( this->m_drawcalls.empty ( ) || !this->m_vtxs.m_size || !this->m_idxs.m_size || !this->m_vtxs.m_data || !this->m_idxs.m_data )
+        return false;
+
+      detail::snapshot_header_t header { };
+      header.m_magic = detail::SNAPSHOT_MAGIC;
+      header.m_version = detail::SNAPSHOT_VERSION;
+      header.m_vertex_size = sizeof ( daisy_vtx_t );
+      header.m_vertices = this->m_vtxs.m_size;
+      header.m_indices = this->m_idxs.m_size;
+      header.m_calls = this->m_drawcalls.size ( );
+      header.m_scissors = this->m_drawcalls.scissor_count ( );
+
+      detail::snapshot_layout ( header );
+      if ( !header.m_size )
+        return false;
+
+      out.assign ( header.m_size, 0 );
+
+      const auto data = out.data ( );
+      memcpy ( data, &header, sizeof ( header ) );
+      memcpy ( data + header.m_offsets[ detail::SNAPSHOT_VERTICES ], this->m_vtxs.m_data.get ( ), header.m_vertices * sizeof ( daisy_vtx_t ) );
+      memcpy ( data + header.m_offsets[ detail::SNAPSHOT_INDICES ], this->m_idxs.m_data.get ( ), header.m_indices * sizeof ( uint16_t ) );
+      memcpy ( data + header.m_offsets[ detail::SNAPSHOT_KINDS ], this->m_drawcalls.kinds ( ), header.m_calls * sizeof ( daisy_call_kind ) );
+      memcpy ( data + header.m_offsets[ detail::SNAPSHOT_KEYS ], this->m_drawcalls.keys ( ), header.m_calls * sizeof ( uint32_t ) );
+      memcpy ( data + header.m_offsets[ detail::SNAPSHOT_RANGES ], this->m_drawcalls.ranges ( ), header.m_calls * sizeof ( daisy_call_range_t ) );
+
+      if ( header.m_scissors )
+        memcpy ( data + header.m_offsets[ detail::SNAPSHOT_SCISSORS ], this->m_drawcalls.scissors ( ), header.m_scissors * sizeof ( point_t ) * 2 );
+
+      const auto handles = this->m_drawcalls.handles ( );
+      const auto ids = reinterpret_cast< uint32_t * > ( data + header.m_offsets[ detail::SNAPSHOT_HANDLES ] );
+
+      for ( uint32_t i = 0; i < header.m_calls; ++i )
+      {
+        if ( !handles[ i ] )
+          continue;
+
+        ids[ i ] = handle_id ( handles[ i ] );
+        if ( !ids[ i ] )
+          return false;
+      }
+
+      return true;
+    }
+
+    /// <summary>
+    /// replaces everything in the drawlist with a blob made by save_snapshot(). vertices and indices aren't copied, the drawlist uses them in
+    /// place (so the blob can be a memory-mapped file) until pushes outgrow it. the blob has to stay valid and writable (patching handles
+    /// writes into it, map files copy-on-write) until the drawlist is cleared or destroyed
+    /// </summary>
+    /// <typeparam name="fn_t">callable turning an id back into a handle</typeparam>
+    /// <param name="blob">blob, aligned to at least 4 bytes</param>
+    /// <param name="size">size of blob in bytes</param>
+    /// <param name="handle">called for every id stored in the blob</param>
+    /// <returns>true on success, false otherwise (eg. the blob is from a different version)</returns>
+    template < typename fn_t >
+    [[nodiscard]] bool adopt_snapshot ( void *blob, const size_t size, fn_t &&handle )
+    {
+      const auto data = static_cast< uint8_t * > ( blob );
+      if ( !data || size < sizeof ( detail::snapshot_header_t ) || reinterpret_cast< uintptr_t > ( data ) % alignof ( daisy_vtx_t ) )
+        return false;
+
+      detail::snapshot_header_t header;
+      memcpy ( &header, data, sizeof ( header ) );
+
+      if ( header.m_magic != detail::SNAPSHOT_MAGIC || header.m_version != detail::SNAPSHOT_VERSION || header.m_vertex_size != sizeof ( daisy_vtx_t ) || !header.m_vertices ||
+           !header.m_indices || !header.m_calls )
+        return false;
+
+      // offsets have to be the ones we'd compute, so nothing points outside of the blob
+      detail::snapshot_header_t layout = header;
+      detail::snapshot_layout ( layout );
+      if ( !layout.m_size || layout.m_size != header.m_size || header.m_size > size || memcmp ( layout.m_offsets, header.m_offsets, sizeof ( header.m_offsets ) ) )
+        return false;
+
+      const auto kinds = reinterpret_cast< const daisy_call_kind * > ( data + header.m_offsets[ detail::SNAPSHOT_KINDS ] );
+      const auto ranges = reinterpret_cast< const daisy_call_range_t * > ( data + header.m_offsets[ detail::SNAPSHOT_RANGES ] );
+      const auto indices = reinterpret_cast< const uint16_t * > ( data + header.m_offsets[ detail::SNAPSHOT_INDICES ] );
+
+      // draw calls (and the indices they draw) are trusted by backends, so check them once here instead of on every flush
+      for ( uint32_t i = 0; i < header.m_calls; ++i )
+      {
+        const auto &range = ranges[ i ];
+
+        if ( kinds[ i ] == daisy_call_kind::CALL_TRI )
+        {
+          if ( uint64_t { range.m_first_vertex } + range.m_vertices > header.m_vertices || uint64_t { range.m_first_index } + range.m_indices > header.m_indices ||
+               range.m_vertices > 0x10000 )
+            return false;
+
+          // indices are relative to the first vertex of their call, so every one has to stay within it
+          for ( uint32_t j = 0; j < range.m_indices; ++j )
+            if ( indices[ range.m_first_index + j ] >= range.m_vertices )
+              return false;
+        }
+        else if ( kinds[ i ] == daisy_call_kind::CALL_SCISSOR )
+        {
+          if ( range.m_first_vertex >= header.m_scissors )
+            return false;
+        }
+        else if ( kinds[ i ] != daisy_call_kind::CALL_VTXSHADER && kinds[ i ] != daisy_call_kind::CALL_PIXSHADER )
+          return false;
+      }
+
+      this->m_drawcalls.assign ( header.m_calls, kinds, reinterpret_cast< const uint32_t * > ( data + header.m_offsets[ detail::SNAPSHOT_KEYS ] ),
+                                 reinterpret_cast< const uint32_t * > ( data + header.m_offsets[ detail::SNAPSHOT_HANDLES ] ), ranges, header.m_scissors,
+                                 reinterpret_cast< const point_t * > ( data + header.m_offsets[ detail::SNAPSHOT_SCISSORS ] ), handle );
+
+      // borrowed buffers are exactly full, so the next push copies them into buffers of our own
+      this->m_vtxs.m_data = detail::resource_buffer_t< uint8_t > ( data + header.m_offsets[ detail::SNAPSHOT_VERTICES ], detail::resource_deleter_t { nullptr, 0 } );
+      this->m_vtxs.m_capacity = this->m_vtxs.m_size = header.m_vertices;
+      this->m_idxs.m_data = detail::resource_buffer_t< uint8_t > ( data + header.m_offsets[ detail::SNAPSHOT_INDICES ], detail::resource_deleter_t { nullptr, 0 } );
+      this->m_idxs.m_capacity = this->m_idxs.m_size = header.m_indices;
+
+      this->reset_dirty ( );
+      this->m_update = this->m_realloc_vtx = this->m_realloc_idx = true;
+
+      return true;
+    }
+
+    /// <summary>
+    /// clips viewport to a certain rectangle
+    /// </summary>
+    /// <param name="position">rectangle position</param>
+    /// <param name="size">rectangle size</param>
+    void push_scissor ( point_t &position, point_t &size ) noexcept
+    {
+      // the call list is left unchanged if it couldn't grow
+      try
+      {
+        this->m_drawcalls.push_scissor ( this->m_sort_key, position, size );
+      }
+      catch ( ... )
+      {
+      }
+    }
+
+    /// <summary>
+    /// sets rectangle outside of which generated geometry (eg. dashes) gets culled, usually the viewport
+    /// </summary>
+    /// <param name="position">rectangle position</param>
+    /// <param name="size">rectangle size</param>
+    void set_cull_rect ( const point_t &position, const point_t &size ) noexcept
+    {
+      this->m_cull_mins = position;
+      this->m_cull_maxs = { position.x + size.x, position.y + size.y };
+    }
+
+    /// <summary>
+    /// disables culling of generated geometry
+    /// </summary>
+    void reset_cull_rect ( ) noexcept
+    {
+      this->m_cull_mins = { -FLT_MAX, -FLT_MAX };
+      this->m_cull_maxs = { FLT_MAX, FLT_MAX };
+    }
+
+    /// <summary>
+    /// changes color of pushed vertices in place, without re-pushing the queue
+    /// </summary>
+    /// <param name="handle">handle returned by a push_* call</param>
+    /// <param name="col">new color</param>
+    /// <returns>true on success, false if the handle is no longer valid</returns>
+    bool set_color ( const daisy_handle_t &handle, const color_t &col ) noexcept
+    {
+      auto vtx = this->handle_vertices ( handle );
+      if ( !vtx )
+        return false;
+
+      for ( uint32_t i = 0; i < handle.m_count; ++i )
+        vtx[ i ].m_col = col.bgra;
+
+      this->mark_dirty ( handle, 1 << STREAM_COLOR );
+
+      return true;
+    }
+
+    /// <summary>
+    /// moves pushed vertices in place, without re-pushing the queue
+    /// </summary>
+    /// <param name="handle">handle returned by a push_* call</param>
+    /// <param name="delta">offset to move vertices by (keep it whole for rectangles, they are snapped to pixels when pushed)</param>
+    /// <returns>true on success, false if the handle is no longer valid</returns>
+    bool translate ( const daisy_handle_t &handle, const point_t &delta ) noexcept
+    {
+      auto vtx = this->handle_vertices ( handle );
+      if ( !vtx )
+        return false;
+
+      for ( uint32_t i = 0; i < handle.m_count; ++i )
+      {
+        vtx[ i ].m_pos[ 0 ] += delta.x;
+        vtx[ i ].m_pos[ 1 ] += delta.y;
+      }
+
+      this->mark_dirty ( handle, 1 << STREAM_POSITION );
+
+      return true;
+    }
+
+    /// <summary>
+    /// moves and resizes a pushed rectangle in place (eg. a bar of a chart), without re-pushing the queue
+    /// </summary>
+    /// <param name="handle">handle returned by push_filled_rectangle or push_gradient_rectangle</param>
+    /// <param name="position">new rectangle position</param>
+    /// <param name="size">new rectangle size</param>
+    /// <returns>true on success, false if the handle is no longer valid or isn't a rectangle</returns>
+    bool set_rectangle ( const daisy_handle_t &handle, const point_t &position, const point_t &size ) noexcept
+    {
+      auto vtx = this->handle_vertices ( handle );
+      if ( !vtx || handle.m_count != 4 )
+        return false;
+
+      // same order and snapping as push_gradient_rectangle
+      const float x1 = stl::floorf ( position.x ), y1 = stl::floorf ( position.y );
+      const float x2 = stl::floorf ( position.x + size.x ), y2 = stl::floorf ( position.y + size.y );
+
+      vtx[ 0 ].m_pos[ 0 ] = vtx[ 3 ].m_pos[ 0 ] = x1;
+      vtx[ 1 ].m_pos[ 0 ] = vtx[ 2 ].m_pos[ 0 ] = x2;
+      vtx[ 0 ].m_pos[ 1 ] = vtx[ 1 ].m_pos[ 1 ] = y1;
+      vtx[ 2 ].m_pos[ 1 ] = vtx[ 3 ].m_pos[ 1 ] = y2;
+
+      this->mark_dirty ( handle, 1 << STREAM_POSITION );
+
+      return true;
+    }
+
+    /// <summary>
+    /// replaces pushed text in place, without re-pushing the queue. the new text can't have more visible glyphs than the pushed one,
+    /// leftover glyphs are collapsed. the font has to be the one the text was pushed with
+    /// </summary>
+    /// <typeparam name="t">iteratable text container (only char and wchar_t accepted currently)</typeparam>
+    /// <typeparam name="font_t">font type with for_each_glyph and texture_handle, eg. c_fontwrapper</typeparam>
+    /// <param name="handle">handle returned by push_text</param>
+    /// <param name="font">font the text was pushed with</param>
+    /// <param name="position">position of text</param>
+    /// <param name="text">new text</param>
+    /// <param name="color">color of text</param>
+    /// <param name="alignment">alignment of text</param>
+    /// <returns>true on success, false if the handle is no longer valid or the text doesn't fit</returns>
+    template < typename t = stl::string_view, typename font_t >
+    bool set_text ( const daisy_handle_t &handle, font_t &font, const point_t &position, const t text, const color_t &color, uint16_t alignment = TEXT_ALIGN_DEFAULT ) noexcept
+    {
+      auto vtx = this->handle_vertices ( handle );
+      if ( !vtx || handle.m_count % 4 )
+        return false;
+
+      // count first so a text that doesn't fit leaves the old one intact
+      uint32_t glyphs = 0;
+      font.for_each_glyph ( position, text, alignment, [ &glyphs ] ( const point_t &, const point_t &, const uv_t & ) { ++glyphs; } );
+
+      if ( glyphs * 4 > handle.m_count )
+        return false;
+
+      uint32_t vtx_counter = 0;
+      font.for_each_glyph ( position, text, alignment, [ & ] ( const point_t &glyph_position, const point_t &glyph_size, const uv_t &coords ) {
+        glyph_vertices ( vtx + vtx_counter, glyph_position, glyph_size, coords, color.bgra );
+        vtx_counter += 4;
+      } );
+
+      // zero area quads don't produce any pixels
+      for ( ; vtx_counter < handle.m_count; ++vtx_counter )
+        vtx[ vtx_counter ] = daisy_vtx_t { { 0.f, 0.f, 0.f, 1.f }, 0, { 0.f, 0.f } };
+
+      this->mark_dirty ( handle, ALL_STREAMS );
+
+      return true;
+    }
+
+    /// <summary>
+    /// push gradient rectangle to drawlist
+    /// </summary>
+    /// <param name="position">rectangle position</param>
+    /// <param name="size">rectangle size</param>
+    /// <param name="c1">top left rectangle color</param>
+    /// <param name="c2">top right rectangle color</param>
+    /// <param name="c3">bottom left rectangle color</param>
+    /// <param name="c4">bottom right rectangle color</param>
+    /// <param name="texture_handle">texture handle (by default nullptr, means no texture is applied)</param>
+    /// <param name="uv_mins">uv mins of rectangle in texture (by default {0, 0})</param>
+    /// <param name="uv_maxs">uv maxs of rectangle in texture (by default {1, 1})</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_gradient_rectangle ( const point_t &position, const point_t &size, const color_t c1, const color_t c2, const color_t c3, const color_t c4, daisy_texture_t texture_handle = nullptr, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !this->ensure_buffers_capacity ( 4, 6 ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( texture_handle, 4 );
+
+      auto vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( position.x ), stl::floorf ( position.y ), 0.0f, 1.f }, c1.bgra, { uv_mins.x, uv_mins.y } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( position.x + size.x ), stl::floorf ( position.y ), 0.0f, 1.f }, c2.bgra, { uv_maxs.x, uv_mins.y } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( position.x + size.x ), stl::floorf ( position.y + size.y ), 0.0f, 1.f }, c4.bgra, { uv_maxs.x, uv_maxs.y } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( position.x ), stl::floorf ( position.y + size.y ), 0.0f, 1.f }, c3.bgra, { uv_mins.x, uv_maxs.y } };
+
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 3 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 3 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
+
+      this->m_vtxs.m_size += 4;
+      this->m_idxs.m_size += 6;
+
+      this->end_batch ( additional_indices, 4, 6, texture_handle );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push filled rectangle to drawlist
+    /// </summary>
+    /// <param name="position">rectangle position</param>
+    /// <param name="size">rectangle size</param>
+    /// <param name="col">rectangle color</param>
+    /// <param name="texture_handle">texture handle (by default nullptr, means no texture is applied)</param>
+    /// <param name="uv_mins">uv mins of rectangle in texture (by default {0, 0})</param>
+    /// <param name="uv_maxs">uv maxs of rectangle in texture (by default {1, 1})</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_filled_rectangle ( const point_t &position, const point_t &size, const color_t col, daisy_texture_t texture_handle = nullptr, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } ) noexcept
+    {
+      return this->push_gradient_rectangle ( position, size, col, col, col, col, texture_handle, uv_mins, uv_maxs );
+    }
+
+    /// <summary>
+    /// push textured quad to drawlist, without snapping its corners to pixels
+    /// </summary>
+    /// <param name="mins">top left corner of quad</param>
+    /// <param name="maxs">bottom right corner of quad</param>
+    /// <param name="col">quad color</param>
+    /// <param name="texture_handle">texture handle (by default nullptr, means no texture is applied)</param>
+    /// <param name="uv_mins">uv mins of quad in texture (by default {0, 0})</param>
+    /// <param name="uv_maxs">uv maxs of quad in texture (by default {1, 1})</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_quad ( const point_t &mins, const point_t &maxs, const color_t col, daisy_texture_t texture_handle = nullptr, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !this->ensure_buffers_capacity ( 4, 6 ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( texture_handle, 4 );
+
+      auto vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { mins.x, mins.y, 0.0f, 1.f }, col.bgra, { uv_mins.x, uv_mins.y } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { maxs.x, mins.y, 0.0f, 1.f }, col.bgra, { uv_maxs.x, uv_mins.y } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { maxs.x, maxs.y, 0.0f, 1.f }, col.bgra, { uv_maxs.x, uv_maxs.y } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { mins.x, maxs.y, 0.0f, 1.f }, col.bgra, { uv_mins.x, uv_maxs.y } };
+
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 3 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 3 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
+
+      this->m_vtxs.m_size += 4;
+      this->m_idxs.m_size += 6;
+
+      this->end_batch ( additional_indices, 4, 6, texture_handle );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push soft shadow (or glow) of a rectangle to drawlist, as a nine-slice of 16 vertices sampling a falloff precomputed with c_texatlas::append_shadow.
+    /// the shadow fades out from radius pixels inside to radius pixels outside of the rectangle; nothing is pushed if the falloff wasn't appended
+    /// </summary>
+    /// <typeparam name="atlas_t">atlas type with shadow_coords and texture_handle, eg. c_texatlas</typeparam>
+    /// <param name="atlas">texture atlas holding the falloff</param>
+    /// <param name="position">position of shadowed rectangle (offset it for drop shadows)</param>
+    /// <param name="size">size of shadowed rectangle</param>
+    /// <param name="radius">blur radius in pixels</param>
+    /// <param name="col">shadow color</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    template < typename atlas_t >
+    daisy_handle_t push_shadow_rect ( const atlas_t &atlas, const point_t &position, const point_t &size, const uint32_t radius, const color_t col ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      uv_t uv;
+      if ( !atlas.shadow_coords ( radius, uv ) )
+        return this->handle_since ( first_vertex );
+
+      const float extent = static_cast< float > ( radius );
+
+      // slice edges and their UVs along one axis; corners get squeezed when the rectangle is smaller than the falloff
+      const auto slices = [ extent ] ( const float start, const float length, const float uv_outer, const float uv_inner, float ( &pos )[ 4 ], float ( &tex )[ 4 ] ) {
+        const float inner = length < extent * 2.f ? length * 0.5f + extent : extent * 2.f;
+        const float uv_mid = uv_outer + ( uv_inner - uv_outer ) * ( inner / ( extent * 2.f ) );
+
+        pos[ 0 ] = start - extent;
+        pos[ 1 ] = pos[ 0 ] + inner;
+        pos[ 3 ] = start + length + extent;
+        pos[ 2 ] = pos[ 3 ] - inner;
+
+        tex[ 0 ] = tex[ 3 ] = uv_outer;
+        tex[ 1 ] = tex[ 2 ] = uv_mid;
+      };
+
+      float xs[ 4 ], us[ 4 ], ys[ 4 ], vs[ 4 ];
+      slices ( position.x, size.x, uv[ 0 ], uv[ 2 ], xs, us );
+      slices ( position.y, size.y, uv[ 1 ], uv[ 3 ], ys, vs );
+
+      if ( !this->ensure_buffers_capacity ( 16, 54 ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( atlas.texture_handle ( ), 16 );
+
+      auto vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      for ( int y = 0; y < 4; ++y )
+        for ( int x = 0; x < 4; ++x )
+          vtx[ vtx_counter++ ] = daisy_vtx_t { { xs[ x ], ys[ y ], 0.f, 1.f }, col.bgra, { us[ x ], vs[ y ] } };
+
+      for ( int y = 0; y < 3; ++y )
+      {
+        for ( int x = 0; x < 3; ++x )
+        {
+          const auto i = static_cast< uint16_t > ( additional_indices + y * 4 + x );
+
+          idx[ idx_counter++ ] = i;
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( i + 1 );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( i + 4 );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( i + 4 );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( i + 5 );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( i + 1 );
+        }
+      }
+
+      this->m_vtxs.m_size += 16;
+      this->m_idxs.m_size += 54;
+
+      this->end_batch ( additional_indices, 16, 54, atlas.texture_handle ( ) );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push soft shadow (or glow) behind a string to drawlist, one push_shadow_rect per line of text. push it before the text itself
+    /// </summary>
+    /// <typeparam name="t">iteratable text container (only char and wchar_t accepted currently)</typeparam>
+    /// <typeparam name="atlas_t">atlas type with shadow_coords and texture_handle, eg. c_texatlas</typeparam>
+    /// <typeparam name="font_t">font type with for_each_glyph and texture_handle, eg. c_fontwrapper</typeparam>
+    /// <param name="atlas">texture atlas holding the falloff</param>
+    /// <param name="font">initialized font</param>
+    /// <param name="position">position of text (offset it for drop shadows)</param>
+    /// <param name="text">text to shadow</param>
+    /// <param name="radius">blur radius in pixels</param>
+    /// <param name="col">shadow color</param>
+    /// <param name="alignment">alignment of text</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    template < typename t = stl::string_view, typename atlas_t, typename font_t >
+    daisy_handle_t push_text_shadow ( const atlas_t &atlas, font_t &font, const point_t &position, const t text, const uint32_t radius, const color_t col, uint16_t alignment = TEXT_ALIGN_DEFAULT ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      point_t line_mins { FLT_MAX, FLT_MAX }, line_maxs { -FLT_MAX, -FLT_MAX };
+
+      const auto push_line = [ & ] ( ) {
+        if ( line_mins.x <= line_maxs.x )
+          this->push_shadow_rect ( atlas, line_mins, { line_maxs.x - line_mins.x, line_maxs.y - line_mins.y }, radius, col );
+
+        line_mins = { FLT_MAX, FLT_MAX };
+        line_maxs = { -FLT_MAX, -FLT_MAX };
+      };
+
+      font.for_each_glyph ( position, text, alignment, [ & ] ( const point_t &glyph_position, const point_t &glyph_size, const uv_t & ) {
+        // glyphs of a line share their y
+        if ( line_mins.x <= line_maxs.x && glyph_position.y != line_mins.y )
+          push_line ( );
+
+        line_mins = { stl::fminf ( line_mins.x, glyph_position.x ), glyph_position.y };
+        line_maxs = { stl::fmaxf ( line_maxs.x, glyph_position.x + glyph_size.x ), stl::fmaxf ( line_maxs.y, glyph_position.y + glyph_size.y ) };
+      } );
+
+      push_line ( );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push filled triangle to drawlist
+    /// </summary>
+    /// <param name="p1">point 1 of triangle</param>
+    /// <param name="p2">point 2 of triangle</param>
+    /// <param name="p3">point 3 of triangle</param>
+    /// <param name="c1">color 1 of triangle</param>
+    /// <param name="c2">color 2 of triangle</param>
+    /// <param name="c3">color 3 of triangle</param>
+    /// <param name="texture_handle">texture handle (by default nullptr, means no texture is applied)</param>
+    /// <param name="uv1">uv bounds for the 1st point</param>
+    /// <param name="uv2">uv bounds for the 2nd point</param>
+    /// <param name="uv3">uv bounds for the 3rd point</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_filled_triangle ( const point_t &p1, const point_t &p2, const point_t &p3, const color_t c1, const color_t c2, const color_t c3, daisy_texture_t texture_handle = nullptr, const point_t &uv1 = { 0.f, 0.f }, const point_t &uv2 = { 0.f, 0.f }, const point_t &uv3 = { 0.f, 0.f } ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !this->ensure_buffers_capacity ( 3, 3 ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( texture_handle, 3 );
+
+      auto vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( p1.x ), stl::floorf ( p1.y ), 0.0f, 1.f }, c1.bgra, { uv1.x, uv1.y } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( p2.x ), stl::floorf ( p2.y ), 0.0f, 1.f }, c2.bgra, { uv2.x, uv2.y } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( p3.x ), stl::floorf ( p3.y ), 0.0f, 1.f }, c3.bgra, { uv3.x, uv3.y } };
+
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
+
+      this->m_vtxs.m_size += 3;
+      this->m_idxs.m_size += 3;
+
+      this->end_batch ( additional_indices, 3, 3, texture_handle );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push line to drawlist
+    /// </summary>
+    /// <param name="p1">point 1 of line</param>
+    /// <param name="p2">point 2 of line</param>
+    /// <param name="col">color of line</param>
+    /// <param name="width">width of line</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_line ( const point_t &p1, const point_t &p2, const color_t &col, const float width = 1.f ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !this->ensure_buffers_capacity ( 4, 6 ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( nullptr, 4 );
+
+      // shoutout 8th grade math
+      point_t delta = { p2.x - p1.x, p2.y - p1.y };
+      float length = stl::sqrtf ( delta.x * delta.x + delta.y * delta.y ) + FLT_EPSILON;
+
+      float scale = width / ( 2.f * length );
+      point_t radius = { -scale * delta.y, scale * delta.x };
+
+      auto vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { p1.x - radius.x, p1.y - radius.y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { p1.x + radius.x, p1.y + radius.y, 0.0f, 1.f }, col.bgra, { 1.f, 0.f } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { p2.x - radius.x, p2.y - radius.y, 0.0f, 1.f }, col.bgra, { 1.f, 1.f } };
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { p2.x + radius.x, p2.y + radius.y, 0.0f, 1.f }, col.bgra, { 0.f, 1.f } };
+
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 3 );
+      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
+
+      this->m_vtxs.m_size += 4;
+      this->m_idxs.m_size += 6;
+
+      this->end_batch ( additional_indices, 4, 6, nullptr );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push polyline to drawlist with mitered joins. all segments are stroked in a single batch, unless the polyline has more points than a
+    /// batch can address. in that case it's split into runs sharing their end points
+    /// </summary>
+    /// <param name="points">points of polyline</param>
+    /// <param name="count">number of points</param>
+    /// <param name="col">color of polyline</param>
+    /// <param name="width">width of polyline</param>
+    /// <param name="closed">if the last point should be connected back to the first one</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_polyline ( const point_t *points, const uint32_t count, const color_t &col, const float width = 1.f, const bool closed = false ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !points || count < 2 )
+        return this->handle_since ( first_vertex );
+
+      if ( count <= detail::POLYLINE_MAX_RUN )
+      {
+        this->push_polyline_run ( points, count, 0, count, col, width, closed, closed );
+        return this->handle_since ( first_vertex );
+      }
+
+      // closed polylines end on their first point again
+      const uint32_t total = closed ? count + 1 : count;
+
+      for ( uint32_t start = 0; start + 1 < total; start += detail::POLYLINE_MAX_RUN - 1 )
+      {
+        const uint32_t run = total - start < detail::POLYLINE_MAX_RUN ? total - start : detail::POLYLINE_MAX_RUN;
+        this->push_polyline_run ( points, count, start, run, col, width, closed, false );
+      }
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push dashed polyline to drawlist, the dash pattern carries on across segments and all dashes are generated in a single batch.
+    /// dashes outside of the cull rectangle (see set_cull_rect) are skipped
+    /// </summary>
+    /// <param name="points">points of polyline</param>
+    /// <param name="count">number of points</param>
+    /// <param name="pattern">alternating dash and gap lengths in pixels, starting with a dash (odd length patterns are repeated twice, dotted lines are { width, gap })</param>
+    /// <param name="pattern_count">number of lengths in pattern</param>
+    /// <param name="col">color of polyline</param>
+    /// <param name="width">width of polyline</param>
+    /// <param name="closed">if the last point should be connected back to the first one</param>
+    /// <param name="phase">offset into the pattern the polyline starts at, in pixels</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_dashed_polyline ( const point_t *points, const uint32_t count, const float *pattern, const uint32_t pattern_count, const color_t &col, const float width = 1.f, const bool closed = false, const float phase = 0.f ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !points || count < 2 || !pattern || !pattern_count )
+        return this->handle_since ( first_vertex );
+
+      // odd patterns flip dash/gap on every repetition, so a full period is twice as long
+      const uint32_t entries = ( pattern_count % 2 ) ? pattern_count * 2 : pattern_count;
+
+      float period = 0.f;
+      for ( uint32_t i = 0; i < entries; ++i )
+        period += pattern[ i % pattern_count ] > 0.f ? pattern[ i % pattern_count ] : 0.f;
+
+      if ( period <= FLT_EPSILON )
+        return this->handle_since ( first_vertex );
+
+      const uint32_t segments = closed ? count : count - 1;
+
+      // upper bound of dash pieces, a segment touches at most floor(length / period) + 2 periods
+      uint32_t max_pieces = 0;
+      for ( uint32_t i = 0; i < segments; ++i )
+      {
+        const auto &a = points[ i ];
+        const auto &b = points[ ( i + 1 ) % count ];
+        const float length = stl::sqrtf ( ( b.x - a.x ) * ( b.x - a.x ) + ( b.y - a.y ) * ( b.y - a.y ) );
+
+        max_pieces += ( static_cast< uint32_t > ( length / period ) + 2 ) * ( entries / 2 );
+      }
+
+      if ( !this->ensure_buffers_capacity ( max_pieces * 4, max_pieces * 6 ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( nullptr, 4 );
+      uint32_t vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      // find where in the pattern we start
+      uint32_t entry = 0;
+      float offset = stl::fmodf ( phase, period );
+      if ( offset < 0.f )
+        offset += period;
+
+      float remaining = pattern[ 0 ] > 0.f ? pattern[ 0 ] : 0.f;
+      while ( offset >= remaining )
+      {
+        offset -= remaining;
+        entry = ( entry + 1 ) % entries;
+        remaining = pattern[ entry % pattern_count ] > 0.f ? pattern[ entry % pattern_count ] : 0.f;
+      }
+      remaining -= offset;
+
+      const float half_width = width * 0.5f;
+      const point_t cull_mins { this->m_cull_mins.x - half_width, this->m_cull_mins.y - half_width };
+      const point_t cull_maxs { this->m_cull_maxs.x + half_width, this->m_cull_maxs.y + half_width };
+
+      for ( uint32_t i = 0; i < segments; ++i )
+      {
+        const auto &a = points[ i ];
+        const auto &b = points[ ( i + 1 ) % count ];
+
+        point_t delta = { b.x - a.x, b.y - a.y };
+        const float length = stl::sqrtf ( delta.x * delta.x + delta.y * delta.y );
+
+        if ( length <= FLT_EPSILON )
+          continue;
+
+        const point_t dir = { delta.x / length, delta.y / length };
+        const point_t radius = { -dir.y * half_width, dir.x * half_width };
+
+        // whole segment is off screen, only advance the pattern. full periods don't change where we are in it
+        const bool culled = ( a.x < cull_mins.x && b.x < cull_mins.x ) || ( a.x > cull_maxs.x && b.x > cull_maxs.x ) ||
+                            ( a.y < cull_mins.y && b.y < cull_mins.y ) || ( a.y > cull_maxs.y && b.y > cull_maxs.y );
+
+        float t = culled ? length - stl::fmodf ( length, period ) : 0.f;
+
+        while ( t < length )
+        {
+          const float step = remaining < length - t ? remaining : length - t;
+
+          if ( !culled && !( entry % 2 ) && step > 0.f )
+          {
+            const point_t p1 = { a.x + dir.x * t, a.y + dir.y * t };
+            const point_t p2 = { a.x + dir.x * ( t + step ), a.y + dir.y * ( t + step ) };
+
+            const bool visible = !( ( p1.x < cull_mins.x && p2.x < cull_mins.x ) || ( p1.x > cull_maxs.x && p2.x > cull_maxs.x ) ||
+                                    ( p1.y < cull_mins.y && p2.y < cull_mins.y ) || ( p1.y > cull_maxs.y && p2.y > cull_maxs.y ) );
+
+            if ( visible )
+            {
+              // batch is full, 16 bit indices can't address any more vertices
+              if ( additional_indices + vtx_counter + 4 > 0x10000 )
+              {
+                this->m_vtxs.m_size += vtx_counter;
+                this->m_idxs.m_size += idx_counter;
+                // the rest would be written past the dropped batch
+                if ( !this->end_batch ( additional_indices, vtx_counter, idx_counter, nullptr ) )
+                  return this->handle_since ( first_vertex );
+
+                vtx += vtx_counter;
+                idx += idx_counter;
+                vtx_counter = idx_counter = 0;
+
+                additional_indices = this->begin_batch ( nullptr, 4 );
+              }
+
+              const uint32_t base = additional_indices + vtx_counter;
+
+              vtx[ vtx_counter++ ] = daisy_vtx_t { { p1.x - radius.x, p1.y - radius.y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+              vtx[ vtx_counter++ ] = daisy_vtx_t { { p1.x + radius.x, p1.y + radius.y, 0.0f, 1.f }, col.bgra, { 1.f, 0.f } };
+              vtx[ vtx_counter++ ] = daisy_vtx_t { { p2.x - radius.x, p2.y - radius.y, 0.0f, 1.f }, col.bgra, { 1.f, 1.f } };
+              vtx[ vtx_counter++ ] = daisy_vtx_t { { p2.x + radius.x, p2.y + radius.y, 0.0f, 1.f }, col.bgra, { 0.f, 1.f } };
+
+              idx[ idx_counter++ ] = static_cast< uint16_t > ( base );
+              idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 1 );
+              idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 2 );
+              idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 2 );
+              idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 3 );
+              idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 1 );
+            }
+          }
+
+          t += step;
+          remaining -= step;
+
+          // move on to the next dash or gap
+          if ( remaining <= 0.f )
+          {
+            entry = ( entry + 1 ) % entries;
+            remaining = pattern[ entry % pattern_count ] > 0.f ? pattern[ entry % pattern_count ] : 0.f;
+          }
+        }
+      }
+
+      if ( !vtx_counter )
+        return this->handle_since ( first_vertex );
+
+      this->m_vtxs.m_size += vtx_counter;
+      this->m_idxs.m_size += idx_counter;
+
+      this->end_batch ( additional_indices, vtx_counter, idx_counter, nullptr );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push dashed line to drawlist
+    /// </summary>
+    /// <param name="p1">point 1 of line</param>
+    /// <param name="p2">point 2 of line</param>
+    /// <param name="pattern">alternating dash and gap lengths in pixels, starting with a dash</param>
+    /// <param name="pattern_count">number of lengths in pattern</param>
+    /// <param name="col">color of line</param>
+    /// <param name="width">width of line</param>
+    /// <param name="phase">offset into the pattern the line starts at, in pixels</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_dashed_line ( const point_t &p1, const point_t &p2, const float *pattern, const uint32_t pattern_count, const color_t &col, const float width = 1.f, const float phase = 0.f ) noexcept
+    {
+      const point_t points[] = { p1, p2 };
+      return this->push_dashed_polyline ( points, 2, pattern, pattern_count, col, width, false, phase );
+    }
+
+    /// <summary>
+    /// push plot of samples to drawlist. samples are decimated to a min/max envelope per pixel column,
+    /// so the amount of vertices is bound by the width of the plot rather than the amount of samples
+    /// </summary>
+    /// <param name="samples">samples to plot, the first sample is drawn at the left edge</param>
+    /// <param name="count">number of samples</param>
+    /// <param name="position">position of plot rectangle</param>
+    /// <param name="size">size of plot rectangle</param>
+    /// <param name="range">values mapped to the bottom (x) and top (y) of the plot rectangle, values outside are clamped</param>
+    /// <param name="col">color of plot</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_plot ( const float *samples, const uint32_t count, const point_t &position, const point_t &size, const point_t &range, const color_t &col ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !samples || count < 2 || size.x < 1.f || range.y == range.x )
+        return this->handle_since ( first_vertex );
+
+      const auto columns = static_cast< uint32_t > ( stl::ceilf ( size.x ) );
+      const float scale = size.y / ( range.y - range.x );
+      const float bottom = position.y + size.y;
+
+      const auto to_y = [ & ] ( const float value ) -> float {
+        const float y = bottom - ( value - range.x ) * scale;
+        return y < position.y ? position.y : ( y > bottom ? bottom : y );
+      };
+
+      // not enough samples to fill every column, a plain polyline is cheaper
+      if ( count <= columns )
+      {
+        this->m_scratch_points.resize ( count );
+        for ( uint32_t i = 0; i < count; ++i )
+          this->m_scratch_points[ i ] = { position.x + size.x * static_cast< float > ( i ) / static_cast< float > ( count - 1 ), to_y ( samples[ i ] ) };
+
+        this->push_polyline ( this->m_scratch_points.data ( ), count, col );
+        return this->handle_since ( first_vertex );
+      }
+
+      float prev_top = 0.f, prev_bottom = 0.f;
+
+      // wide plots are split into several batches, 16 bit indices can't address more than PLOT_MAX_COLUMNS columns
+      for ( uint32_t chunk = 0; chunk < columns; chunk += detail::PLOT_MAX_COLUMNS )
+      {
+        const uint32_t chunk_columns = columns - chunk < detail::PLOT_MAX_COLUMNS ? columns - chunk : detail::PLOT_MAX_COLUMNS;
+
+        if ( !this->ensure_buffers_capacity ( chunk_columns * 4, chunk_columns * 6 ) )
+          return this->handle_since ( first_vertex );
+
+        uint32_t additional_indices = this->begin_batch ( nullptr, chunk_columns * 4 );
+
+        uint32_t vtx_counter = 0, idx_counter = 0;
+
+        daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+        uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+        for ( uint32_t c = chunk; c < chunk + chunk_columns; ++c )
+        {
+          const auto first = static_cast< uint32_t > ( static_cast< uint64_t > ( c ) * count / columns );
+          const auto last = static_cast< uint32_t > ( static_cast< uint64_t > ( c + 1 ) * count / columns );
+
+          float lo, hi;
+          detail::min_max ( samples + first, last - first, lo, hi );
+
+          // higher values are further up the screen
+          float top = to_y ( hi ), bot = to_y ( lo );
+
+          // stretch towards the previous column so the envelope stays connected
+          if ( c > 0 )
+          {
+            if ( top > prev_bottom )
+              top = prev_bottom;
+
+            if ( bot < prev_top )
+              bot = prev_top;
+          }
+
+          // ensure flat stretches are still visible
+          if ( bot - top < 1.f )
+            bot = top + 1.f;
+
+          prev_top = top;
+          prev_bottom = bot;
+
+          const float x1 = position.x + static_cast< float > ( c );
+          const float x2 = x1 + 1.f;
+          const uint32_t base = additional_indices + vtx_counter;
+
+          vtx[ vtx_counter++ ] = daisy_vtx_t { { x1, top, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+          vtx[ vtx_counter++ ] = daisy_vtx_t { { x2, top, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+          vtx[ vtx_counter++ ] = daisy_vtx_t { { x2, bot, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+          vtx[ vtx_counter++ ] = daisy_vtx_t { { x1, bot, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( base );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 1 );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 3 );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 3 );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 2 );
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( base + 1 );
+        }
+
+        this->m_vtxs.m_size += vtx_counter;
+        this->m_idxs.m_size += idx_counter;
+
+        this->end_batch ( additional_indices, vtx_counter, idx_counter, nullptr );
+      }
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push quadratic bezier curve to drawlist, the curve is subdivided only where it isn't flat enough yet and flattened curves are cached
+    /// </summary>
+    /// <param name="p1">start point of curve</param>
+    /// <param name="p2">control point of curve</param>
+    /// <param name="p3">end point of curve</param>
+    /// <param name="col">color of curve</param>
+    /// <param name="width">width of curve</param>
+    /// <param name="tolerance">max distance in pixels between the curve and its flattened version (less = smoother curve, more vertices)</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_quad_bezier ( const point_t &p1, const point_t &p2, const point_t &p3, const color_t &col, const float width = 1.f, const float tolerance = 0.25f )
+    {
+      const auto &points = this->m_curves.quad_bezier ( p1, p2, p3, tolerance );
+      return this->push_polyline ( points.data ( ), static_cast< uint32_t > ( points.size ( ) ), col, width );
+    }
+
+    /// <summary>
+    /// push cubic bezier curve to drawlist, the curve is subdivided only where it isn't flat enough yet and flattened curves are cached
+    /// </summary>
+    /// <param name="p1">start point of curve</param>
+    /// <param name="p2">first control point of curve</param>
+    /// <param name="p3">second control point of curve</param>
+    /// <param name="p4">end point of curve</param>
+    /// <param name="col">color of curve</param>
+    /// <param name="width">width of curve</param>
+    /// <param name="tolerance">max distance in pixels between the curve and its flattened version (less = smoother curve, more vertices)</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_cubic_bezier ( const point_t &p1, const point_t &p2, const point_t &p3, const point_t &p4, const color_t &col, const float width = 1.f, const float tolerance = 0.25f )
+    {
+      const auto &points = this->m_curves.cubic_bezier ( p1, p2, p3, p4, tolerance );
+      return this->push_polyline ( points.data ( ), static_cast< uint32_t > ( points.size ( ) ), col, width );
+    }
+
+    /// <summary>
+    /// push filled convex polygon to drawlist, triangulated as a fan from the first point
+    /// </summary>
+    /// <param name="points">points of polygon, in any winding order</param>
+    /// <param name="count">number of points (at most 65535)</param>
+    /// <param name="col">color of polygon</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_convex_polygon ( const point_t *points, const uint32_t count, const color_t &col ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !points || count < 3 || count > 0xffff )
+        return this->handle_since ( first_vertex );
+
+      if ( !this->ensure_buffers_capacity ( count, ( count - 2 ) * 3 ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( nullptr, count );
+
+      uint32_t vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      for ( uint32_t i = 0; i < count; ++i )
+        vtx[ vtx_counter++ ] = daisy_vtx_t { { points[ i ].x, points[ i ].y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+
+      for ( uint32_t i = 1; i + 1 < count; ++i )
+      {
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + i );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + i + 1 );
+      }
+
+      this->m_vtxs.m_size += vtx_counter;
+      this->m_idxs.m_size += idx_counter;
+
+      this->end_batch ( additional_indices, vtx_counter, idx_counter, nullptr );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push filled polygon to drawlist, concave and self-touching polygons are supported.
+    /// triangulations are cached by point set, so static shapes are only triangulated once
+    /// </summary>
+    /// <param name="points">points of polygon, in any winding order</param>
+    /// <param name="count">number of points (at most 65535)</param>
+    /// <param name="col">color of polygon</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_polygon ( const point_t *points, const uint32_t count, const color_t &col )
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      if ( !points || count < 3 || count > 0xffff )
+        return this->handle_since ( first_vertex );
+
+      const auto &indices = this->m_polygons.triangulate ( points, count );
+      const auto index_count = static_cast< uint32_t > ( indices.size ( ) );
+
+      if ( !this->ensure_buffers_capacity ( count, index_count ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( nullptr, count );
+
+      uint32_t vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      for ( uint32_t i = 0; i < count; ++i )
+        vtx[ vtx_counter++ ] = daisy_vtx_t { { points[ i ].x, points[ i ].y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+
+      // cached indices are relative to the polygon, just move them over to where the polygon lives in the batch
+      for ( uint32_t i = 0; i < index_count; ++i )
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + indices[ i ] );
+
+      this->m_vtxs.m_size += vtx_counter;
+      this->m_idxs.m_size += idx_counter;
+
+      this->end_batch ( additional_indices, vtx_counter, idx_counter, nullptr );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push filled path to drawlist, every subpath is filled on its own (holes aren't cut out)
+    /// </summary>
+    /// <param name="path">path to fill</param>
+    /// <param name="col">color of path</param>
+    /// <param name="transform">transform applied to path</param>
+    /// <param name="tolerance">max distance in pixels between the path and its flattened version</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_filled_path ( c_path &path, const color_t &col, const transform_t &transform = transform_t::identity ( ), const float tolerance = 0.25f )
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      const float scale = transform.max_scale ( );
+      if ( scale <= FLT_EPSILON || !path.tessellate ( tolerance / scale, true ) )
+        return this->handle_since ( first_vertex );
+
+      const auto &points = path.points ( );
+      const auto &indices = path.fill_indices ( );
+
+      const auto vertex_count = static_cast< uint32_t > ( points.size ( ) );
+      const auto index_count = static_cast< uint32_t > ( indices.size ( ) );
+
+      if ( !index_count )
+        return this->handle_since ( first_vertex );
+
+      if ( !this->ensure_buffers_capacity ( vertex_count, index_count ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( nullptr, vertex_count );
+
+      uint32_t vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      for ( const auto &point : points )
+      {
+        const auto p = transform.apply ( point );
+        vtx[ vtx_counter++ ] = daisy_vtx_t { { p.x, p.y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
+      }
+
+      for ( const auto index : indices )
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + index );
+
+      this->m_vtxs.m_size += vtx_counter;
+      this->m_idxs.m_size += idx_counter;
+
+      this->end_batch ( additional_indices, vtx_counter, idx_counter, nullptr );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push stroked path to drawlist, the stroke width isn't affected by the transform. subpaths of any length can be stroked, long ones are
+    /// split into several batches like in push_polyline
+    /// </summary>
+    /// <param name="path">path to stroke</param>
+    /// <param name="col">color of path</param>
+    /// <param name="width">width of stroke in pixels</param>
+    /// <param name="transform">transform applied to path</param>
+    /// <param name="tolerance">max distance in pixels between the path and its flattened version</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_stroked_path ( c_path &path, const color_t &col, const float width = 1.f, const transform_t &transform = transform_t::identity ( ), const float tolerance = 0.25f )
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      const float scale = transform.max_scale ( );
+      if ( scale <= FLT_EPSILON || !path.tessellate ( tolerance / scale, false ) )
+        return this->handle_since ( first_vertex );
+
+      const auto &points = path.points ( );
+
+      for ( uint32_t i = 0; i < path.subpath_count ( ); ++i )
+      {
+        uint32_t first, count;
+        bool closed;
+        path.subpath ( i, first, count, closed );
+
+        this->m_scratch_points.resize ( count );
+        for ( uint32_t j = 0; j < count; ++j )
+          this->m_scratch_points[ j ] = transform.apply ( points[ first + j ] );
+
+        this->push_polyline ( this->m_scratch_points.data ( ), count, col, width, closed );
+      }
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// access cache of flattened bezier curves
+    /// </summary>
+    /// <returns>curve cache</returns>
+    c_curvecache &curve_cache ( ) noexcept
+    {
+      return this->m_curves;
+    }
+
+    /// <summary>
+    /// access cache of polygon triangulations
+    /// </summary>
+    /// <returns>polygon cache</returns>
+    c_polygoncache &polygon_cache ( ) noexcept
+    {
+      return this->m_polygons;
+    }
+
+    /// <summary>
+    /// push filled arc of circle to drawlist
+    /// to note: it would be more efficient to use a pixel shader and draw a quad to draw the circle
+    /// </summary>
+    /// <param name="center">center of circle</param>
+    /// <param name="radius">radius of circle</param>
+    /// <param name="segments">how many points are used to draw the circle (less = circle is less accurate, more = more vertices and indicies used, increased memory usage, slower to compute)</param>
+    /// <param name="factor">how much of the circle arc to draw [0.0, 1.0]</param>
+    /// <param name="center_color">the color of the center of the circle</param>
+    /// <param name="outer_color">the color of the outside of the circle</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_filled_arc ( const point_t &center, const float radius, const int segments, const float factor, const color_t &center_color, const color_t &outer_color )
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      // sanity checks
+      if ( segments < 3 || factor <= 0.f || factor > 1.f )
+        return this->handle_since ( first_vertex );
+
+      int segments_to_draw = static_cast< int > ( static_cast< float > ( segments ) * factor );
+
+      if ( !this->ensure_buffers_capacity ( static_cast< uint32_t > ( segments_to_draw + 2 ), static_cast< uint32_t > ( ( segments_to_draw + 1 ) * 3 ) ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( nullptr, static_cast< uint32_t > ( segments_to_draw + 3 ) );
+
+      auto vtx_counter = 0, idx_counter = 0;
+
+      // write directly to the end of the buffer as we know we have more than enough space - need to start doing this everywhere
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      // center point
+      vtx[ vtx_counter++ ] = daisy_vtx_t { { center.x, center.y, 0.0f, 1.f }, center_color.bgra, { 0.f, 0.f } };
+
+      auto seg = segments_to_draw;
+
+      // outer points
+      for ( int i = 0; i <= seg + 1; ++i )
+      {
+        float tetha = 2.f * detail::PI * static_cast< float > ( i ) / static_cast< float > ( segments );
+        float x = center.x + ( radius * stl::cosf ( tetha ) );
+        float y = center.y - ( radius * stl::sinf ( tetha ) );
+
+        // circle outer point
+        vtx[ vtx_counter++ ] = daisy_vtx_t { { x, y, 0.0f, 1.f }, outer_color.bgra, { 0.f, 0.f } };
+
+        // indices
+        if ( i > 0 )
+        {
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );         // center
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + i );     // current outer
+          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + i - 1 ); // last outer
+        }
+      }
+
+      this->m_vtxs.m_size += vtx_counter;
+      this->m_idxs.m_size += idx_counter;
+
+      this->end_batch ( additional_indices, vtx_counter, idx_counter, nullptr );
+
+      return this->handle_since ( first_vertex );
+    }
+
+    /// <summary>
+    /// push filled circle to drawlist
+    /// to note: it would be more efficient to use a pixel shader and draw a quad to draw the circle
+    /// </summary>
+    /// <param name="center">center of circle</param>
+    /// <param name="radius">radius of circle</param>
+    /// <param name="segments">how many points are used to draw the circle (less = circle is less accurate, more = more vertices and indicies used, increased memory usage, slower to compute)</param>
+    /// <param name="center_color">the color of the center of the circle</param>
+    /// <param name="outer_color">the color of the outside of the circle</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    daisy_handle_t push_filled_circle ( const point_t &center, const float radius, const int segments, const color_t &center_color, const color_t &outer_color )
+    {
+      return this->push_filled_arc ( center, radius, segments, 1.f, center_color, outer_color );
+    }
+
+    /// <summary>
+    /// push a string with a given font to drawlist
+    /// </summary>
+    /// <typeparam name="t">iteratable text container (only char and wchar_t accepted currently)</typeparam>
+    /// <typeparam name="font_t">font type with for_each_glyph and texture_handle, eg. c_fontwrapper</typeparam>
+    /// <param name="font">initialized font</param>
+    /// <param name="position">position of text</param>
+    /// <param name="text">text to draw</param>
+    /// <param name="color">color of text to draw</param>
+    /// <param name="alignment">alignment of text to draw</param>
+    /// <returns>handle to pushed vertices, empty if nothing was pushed</returns>
+    template < typename t = stl::string_view, typename font_t >
+    daisy_handle_t push_text ( font_t &font, const point_t &position, const t text, const color_t &color, uint16_t alignment = TEXT_ALIGN_DEFAULT ) noexcept
+    {
+      const auto first_vertex = this->m_vtxs.m_size;
+
+      // this is a rough approximate, best we can do without passing through the entire string twice.
+      if ( !this->ensure_buffers_capacity ( static_cast< uint32_t > ( text.size ( ) * 4 ), static_cast< uint32_t > ( text.size ( ) * 6 ) ) )
+        return this->handle_since ( first_vertex );
+
+      uint32_t additional_indices = this->begin_batch ( font.texture_handle ( ), static_cast< uint32_t > ( text.size ( ) * 4 ) );
+      uint32_t cont_vertices = 0, cont_indices = 0;
+
+      auto vtx_counter = 0, idx_counter = 0;
+
+      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
+      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+
+      font.for_each_glyph ( position, text, alignment, [ & ] ( const point_t &glyph_position, const point_t &glyph_size, const uv_t &coords ) {
+        glyph_vertices ( vtx + vtx_counter, glyph_position, glyph_size, coords, color.bgra );
+        vtx_counter += 4;
+
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 1 );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 2 );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 3 );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 2 );
+        idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 1 );
+
+        this->m_vtxs.m_size += 4;
+        this->m_idxs.m_size += 6;
+
+        cont_vertices += 4;
+        cont_indices += 6;
+      } );
+
+      this->end_batch ( additional_indices, cont_vertices, cont_indices, font.texture_handle ( ) );
+
+      return this->handle_since ( first_vertex );
+    }
+  };
+
+  // texture of c_softtarget, pass its address as daisy_texture_t when pushing to a drawlist that gets drawn with one
+  struct softtexture_t
+  {
+    const uint32_t *m_pixels; // bgra, same as D3DFMT_A8R8G8B8
+    uint32_t m_width, m_height;
+  };
+
+  // cpu rasterizer for drawlists, mirrors the fixed function state daisy sets up (see c_daisy_context::prepare) closely enough to compare frames
+  // pixel by pixel. meant for checking that changes to geometry generation or batching don't change the output, on any platform and without a
+  // device. textures are point sampled, shader calls are ignored
+  class c_softtarget
+  {
+  private:
+    stl::pmr::memory_resource *m_resource;
+    detail::resource_buffer_t< uint32_t > m_pixels;
+    uint32_t m_width, m_height;
+
+    // current scissor rectangle, [mins, maxs)
+    int32_t m_clip[ 4 ];
+
+  private:
+    /// <summary>
+    /// edge function, positive if p is right of a->b on screen (y pointing down)
+    /// </summary>
+    /// <param name="a">start of edge</param>
+    /// <param name="b">end of edge</param>
+    /// <param name="px">x of point</param>
+    /// <param name="py">y of point</param>
+    /// <returns>twice the signed area of a, b, p</returns>
+    static float edge ( const float *a, const float *b, const float px, const float py ) noexcept
+    {
+      return ( b[ 0 ] - a[ 0 ] ) * ( py - a[ 1 ] ) - ( b[ 1 ] - a[ 1 ] ) * ( px - a[ 0 ] );
+    }
+
+    /// <summary>
+    /// top-left fill rule, pixels exactly on an edge only belong to the triangle if it's a top or left edge
+    /// </summary>
+    /// <param name="a">start of edge</param>
+    /// <param name="b">end of edge</param>
+    /// <returns>true if edge is a top or left edge</returns>
+    static bool top_left ( const float *a, const float *b ) noexcept
+    {
+      return ( a[ 1 ] == b[ 1 ] && b[ 0 ] > a[ 0 ] ) || b[ 1 ] < a[ 1 ];
+    }
+
+    /// <summary>
+    /// blends a pixel into the target, SRCALPHA/INVSRCALPHA for colors and INVDESTALPHA/ONE for alpha
+    /// </summary>
+    /// <param name="dst">destination pixel</param>
+    /// <param name="src">source color, bgra in [0, 1]</param>
+    static void blend ( uint32_t &dst, const float *src ) noexcept
+    {
+      const float da = static_cast< float > ( dst >> 24 ) / 255.f;
+      float out[ 4 ];
+
+      for ( int i = 0; i < 3; ++i )
+        out[ i ] = src[ i ] * src[ 3 ] + static_cast< float > ( ( dst >> ( i * 8 ) ) & 0xff ) / 255.f * ( 1.f - src[ 3 ] );
+
+      out[ 3 ] = src[ 3 ] * ( 1.f - da ) + da;
+
+      dst = 0;
+      for ( int i = 0; i < 4; ++i )
+        dst |= static_cast< uint32_t > ( stl::fminf ( stl::fmaxf ( out[ i ], 0.f ), 1.f ) * 255.f + 0.5f ) << ( i * 8 );
+    }
+
+    /// <summary>
+    /// rasterizes a triangle, pixel centers are at integer coordinates like in d3d9
+    /// </summary>
+    /// <param name="v0">first vertex</param>
+    /// <param name="v1">second vertex</param>
+    /// <param name="v2">third vertex</param>
+    /// <param name="texture">texture to modulate with, nullptr for untextured geometry</param>
+    void triangle ( const daisy_vtx_t *v0, const daisy_vtx_t *v1, const daisy_vtx_t *v2, const softtexture_t *texture ) noexcept
+    {
+      float area = edge ( v0->m_pos, v1->m_pos, v2->m_pos[ 0 ], v2->m_pos[ 1 ] );
+      if ( area == 0.f )
+        return;
+
+      // culling is off, wind everything the same way
+      if ( area < 0.f )
+      {
+        const auto swap = v1;
+        v1 = v2;
+        v2 = swap;
+        area = -area;
+      }
+
+      const auto bound = [] ( const float a, const float b, const float c, const bool maxs ) {
+        return static_cast< int32_t > ( maxs ? stl::floorf ( stl::fmaxf ( a, stl::fmaxf ( b, c ) ) ) + 1.f : stl::ceilf ( stl::fminf ( a, stl::fminf ( b, c ) ) ) );
+      };
+
+      int32_t x0 = bound ( v0->m_pos[ 0 ], v1->m_pos[ 0 ], v2->m_pos[ 0 ], false ), x1 = bound ( v0->m_pos[ 0 ], v1->m_pos[ 0 ], v2->m_pos[ 0 ], true );
+      int32_t y0 = bound ( v0->m_pos[ 1 ], v1->m_pos[ 1 ], v2->m_pos[ 1 ], false ), y1 = bound ( v0->m_pos[ 1 ], v1->m_pos[ 1 ], v2->m_pos[ 1 ], true );
+
+      x0 = x0 > this->m_clip[ 0 ] ? x0 : this->m_clip[ 0 ];
+      y0 = y0 > this->m_clip[ 1 ] ? y0 : this->m_clip[ 1 ];
+      x1 = x1 < this->m_clip[ 2 ] ? x1 : this->m_clip[ 2 ];
+      y1 = y1 < this->m_clip[ 3 ] ? y1 : this->m_clip[ 3 ];
+
+      const daisy_vtx_t *vtx[ 3 ] = { v0, v1, v2 };
+      const bool tl[ 3 ] = { top_left ( v1->m_pos, v2->m_pos ), top_left ( v2->m_pos, v0->m_pos ), top_left ( v0->m_pos, v1->m_pos ) };
+
+      for ( int32_t y = y0; y < y1; ++y )
+      {
+        for ( int32_t x = x0; x < x1; ++x )
+        {
+          const float px = static_cast< float > ( x ), py = static_cast< float > ( y );
+          const float w[ 3 ] = { edge ( v1->m_pos, v2->m_pos, px, py ), edge ( v2->m_pos, v0->m_pos, px, py ), edge ( v0->m_pos, v1->m_pos, px, py ) };
+
+          if ( ( w[ 0 ] < 0.f || ( w[ 0 ] == 0.f && !tl[ 0 ] ) ) || ( w[ 1 ] < 0.f || ( w[ 1 ] == 0.f && !tl[ 1 ] ) ) || ( w[ 2 ] < 0.f || ( w[ 2 ] == 0.f && !tl[ 2 ] ) ) )
+            continue;
+
+          // pre-transformed vertices all have rhw 1, so plain (affine) interpolation is exact
+          float col[ 4 ] = { }, uv[ 2 ] = { };
+
+          for ( int i = 0; i < 3; ++i )
+          {
+            const float weight = w[ i ] / area;
+
+            for ( int c = 0; c < 4; ++c )
+              col[ c ] += weight * static_cast< float > ( ( vtx[ i ]->m_col >> ( c * 8 ) ) & 0xff ) / 255.f;
+
+            uv[ 0 ] += weight * vtx[ i ]->m_uv[ 0 ];
+            uv[ 1 ] += weight * vtx[ i ]->m_uv[ 1 ];
+          }
+
+          // D3DTOP_MODULATE, with D3DTADDRESS_WRAP
+          if ( texture && texture->m_pixels && texture->m_width && texture->m_height )
+          {
+            const auto wrap = [] ( const float coord, const uint32_t size ) {
+              const auto texel = static_cast< int64_t > ( stl::floorf ( coord * static_cast< float > ( size ) ) ) % static_cast< int64_t > ( size );
+              return static_cast< uint32_t > ( texel < 0 ? texel + size : texel );
+            };
+
+            const uint32_t texel = texture->m_pixels[ wrap ( uv[ 1 ], texture->m_height ) * texture->m_width + wrap ( uv[ 0 ], texture->m_width ) ];
+
+            for ( int c = 0; c < 4; ++c )
+              col[ c ] *= static_cast< float > ( ( texel >> ( c * 8 ) ) & 0xff ) / 255.f;
+          }
+
+          blend ( this->m_pixels[ y * this->m_width + x ], col );
+        }
+      }
+    }
+
+  public:
+    c_softtarget ( stl::pmr::memory_resource *resource = stl::pmr::get_default_resource ( ) ) noexcept : m_resource ( resource ), m_width ( 0 ), m_height ( 0 ), m_clip { } { }
+
+    // disallow copying
+    c_softtarget ( const c_softtarget & ) = delete;
+    c_softtarget &operator= ( const c_softtarget & ) = delete;
+
+    /// <summary>
+    /// allocates target
+    /// </summary>
+    /// <param name="width">width in pixels</param>
+    /// <param name="height">height in pixels</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t width, const uint32_t height ) noexcept
+    {
+      this->m_pixels = detail::make_buffer< uint32_t > ( this->m_resource, static_cast< size_t > ( width ) * height );
+      if ( !this->m_pixels )
+        return false;
+
+      this->m_width = width;
+      this->m_height = height;
+      this->clear ( );
+
+      return true;
+    }
+
+    /// <summary>
+    /// fills target with a color
+    /// </summary>
+    /// <param name="col">clear color (by default transparent black)</param>
+    void clear ( const color_t col = { 0, 0, 0, 0 } ) noexcept
+    {
+      for ( uint32_t i = 0; i < this->m_width * this->m_height; ++i )
+        this->m_pixels[ i ] = col.bgra;
+    }
+
+    /// <summary>
+    /// rasterizes a drawlist (or c_renderqueue) into the target, the same way flushing it would draw it
+    /// </summary>
+    /// <param name="drawlist">drawlist to draw</param>
+    void draw ( const c_drawlist &drawlist ) noexcept
+    {
+      if ( !this->m_pixels )
+        return;
+
+      this->m_clip[ 0 ] = this->m_clip[ 1 ] = 0;
+      this->m_clip[ 2 ] = static_cast< int32_t > ( this->m_width );
+      this->m_clip[ 3 ] = static_cast< int32_t > ( this->m_height );
+
+      const auto vertices = drawlist.vertices ( );
+      const auto indices = drawlist.indices ( );
+
+      const auto &calls = drawlist.drawcalls ( );
+      const auto kinds = calls.kinds ( );
+      const auto ranges = calls.ranges ( );
+
+      for ( uint32_t i = 0; i < calls.size ( ); ++i )
+      {
+        const auto &range = ranges[ i ];
+
+        switch ( kinds[ i ] )
+        {
+        case daisy_call_kind::CALL_TRI:
+          if ( vertices && indices && range.m_first_vertex + range.m_vertices <= drawlist.vertex_count ( ) && range.m_first_index + range.m_indices <= drawlist.index_count ( ) )
+          {
+            const auto texture = static_cast< const softtexture_t * > ( calls.handles ( )[ i ] );
+            const auto vtx = vertices + range.m_first_vertex;
+
+            for ( uint32_t j = 0; j + 2 < range.m_indices; j += 3 )
+            {
+              const auto idx = indices + range.m_first_index + j;
+
+              if ( idx[ 0 ] < range.m_vertices && idx[ 1 ] < range.m_vertices && idx[ 2 ] < range.m_vertices )
+                this->triangle ( &vtx[ idx[ 0 ] ], &vtx[ idx[ 1 ] ], &vtx[ idx[ 2 ] ], texture );
+            }
+          }
+          break;
+        case daisy_call_kind::CALL_SCISSOR: {
+          point_t position, size;
+          calls.scissor ( i, position, size );
+
+          const int32_t rect[ 4 ] = { static_cast< int32_t > ( position.x ), static_cast< int32_t > ( position.y ), static_cast< int32_t > ( position.x + size.x ),
+                                      static_cast< int32_t > ( position.y + size.y ) };
+          const int32_t limits[ 4 ] = { 0, 0, static_cast< int32_t > ( this->m_width ), static_cast< int32_t > ( this->m_height ) };
+
+          for ( int j = 0; j < 4; ++j )
+            this->m_clip[ j ] = j < 2 ? ( rect[ j ] > limits[ j ] ? rect[ j ] : limits[ j ] ) : ( rect[ j ] < limits[ j ] ? rect[ j ] : limits[ j ] );
+          break;
+        }
+        default:
+          break;
+        }
+      }
+    }
+
+    /// <summary>
+    /// compares target against a reference image of the same size
+    /// </summary>
+    /// <param name="reference">reference pixels, bgra</param>
+    /// <param name="tolerance">largest per channel difference that still counts as equal</param>
+    /// <returns>number of pixels that differ by more than tolerance in any channel</returns>
+    uint32_t compare ( const uint32_t *reference, const uint8_t tolerance = 0 ) const noexcept
+    {
+      uint32_t mismatches = 0;
+
+      for ( uint32_t i = 0; i < this->m_width * this->m_height; ++i )
+      {
+        for ( int c = 0; c < 4; ++c )
+        {
+          const int32_t a = ( this->m_pixels[ i ] >> ( c * 8 ) ) & 0xff, b = ( reference[ i ] >> ( c * 8 ) ) & 0xff;
+
+          if ( a - b > tolerance || b - a > tolerance )
+          {
+            ++mismatches;
+            break;
+          }
+        }
+      }
+
+      return mismatches;
+    }
+
+    /// <summary>
+    /// get pixels of target
+    /// </summary>
+    /// <returns>pixels, bgra and row by row without padding</returns>
+    const uint32_t *pixels ( ) const noexcept
+    {
+      return this->m_pixels.get ( );
+    }
+
+    /// <summary>
+    /// get width of target
+    /// </summary>
+    /// <returns>width in pixels</returns>
+    uint32_t width ( ) const noexcept
+    {
+      return this->m_width;
+    }
+
+    /// <summary>
+    /// get height of target
+    /// </summary>
+    /// <returns>height in pixels</returns>
+    uint32_t height ( ) const noexcept
+    {
+      return this->m_height;
+    }
+  };
+
+  // lets several threads push into one drawlist at once (eg. jobs emitting geometry for a shared HUD queue). producers reserve a lane with an
+  // atomic bump, fill it like any other drawlist without locking and commit it. once every producer of the frame is done, resolve() appends
+  // the committed lanes to the target in the order of the sequence keys they were reserved with, so the result doesn't depend on thread timing
+  // as long as keys are unique. lanes keep their buffers across frames, so steady state frames don't allocate
+  class c_drawlanes
+  {
+  private:
+    struct lane_t
+    {
+      // lets the lane vector hand its resource down to the drawlists
+      using allocator_type = stl::pmr::polymorphic_allocator< uint8_t >;
+
+      c_drawlist m_list;
+      uint64_t m_key;
+
+      lane_t ( const allocator_type &allocator ) noexcept : m_list ( allocator.resource ( ) ), m_key ( 0 ) { }
+    };
+
+    stl::pmr::vector< lane_t > m_lanes;
+
+    // order of lanes built by resolve()
+    stl::pmr::vector< uint32_t > m_order;
+
+    // lanes handed out (can go past the lane count when we run out) and lanes committed this frame
+    stl::atomic< uint32_t > m_reserved, m_committed;
+
+  public:
+    c_drawlanes ( stl::pmr::memory_resource *resource = stl::pmr::get_default_resource ( ) ) noexcept : m_lanes ( resource ), m_order ( resource ), m_reserved ( 0 ), m_committed ( 0 ) { }
+
+    // disallow copying
+    c_drawlanes ( const c_drawlanes & ) = delete;
+    c_drawlanes &operator= ( const c_drawlanes & ) = delete;
+
+    /// <summary>
+    /// allocates lanes, not thread safe
+    /// </summary>
+    /// <param name="lanes">max number of reservations per frame</param>
+    /// <param name="max_verts">initial vertex capacity of each lane</param>
+    /// <param name="max_indices">initial index capacity of each lane</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t lanes = 16, const uint32_t max_verts = 4096, const uint32_t max_indices = 8192 ) noexcept
+    {
+      try
+      {
+        stl::pmr::vector< lane_t > created ( lanes, this->m_lanes.get_allocator ( ) );
+
+        for ( auto &lane : created )
+          if ( !lane.m_list.create ( max_verts, max_indices ) )
+            return false;
+
+        this->m_order.reserve ( lanes );
+        this->m_lanes.swap ( created );
+      }
+      catch ( ... )
+      {
+        return false;
+      }
+
+      this->m_reserved = this->m_committed = 0;
+
+      return true;
+    }
+
+    /// <summary>
+    /// reserves an empty lane, thread safe. the lane belongs to the calling producer until it commits it. it starts out like a new drawlist
+    /// (sort key 0, no cull rect), whatever the previous producer set doesn't carry over
+    /// </summary>
+    /// <param name="key">sequence key deciding where the lane ends up in the target, keys should be unique within a frame</param>
+    /// <returns>lane to push to, nullptr if all lanes of this frame are taken</returns>
+    c_drawlist *reserve ( const uint64_t key ) noexcept
+    {
+      const uint32_t index = this->m_reserved.fetch_add ( 1, stl::memory_order_relaxed );
+      if ( index >= this->m_lanes.size ( ) )
+        return nullptr;
+
+      auto &lane = this->m_lanes[ index ];
+      lane.m_list.clear ( );
+      lane.m_list.set_sort_key ( 0 );
+      lane.m_list.reset_cull_rect ( );
+      lane.m_key = key;
+
+      return &lane.m_list;
+    }
+
+    /// <summary>
+    /// marks a reserved lane as filled, thread safe. the producer mustn't touch the lane afterwards
+    /// </summary>
+    void commit ( ) noexcept
+    {
+      this->m_committed.fetch_add ( 1, stl::memory_order_release );
+    }
+
+    /// <summary>
+    /// appends committed lanes to a drawlist ordered by their keys and starts a new frame, not thread safe. lanes sharing a key end up in
+    /// the order they were reserved in, which depends on thread timing, so keys have to be unique for the result to be deterministic
+    /// </summary>
+    /// <param name="target">drawlist (eg. a c_renderqueue) to append to, usually cleared before</param>
+    /// <returns>
+    /// true on success. false if a reserved lane wasn't committed yet (nothing is appended then) or the target couldn't hold a lane (lanes
+    /// before it stay appended). the frame isn't started over on failure, so the lanes can be resolved again (eg. into a cleared target)
+    /// </returns>
+    [[nodiscard]] bool resolve ( c_drawlist &target ) noexcept
+    {
+      const uint32_t committed = this->m_committed.load ( stl::memory_order_acquire );
+      const uint32_t reserved = this->m_reserved.load ( stl::memory_order_relaxed );
+      const uint32_t lanes = reserved < this->m_lanes.size ( ) ? reserved : static_cast< uint32_t > ( this->m_lanes.size ( ) );
+
+      if ( committed != lanes )
+        return false;
+
+      // create() reserves the order for every lane, so this only allocates if that failed
+      try
+      {
+        this->m_order.resize ( lanes );
+      }
+      catch ( ... )
+      {
+        return false;
+      }
+
+      for ( uint32_t i = 0; i < lanes; ++i )
+        this->m_order[ i ] = i;
+
+      // ties are broken by reservation order, that's the only thing depending on timing and why keys should be unique
+
+      stl::sort ( this->m_order.begin ( ), this->m_order.end ( ), [ this ] ( const uint32_t a, const uint32_t b ) {
+        return this->m_lanes[ a ].m_key < this->m_lanes[ b ].m_key || ( this->m_lanes[ a ].m_key == this->m_lanes[ b ].m_key && a < b );
+      } );
+
+      for ( const auto index : this->m_order )
+        if ( !target.append ( this->m_lanes[ index ].m_list ) )
+          return false;
+
+      this->m_reserved.store ( 0, stl::memory_order_relaxed );
+      this->m_committed.store ( 0, stl::memory_order_relaxed );
+
+      return true;
+    }
+
+    /// <summary>
+    /// get number of lanes
+    /// </summary>
+    /// <returns>lane count</returns>
+    uint32_t lanes ( ) const noexcept
+    {
+      return static_cast< uint32_t > ( this->m_lanes.size ( ) );
+    }
+  };
+
+#ifndef DAISY_NO_D3D9
+  class c_daisy_context;
+
+  class c_daisy_resettable_object
+  {
+  protected:
+    // context the object was created in, it creates all of its d3d9 resources on that context's device
+    c_daisy_context *m_context;
+
+  public:
+    c_daisy_resettable_object ( c_daisy_context &context ) noexcept : m_context ( &context ) { }
+
+    /// <summary>
+    /// called on device reset (pre/post)
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    virtual bool reset ( bool pre_reset = false ) noexcept = 0;
+
+    /// <summary>
+    /// get context the object was created in
+    /// </summary>
+    /// <returns>context</returns>
+    c_daisy_context &context ( ) const noexcept
+    {
+      return *this->m_context;
+    }
+  };
+
+  // everything daisy needs to know about one d3d9 device. objects are bound to a context when they're constructed, so devices living on
+  // their own render threads (eg. separate windows or adapters) can be driven in parallel, as long as each context is only used by its own thread
+  class c_daisy_context
+  {
+  private:
+    IDirect3DDevice9 *m_device;
+
+    // queried once on creation, objects check these instead of asking the device every time they're (re)created
+    D3DCAPS9 m_caps;
+
+    // objects created in this context allocate from here, unless they're given a resource of their own
+    stl::pmr::memory_resource *m_resource;
+
+    // objects reset by reset(), in the order they were tracked
+    stl::pmr::vector< c_daisy_resettable_object * > m_objects;
+
+  public:
+    c_daisy_context ( stl::pmr::memory_resource *resource = stl::pmr::get_default_resource ( ) ) noexcept : m_device ( nullptr ), m_caps { }, m_resource ( resource ), m_objects ( resource ) { }
+
+    // disallow copying
+    c_daisy_context ( const c_daisy_context & ) = delete;
+    c_daisy_context &operator= ( const c_daisy_context & ) = delete;
+
+    /// <summary>
+    /// binds context to a device. can be called again after a device reset, to update the device pointer
+    /// </summary>
+    /// <param name="device">d3d9 device handle</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( IDirect3DDevice9 *device ) noexcept
+    {
+      if ( !device )
+        return false;
+
+      device->AddRef ( );
+      this->release ( );
+
+      this->m_device = device;
+
+      return this->m_device->GetDeviceCaps ( &this->m_caps ) == D3D_OK;
+    }
+
+    /// <summary>
+    /// drops our reference to the device
+    /// </summary>
+    void release ( ) noexcept
+    {
+      if ( this->m_device )
+      {
+        this->m_device->Release ( );
+        this->m_device = nullptr;
+      }
+    }
+
+    /// <summary>
+    /// prepares render state for daisy
+    /// </summary>
+    void prepare ( ) noexcept
+    {
+      if ( !this->m_device )
+        return;
+
+      this->m_device->SetRenderState ( D3DRS_ZENABLE, FALSE );
+      this->m_device->SetRenderState ( D3DRS_ALPHABLENDENABLE, TRUE );
+      this->m_device->SetRenderState ( D3DRS_SRCBLEND, D3DBLEND_SRCALPHA );
+      this->m_device->SetRenderState ( D3DRS_SRCBLENDALPHA, D3DBLEND_INVDESTALPHA );
+      this->m_device->SetRenderState ( D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA );
+      this->m_device->SetRenderState ( D3DRS_DESTBLENDALPHA, D3DBLEND_ONE );
+      this->m_device->SetRenderState ( D3DRS_ALPHATESTENABLE, FALSE );
+      this->m_device->SetRenderState ( D3DRS_SEPARATEALPHABLENDENABLE, TRUE );
+      this->m_device->SetRenderState ( D3DRS_ALPHAREF, 0x08 );
+      this->m_device->SetRenderState ( D3DRS_ALPHAFUNC, D3DCMP_GREATEREQUAL );
+      this->m_device->SetRenderState ( D3DRS_LIGHTING, FALSE );
+      this->m_device->SetRenderState ( D3DRS_FILLMODE, D3DFILL_SOLID );
+      this->m_device->SetRenderState ( D3DRS_CULLMODE, D3DCULL_NONE );
+      this->m_device->SetRenderState ( D3DRS_SCISSORTESTENABLE, TRUE );
+      this->m_device->SetRenderState ( D3DRS_ZWRITEENABLE, FALSE );
+      this->m_device->SetRenderState ( D3DRS_STENCILENABLE, FALSE );
+      this->m_device->SetRenderState ( D3DRS_CLIPPING, TRUE );
+      this->m_device->SetRenderState ( D3DRS_CLIPPLANEENABLE, FALSE );
+      this->m_device->SetRenderState ( D3DRS_VERTEXBLEND, D3DVBF_DISABLE );
+      this->m_device->SetRenderState ( D3DRS_INDEXEDVERTEXBLENDENABLE, FALSE );
+      this->m_device->SetRenderState ( D3DRS_FOGENABLE, FALSE );
+      this->m_device->SetRenderState ( D3DRS_SRGBWRITEENABLE, FALSE );
+      this->m_device->SetRenderState ( D3DRS_COLORWRITEENABLE, D3DCOLORWRITEENABLE_RED | D3DCOLORWRITEENABLE_GREEN | D3DCOLORWRITEENABLE_BLUE | D3DCOLORWRITEENABLE_ALPHA );
+      this->m_device->SetRenderState ( D3DRS_ANTIALIASEDLINEENABLE, FALSE );
+
+      this->m_device->SetTextureStageState ( 0, D3DTSS_COLOROP, D3DTOP_MODULATE );
+      this->m_device->SetTextureStageState ( 0, D3DTSS_COLORARG1, D3DTA_TEXTURE );
+      this->m_device->SetTextureStageState ( 0, D3DTSS_COLORARG2, D3DTA_DIFFUSE );
+      this->m_device->SetTextureStageState ( 0, D3DTSS_ALPHAOP, D3DTOP_MODULATE );
+      this->m_device->SetTextureStageState ( 0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE );
+      this->m_device->SetTextureStageState ( 0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE );
+      this->m_device->SetTextureStageState ( 0, D3DTSS_TEXCOORDINDEX, 0 );
+      this->m_device->SetTextureStageState ( 0, D3DTSS_TEXTURETRANSFORMFLAGS, D3DTTFF_DISABLE );
+      this->m_device->SetTextureStageState ( 1, D3DTSS_COLOROP, D3DTOP_DISABLE );
+      this->m_device->SetTextureStageState ( 1, D3DTSS_ALPHAOP, D3DTOP_DISABLE );
+
+      this->m_device->SetSamplerState ( 0ul, D3DSAMP_ADDRESSU, D3DTADDRESS_WRAP );
+      this->m_device->SetSamplerState ( 0ul, D3DSAMP_ADDRESSV, D3DTADDRESS_WRAP );
+      this->m_device->SetSamplerState ( 0ul, D3DSAMP_ADDRESSW, D3DTADDRESS_WRAP );
+      this->m_device->SetSamplerState ( 0, D3DSAMP_MINFILTER, D3DTEXF_PYRAMIDALQUAD );
+      this->m_device->SetSamplerState ( 0, D3DSAMP_MAGFILTER, D3DTEXF_PYRAMIDALQUAD );
+      this->m_device->SetSamplerState ( 0, D3DSAMP_MIPFILTER, D3DTEXF_PYRAMIDALQUAD );
+
+      this->m_device->SetVertexShader ( nullptr );
+      this->m_device->SetPixelShader ( nullptr );
+    }
+
+    /// <summary>
+    /// adds an object to the ones reset by reset(). objects that depend on others (eg. queues created in a c_bufferpool) should be tracked after them
+    /// </summary>
+    /// <param name="object">object to track, has to be untracked before it's destroyed</param>
+    void track ( c_daisy_resettable_object &object ) noexcept
+    {
+      this->m_objects.push_back ( &object );
+    }
+
+    /// <summary>
+    /// removes an object from the ones reset by reset()
+    /// </summary>
+    /// <param name="object">tracked object</param>
+    void untrack ( c_daisy_resettable_object &object ) noexcept
+    {
+      for ( size_t i = 0; i < this->m_objects.size ( ); ++i )
+      {
+        if ( this->m_objects[ i ] == &object )
+        {
+          this->m_objects.erase ( this->m_objects.begin ( ) + i );
+          return;
+        }
+      }
+    }
+
+    /// <summary>
+    /// resets all tracked objects (pre/post). pre-reset goes through them in reverse order, so objects are released before what they depend on
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true if all objects were reset successfully, false otherwise</returns>
+    bool reset ( bool pre_reset = false ) noexcept
+    {
+      bool result = true;
+
+      if ( pre_reset )
+      {
+        for ( size_t i = this->m_objects.size ( ); i > 0; --i )
+          result &= this->m_objects[ i - 1 ]->reset ( true );
+      }
+      else
+      {
+        for ( const auto object : this->m_objects )
+          result &= object->reset ( false );
+      }
+
+      return result;
+    }
+
+    /// <summary>
+    /// sets memory resource of objects created in this context from now on. objects that already exist keep allocating from the old one.
+    /// fonts prepared with prepare_async allocate from it on another thread, so it has to be thread safe if they're used
+    /// </summary>
+    /// <param name="resource">memory resource, has to outlive every object allocating from it</param>
+    void set_resource ( stl::pmr::memory_resource *resource ) noexcept
+    {
+      this->m_resource = resource;
+    }
+
+    // getters
+
+    /// <summary>
+    /// get memory resource objects created in this context allocate from
+    /// </summary>
+    /// <returns>memory resource</returns>
+    stl::pmr::memory_resource *resource ( ) const noexcept
+    {
+      return this->m_resource;
+    }
+
+    /// <summary>
+    /// get device of context
+    /// </summary>
+    /// <returns>d3d9 device handle, nullptr if context wasn't created</returns>
+    IDirect3DDevice9 *device ( ) const noexcept
+    {
+      return this->m_device;
+    }
+
+    /// <summary>
+    /// get capabilities of device
+    /// </summary>
+    /// <returns>device caps</returns>
+    const D3DCAPS9 &caps ( ) const noexcept
+    {
+      return this->m_caps;
+    }
+  };
+
+  // the only global object, it's the context objects are bound to unless they're given another one. the daisy_* functions operate on it
+  struct daisy_t
+  {
+    static inline c_daisy_context s_context;
+  };
+
+  // our font wrapper class
+  class c_fontwrapper : public c_daisy_resettable_object
+  {
+  private:
+    // members
+    stl::pmr::unordered_map< wchar_t, uv_t > m_coords;
+    stl::string_view m_family;
+    IDirect3DTexture9 *m_texture_handle;
+    float m_scale;
+    uint32_t m_width, m_height, m_spacing, m_size, m_quality;
+    uint8_t m_flags;
+
+    // rasterized glyphs (A4R4G4B4), kept between prepare() and finalize()
+    detail::resource_buffer_t< uint16_t > m_staging;
+
+    // glyphs are only looked up once the font is ready, so a font that's being prepared on another thread can already be pushed with (it just draws nothing)
+    stl::atomic< daisy_font_state > m_state;
+
+  private:
+    // methods
+    /// <summary>
+    /// actually creates font instance and atlas
+    /// </summary>
+    /// <returns>true on succesful font creation, false otherwise</returns>
+    bool create_ex ( ) noexcept
+    {
+      if ( !this->m_context->device ( ) )
+        return false;
+
+      this->m_state = daisy_font_state::FONT_STATE_PREPARING;
+      this->m_state = this->rasterize ( this->m_context->caps ( ).MaxTextureWidth ) && this->upload ( ) ? daisy_font_state::FONT_STATE_READY : daisy_font_state::FONT_STATE_FAILED;
+
+      return this->m_state == daisy_font_state::FONT_STATE_READY;
+    }
+
+    /// <summary>
+    /// lays out and paints glyphs into the staging bitmap. only uses GDI and doesn't touch the context, so it can run on any thread
+    /// </summary>
+    /// <param name="max_width">largest texture width the atlas may use</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool rasterize ( const uint32_t max_width ) noexcept
+    {
+      this->m_staging.reset ( );
+
+      if ( !max_width )
+        return false;
+
+      // create GDI context
+      HDC gdi_ctx = CreateCompatibleDC ( nullptr );
+      if ( !gdi_ctx )
+        return false;
+
+      HGDIOBJ gdi_font = nullptr, prev_gdi_font = nullptr;
+      SetMapMode ( gdi_ctx, MM_TEXT );
+
+      // create GDI font
+      this->create_gdi_font ( gdi_ctx, &gdi_font );
+
+      prev_gdi_font = SelectObject ( gdi_ctx, gdi_font );
+
+      // set default atlas size
+      this->m_width = this->m_height = 128;
+
+      // ensure our atlas is big enough
+      while ( this->paint_or_measure_alphabet ( gdi_ctx, true ) == 2 )
+      {
+        this->m_width *= 2;
+        this->m_height *= 2;
+      }
+
+      // ensure our atlas isn't above max texture cap
+      // @todo; use texatlas
+      if ( this->m_width > max_width )
+      {
+        this->m_scale = static_cast< float > ( max_width ) / this->m_width;
+        this->m_width = this->m_height = max_width;
+
+        bool first_iteration = true;
+
+        do
+        {
+          if ( !first_iteration )
+            this->m_scale *= 0.9f;
+
+          DeleteObject ( SelectObject ( gdi_ctx, prev_gdi_font ) );
+
+          this->create_gdi_font ( gdi_ctx, &gdi_font );
+
+          prev_gdi_font = SelectObject ( gdi_ctx, gdi_font );
+
+          first_iteration = false;
+        } while ( this->paint_or_measure_alphabet ( gdi_ctx, true ) == 2 );
+      }
+
+      DWORD *bitmap_bits = nullptr;
+
+      BITMAPINFO bitmap_ctx { };
+      bitmap_ctx.bmiHeader.biSize = sizeof ( BITMAPINFOHEADER );
+      bitmap_ctx.bmiHeader.biWidth = this->m_width;
+      bitmap_ctx.bmiHeader.biHeight = -static_cast< int32_t > ( this->m_height );
+      bitmap_ctx.bmiHeader.biPlanes = 1;
+      bitmap_ctx.bmiHeader.biCompression = BI_RGB;
+      bitmap_ctx.bmiHeader.biBitCount = 32;
+
+      bool result = false;
+
+      HBITMAP bitmap = CreateDIBSection ( gdi_ctx, &bitmap_ctx, DIB_RGB_COLORS, reinterpret_cast< void ** > ( &bitmap_bits ), nullptr, 0 );
+      if ( bitmap )
+      {
+        HGDIOBJ prev_bitmap = SelectObject ( gdi_ctx, bitmap );
+
+        SetTextColor ( gdi_ctx, RGB ( 255, 255, 255 ) );
+        SetBkColor ( gdi_ctx, 0x00000000 );
+        SetTextAlign ( gdi_ctx, TA_TOP );
+
+        // to note: paint_alphabet returns 0 on success
+        if ( !this->paint_or_measure_alphabet ( gdi_ctx, false ) )
+          this->m_staging = detail::make_buffer< uint16_t > ( this->m_context->resource ( ), this->m_width * this->m_height );
+
+        if ( this->m_staging )
+        {
+          uint16_t *dst = this->m_staging.get ( );
+          BYTE alpha;
+
+          // convert to texture format
+          for ( uint32_t y = 0; y < this->m_height; y++ )
+          {
+            for ( uint32_t x = 0; x < this->m_width; x++ )
+            {
+              alpha = ( ( bitmap_bits[ this->m_width * y + x ] & 0xff ) >> 4 );
+              if ( alpha > 0 )
+              {
+                *dst++ = ( ( alpha << 12 ) | 0x0fff );
+              }
+              else
+              {
+                *dst++ = 0x0000;
+              }
+            }
+          }
+
+          result = true;
+        }
+
+        SelectObject ( gdi_ctx, prev_bitmap );
+        DeleteObject ( bitmap );
+      }
+
+      // clean up, every exit past creating the GDI context goes through here
+      SelectObject ( gdi_ctx, prev_gdi_font );
+      DeleteObject ( gdi_font );
+      DeleteDC ( gdi_ctx );
+
+      return result;
+    }
+
+    /// <summary>
+    /// creates texture and copies the staging bitmap to it, has to run on the render thread
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool upload ( ) noexcept
+    {
+      if ( !this->m_context->device ( ) || !this->m_staging )
+        return false;
+
+      // prepared fonts were laid out for the caps known when preparing started, the device may have changed since
+      if ( this->m_width > static_cast< uint32_t > ( this->m_context->caps ( ).MaxTextureWidth ) || this->m_height > static_cast< uint32_t > ( this->m_context->caps ( ).MaxTextureHeight ) )
+        return false;
+
+      // function could be possibly called by reset handler
+      if ( this->m_texture_handle )
+      {
+        this->m_texture_handle->Release ( );
+        this->m_texture_handle = nullptr;
+      }
+
+      // create dx9 tex
+      HRESULT res = this->m_context->device ( )->CreateTexture ( this->m_width, this->m_height, 1, D3DUSAGE_DYNAMIC, D3DFMT_A4R4G4B4, D3DPOOL_DEFAULT, &this->m_texture_handle, nullptr );
+      if ( res != D3D_OK || !this->m_texture_handle )
+        return false;
+
+      D3DLOCKED_RECT locked_rect;
+      if ( this->m_texture_handle->LockRect ( 0, &locked_rect, nullptr, 0 ) != D3D_OK )
+        return false;
+
+      uint8_t *dst_row = static_cast< uint8_t * > ( locked_rect.pBits );
+
+      // write to texture
+      for ( uint32_t y = 0; y < this->m_height; y++ )
+      {
+        memcpy ( dst_row, this->m_staging.get ( ) + this->m_width * y, sizeof ( uint16_t ) * this->m_width );
+        dst_row += locked_rect.Pitch;
+      }
+
+      if ( this->m_texture_handle->UnlockRect ( 0 ) != D3D_OK )
+        return false;
+
+      // resets rasterize again, no need to hold on to it
+      this->m_staging.reset ( );
+
+      return true;
+    }
+
+    /// <summary>
+    /// creates GDI font
+    /// </summary>
+    /// <param name="context">GDI context</param>
+    /// <param name="gdi_font">font GDI object</param>
+    void create_gdi_font ( HDC context, HGDIOBJ *gdi_font ) noexcept
+    {
+      *gdi_font = CreateFontA ( -MulDiv ( this->m_size, static_cast< int > ( GetDeviceCaps ( context, LOGPIXELSY ) * this->m_scale ), 72 ),
+                                0, 0, 0, ( this->m_flags & daisy_font_flags::FONT_BOLD ) ? FW_BOLD : FW_NORMAL, ( this->m_flags & daisy_font_flags::FONT_ITALIC ) ? TRUE : FALSE,
+                                FALSE, FALSE, DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, this->m_quality, VARIABLE_PITCH, this->m_family.data ( ) );
+    }
+
+    /// <summary>
+    /// measures or paints alphabet
+    /// </summary>
+    /// <param name="context">GDI context</param>
+    /// <param name="measure">if we should only measure, not paint alphabet</param>
+    /// <returns>0 on success, 1 on GDI error, 2 if texture atlas can't contain our glyphs</returns>
+    int paint_or_measure_alphabet ( HDC context, bool measure = false ) noexcept
+    {
+      SIZE size;
+      wchar_t chr[] = L"x\0\0";
+
+      if ( !GetTextExtentPoint32W ( context, chr, 1, &size ) )
+        return 1;
+
+      // thanks dex for help with this
+      const auto unicode_ranges_size = GetFontUnicodeRanges ( context, nullptr );
+      if ( !unicode_ranges_size )
+        return 1;
+
+      auto glyph_sets_memory = detail::make_buffer< uint8_t > ( this->m_context->resource ( ), unicode_ranges_size );
+      if ( !glyph_sets_memory )
+        return 1;
+
+      auto glyph_sets = reinterpret_cast< GLYPHSET * > ( glyph_sets_memory.get ( ) );
+
+      if ( !GetFontUnicodeRanges ( context, glyph_sets ) )
+        return 1;
+
+      this->m_spacing = static_cast< uint32_t > ( ceil ( size.cy * 0.3f ) );
+
+      uint32_t x = this->m_spacing;
+      uint32_t y = 0;
+
+      // iterate glyph ranges
+      for ( uint32_t r = 0; r < glyph_sets->cRanges; ++r )
+      {
+        // iterate glyphs
+        for ( auto ch = glyph_sets->ranges[ r ].wcLow; ch < ( glyph_sets->ranges[ r ].wcLow + glyph_sets->ranges[ r ].cGlyphs ); ++ch )
+        {
+          // get metrics of the current character
+          if ( !GetTextExtentPoint32W ( context, &ch, 1, &size ) )
+            continue;
+
+          if ( x + size.cx + this->m_spacing > this->m_width )
+          {
+            x = this->m_spacing;
+            y += size.cy + 1;
+          }
+
+          // ran out of space in texture
+          if ( y + size.cy > this->m_height )
+            return 2;
+
+          if ( !measure )
+          {
+            if ( !ExtTextOutW ( context, x + 0, y + 0, ETO_OPAQUE, nullptr, &ch, 1, nullptr ) )
+              return 1;
+
+            this->m_coords[ static_cast< uint16_t > ( ch ) ][ 0 ] = ( static_cast< float > ( x + 0 - this->m_spacing ) ) / this->m_width;
+            this->m_coords[ static_cast< uint16_t > ( ch ) ][ 1 ] = ( static_cast< float > ( y + 0 + 0 ) ) / this->m_height;
+            this->m_coords[ static_cast< uint16_t > ( ch ) ][ 2 ] = ( static_cast< float > ( x + size.cx + this->m_spacing ) ) / this->m_width;
+            this->m_coords[ static_cast< uint16_t > ( ch ) ][ 3 ] = ( static_cast< float > ( y + size.cy + 0 ) ) / this->m_height;
+          }
+
+          x += size.cx + ( 2 * this->m_spacing );
+        }
+      }
+
+      return 0;
+    }
+
+  public:
+    // inits everything with 0
+    c_fontwrapper ( c_daisy_context &context = daisy_t::s_context ) noexcept
+        : c_daisy_resettable_object ( context ), m_coords ( context.resource ( ) ), m_family ( ), m_texture_handle ( nullptr ), m_scale ( 0.f ), m_width ( 0 ), m_height ( 0 ), m_spacing ( 0 ), m_size ( 0 ), m_quality ( NONANTIALIASED_QUALITY ), m_flags ( 0 ),
+          m_state ( daisy_font_state::FONT_STATE_EMPTY )
+    {
+    }
+
+    // disallow copying
+    c_fontwrapper ( const c_fontwrapper & ) = delete;
+    c_fontwrapper &operator= ( const c_fontwrapper & ) = delete;
+
+    /// <summary>
+    /// creates font instance and atlas
+    /// </summary>
+    /// <param name="family">font family name, for example "Arial" (to note; fonts added by AddFontMemResourceEx also work)</param>
+    /// <param name="height">font height</param>
+    /// <param name="quality">font quality (NONANTIALIASED_QUALITY, CLEARTYPE_NATURAL_QUALITY etc.)</param>
+    /// <param name="flags">font flags (see enum daisy_font_flags; FONT_DEFAULT, FONT_BOLD, FONT_ITALIC)</param>
+    /// <returns>true on succesful font creation, false otherwise</returns>
+    [[nodiscard]] bool create ( const stl::string_view family, uint32_t height, uint32_t quality, uint8_t flags ) noexcept
+    {
+      this->m_family = family;
+      this->m_size = height;
+      this->m_flags = flags;
+      this->m_quality = quality;
+      this->m_scale = 1.f;
+      this->m_spacing = 0;
+
+      return this->create_ex ( );
+    }
+
+    /// <summary>
+    /// first half of create, rasterizes the font without touching the device so it can run on a worker thread. finalize() has to be
+    /// called on the render thread afterwards. only works on fonts that are empty (or failed), the render thread must not create, reset
+    /// or erase the font while it's being prepared
+    /// </summary>
+    /// <param name="family">font family name, for example "Arial" (has to stay alive until the font is erased)</param>
+    /// <param name="height">font height</param>
+    /// <param name="quality">font quality (NONANTIALIASED_QUALITY, CLEARTYPE_NATURAL_QUALITY etc.)</param>
+    /// <param name="flags">font flags (see enum daisy_font_flags; FONT_DEFAULT, FONT_BOLD, FONT_ITALIC)</param>
+    /// <param name="max_width">largest texture width the atlas may use, read from the context's caps on the render thread beforehand.
+    /// finalize() fails if the device can't create a texture that big</param>
+    /// <returns>true if the font is ready to be finalized, false otherwise</returns>
+    [[nodiscard]] bool prepare ( const stl::string_view family, uint32_t height, uint32_t quality, uint8_t flags, const uint32_t max_width = 4096 ) noexcept
+    {
+      auto state = this->m_state.load ( );
+      if ( ( state != daisy_font_state::FONT_STATE_EMPTY && state != daisy_font_state::FONT_STATE_FAILED ) ||
+           !this->m_state.compare_exchange_strong ( state, daisy_font_state::FONT_STATE_PREPARING ) )
+        return false;
+
+      this->m_family = family;
+      this->m_size = height;
+      this->m_flags = flags;
+      this->m_quality = quality;
+      this->m_scale = 1.f;
+      this->m_spacing = 0;
+
+      const bool result = this->rasterize ( max_width );
+
+      this->m_state = result ? daisy_font_state::FONT_STATE_PREPARED : daisy_font_state::FONT_STATE_FAILED;
+
+      return result;
+    }
+
+    /// <summary>
+    /// runs prepare() asynchronously. has to be called on the render thread, the caps of the device are read before the worker starts
+    /// </summary>
+    /// <param name="family">font family name, for example "Arial" (has to stay alive until the font is erased)</param>
+    /// <param name="height">font height</param>
+    /// <param name="quality">font quality (NONANTIALIASED_QUALITY, CLEARTYPE_NATURAL_QUALITY etc.)</param>
+    /// <param name="flags">font flags (see enum daisy_font_flags; FONT_DEFAULT, FONT_BOLD, FONT_ITALIC)</param>
+    /// <returns>future holding the result of prepare(), the font has to outlive it. invalid if no thread could be started</returns>
+    stl::future< bool > prepare_async ( const stl::string_view family, uint32_t height, uint32_t quality, uint8_t flags ) noexcept
+    {
+      const uint32_t max_width = this->m_context->device ( ) ? static_cast< uint32_t > ( this->m_context->caps ( ).MaxTextureWidth ) : 0;
+
+      // std::async throws if the thread can't be started (or its state can't be allocated)
+      try
+      {
+        return stl::async ( stl::launch::async, [ this, family, height, quality, flags, max_width ] ( ) { return this->prepare ( family, height, quality, flags, max_width ); } );
+      }
+      catch ( ... )
+      {
+        return { };
+      }
+    }
+
+    /// <summary>
+    /// second half of create, uploads a prepared font. cheap if there's nothing to do, so it can be called every frame until the font is ready
+    /// </summary>
+    /// <returns>true if the font is ready, false otherwise (still preparing or failed)</returns>
+    bool finalize ( ) noexcept
+    {
+      switch ( this->m_state.load ( ) )
+      {
+      case daisy_font_state::FONT_STATE_READY:
+        return true;
+      case daisy_font_state::FONT_STATE_PREPARED:
+        this->m_state = this->upload ( ) ? daisy_font_state::FONT_STATE_READY : daisy_font_state::FONT_STATE_FAILED;
+        return this->m_state == daisy_font_state::FONT_STATE_READY;
+      default:
+        return false;
+      }
+    }
+
+    /// <summary>
+    /// returns measured text extent in pixels
+    /// </summary>
+    /// <typeparam name="t">iteratable text container (only char and wchar_t accepted currently)</typeparam>
+    /// <param name="text">text to measure</param>
+    /// <returns>point_t containing width and height of measured text</returns>
+    template < typename t = stl::string_view >
+    point_t text_extent ( t text ) noexcept
+    {
+      if ( !this->ready ( ) )
+        return { 0.f, 0.f };
+
+      float row_width = 0.f;
+      float row_height = ( this->m_coords[ static_cast< wchar_t > ( 32 ) ][ 3 ] - this->m_coords[ static_cast< wchar_t > ( 32 ) ][ 1 ] ) * this->m_height;
+      float width = 0.f;
+      float height = row_height;
+
+      for ( const auto c : text )
+      {
+        if ( c == '\n' )
+        {
+          row_width = 0.f;
+          height += row_height;
+        }
+
+        if ( c < ' ' )
+          continue;
+
+        float tx1 = this->m_coords[ static_cast< wchar_t > ( c ) ][ 0 ];
+        float tx2 = this->m_coords[ static_cast< wchar_t > ( c ) ][ 2 ];
+
+        row_width += ( tx2 - tx1 ) * this->m_width - 2.f * this->m_spacing;
+
+        if ( row_width > width )
+          width = row_width;
+      }
+
+      return { width, height };
+    }
+
+    /// <summary>
+    /// lays out text and calls a function for each visible glyph
+    /// </summary>
+    /// <typeparam name="t">iteratable text container (only char and wchar_t accepted currently)</typeparam>
+    /// <typeparam name="fn_t">callable taking (const point_t &amp;position, const point_t &amp;size, const uv_t &amp;coords)</typeparam>
+    /// <param name="position">position of text</param>
+    /// <param name="text">text to lay out</param>
+    /// <param name="alignment">alignment of text</param>
+    /// <param name="fn">function called for each glyph</param>
+    template < typename t = stl::string_view, typename fn_t >
+    void for_each_glyph ( const point_t &position, const t text, uint16_t alignment, fn_t &&fn ) noexcept
+    {
+      if ( !this->ready ( ) )
+        return;
+
+      point_t corrected_position { position };
+
+      if ( alignment != TEXT_ALIGN_DEFAULT )
+      {
+        const auto size = this->text_extent ( text );
+
+        if ( alignment & TEXT_ALIGNX_CENTER )
+          corrected_position.x -= stl::floorf ( 0.5f * size.x );
+        else if ( alignment & TEXT_ALIGNX_RIGHT )
+          corrected_position.x -= stl::floorf ( size.x );
+
+        if ( alignment & TEXT_ALIGNY_CENTER )
+          corrected_position.y -= stl::floorf ( 0.5f * size.y );
+        else if ( alignment & TEXT_ALIGNY_BOTTOM )
+          corrected_position.y -= stl::floorf ( size.y );
+      }
+
+      corrected_position.x -= this->spacing ( );
+
+      float start_x = corrected_position.x;
+      auto space_coords = this->coords ( 'A' );
+
+      for ( const auto c : text )
+      {
+        if ( c == '\n' )
+        {
+          corrected_position.x = start_x;
+          corrected_position.y += ( space_coords[ 3 ] - space_coords[ 1 ] ) * this->height ( );
+
+          continue;
+        }
+
+        if ( c < ' ' )
+          continue;
+
+        auto is_space = ( c == ' ' );
+        const auto &coords = this->coords ( c );
+
+        float w = ( coords[ 2 ] - coords[ 0 ] ) * this->width ( ) / this->scale ( );
+        float h = ( coords[ 3 ] - coords[ 1 ] ) * this->height ( ) / this->scale ( );
+
+        if ( !is_space )
+          fn ( corrected_position, point_t { w, h }, coords );
+
+        corrected_position.x += w - ( 2.f * this->spacing ( ) );
+      }
+    }
+
+    /// <summary>
+    /// called on device reset (pre/post)
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    {
+      // fonts that aren't finalized yet have no texture to lose
+      if ( this->m_state != daisy_font_state::FONT_STATE_READY )
+        return true;
+
+      if ( !pre_reset )
+        return this->create_ex ( );
+      else if ( this->m_texture_handle )
+      {
+        this->m_texture_handle->Release ( );
+        this->m_texture_handle = nullptr;
+      }
+
+      return true;
+    }
+
+    /// <summary>
+    /// erases the font
+    /// </summary>
+    void erase ( ) noexcept
+    {
+      if ( this->m_texture_handle )
+      {
+        this->m_texture_handle->Release ( );
+        this->m_texture_handle = nullptr;
+      }
+
+      this->m_coords.clear ( );
+      this->m_staging.reset ( );
+      this->m_state = daisy_font_state::FONT_STATE_EMPTY;
+
+      this->m_size = this->m_spacing = this->m_flags = 0;
+      this->m_scale = 1.f;
+      this->m_family = "";
+    }
+
+    // getters
+
+    /// <summary>
+    /// get UV coordinates of glyph
+    /// </summary>
+    /// <typeparam name="t">char, wchar_t</typeparam>
+    /// <param name="glyph">character to get glyph UV coordinates for</param>
+    /// <returns>UV coordinates of glyph</returns>
+    template < typename t = char >
+    const uv_t &coords ( t glyph ) const noexcept
+    {
+      if ( this->m_coords.find ( glyph ) != this->m_coords.end ( ) )
+        return this->m_coords.at ( glyph );
+
+      static uv_t null_uv { 0.f, 0.f, 0.f, 0.f };
+      return null_uv;
+    }
+
+    /// <summary>
+    /// get state of font
+    /// </summary>
+    /// <returns>font state</returns>
+    daisy_font_state state ( ) const noexcept
+    {
+      return this->m_state;
+    }
+
+    /// <summary>
+    /// check if font can be drawn with
+    /// </summary>
+    /// <returns>true if font is ready</returns>
+    bool ready ( ) const noexcept
+    {
+      return this->m_state == daisy_font_state::FONT_STATE_READY;
+    }
+
+    /// <summary>
+    /// get font spacing
+    /// </summary>
+    /// <returns>font spacing</returns>
+    uint32_t spacing ( ) const noexcept
+    {
+      return this->m_spacing;
+    }
+
+    /// <summary>
+    /// get font width
+    /// </summary>
+    /// <returns>font width</returns>
+    uint32_t width ( ) const noexcept
+    {
+      return this->m_width;
+    }
+
+    /// <summary>
+    /// get font height
+    /// </summary>
+    /// <returns>font height</returns>
+    uint32_t height ( ) const noexcept
+    {
+      return this->m_height;
+    }
+
+    /// <summary>
+    /// get font scale
+    /// </summary>
+    /// <returns>font scale</returns>
+    float scale ( ) const noexcept
+    {
+      return this->m_scale;
+    }
+
+    /// <summary>
+    /// get texture handle
+    /// </summary>
+    /// <returns>texture handle</returns>
+    IDirect3DTexture9 *texture_handle ( ) const noexcept
+    {
+      return this->m_texture_handle;
+    }
+  };
+
+  class c_texatlas : public c_daisy_resettable_object
+  {
+  private:
+    stl::pmr::unordered_map< uint32_t, uv_t > m_coords;
+
+    // rasterized paths, keyed by uuid and size
+    stl::pmr::unordered_map< uint64_t, uv_t > m_icons;
+
+    // shadow falloff corners, keyed by radius
+    stl::pmr::unordered_map< uint32_t, uv_t > m_shadows;
+
+    point_t m_cursor, m_dimensions;
+    IDirect3DTexture9 *m_texture_handle;
+    float m_max_height;
+
+  private:
+    /// <summary>
+    /// packs a texture into the atlas
+    /// </summary>
+    /// <param name="dimensions">dimensions of texture in pixels</param>
+    /// <param name="tex_data">A8R8G8B8 texture data</param>
+    /// <param name="tex_size">size of texture data in bytes</param>
+    /// <param name="uv">UV coordinates of packed texture</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool place ( const point_t &dimensions, const uint8_t *tex_data, uint32_t tex_size, uv_t &uv ) noexcept
+    {
+      if ( !tex_data || !tex_size )
+        return false;
+
+      // go down if not enough space left
+      if ( this->m_cursor.x + dimensions.x > this->m_dimensions.x )
+      {
+        this->m_cursor.y += this->m_max_height;
+        this->m_cursor.x = this->m_max_height = 0.f;
+      }
+
+      // not enough space left
+      if ( this->m_cursor.y + dimensions.y > this->m_dimensions.y )
+        return false;
+
+      // ensure we set max height
+      if ( this->m_max_height < dimensions.y )
+        this->m_max_height = dimensions.y;
+
+      // lock tex
+      D3DLOCKED_RECT tex_locked_rect;
+
+      if ( this->m_texture_handle->LockRect ( 0, &tex_locked_rect, NULL, 0 ) != D3D_OK )
+        return false;
+
+      // copy tex data over
+      for ( int y = 0; y < dimensions.y; ++y )
+      {
+        for ( int x = 0; x < dimensions.x; ++x )
+        {
+          const uint8_t *source_pixel = tex_data + static_cast< uint32_t > ( dimensions.x ) * 4 * y + x * 4;
+
+          // ensure the texture size matches what we expect
+          if ( static_cast< uint32_t > ( dimensions.x ) * 4 * y + x * 4 > tex_size )
+            return false;
+
+          uint8_t *destination_pixel = static_cast< uint8_t * > ( tex_locked_rect.pBits ) + tex_locked_rect.Pitch * ( static_cast< uint32_t > ( this->m_cursor.y ) + y ) + ( static_cast< uint32_t > ( this->m_cursor.x ) + x ) * 4;
+
+          destination_pixel[ 0 ] = source_pixel[ 2 ];
+          destination_pixel[ 1 ] = source_pixel[ 1 ];
+          destination_pixel[ 2 ] = source_pixel[ 0 ];
+          destination_pixel[ 3 ] = source_pixel[ 3 ];
+        }
+      }
+
+      this->m_texture_handle->UnlockRect ( 0 );
+
+      // set uv mins/maxs
+      auto start_uv = point_t { this->m_cursor.x / this->m_dimensions.x, this->m_cursor.y / this->m_dimensions.y };
+      auto end_uv = point_t { start_uv.x + dimensions.x / this->m_dimensions.x, start_uv.y + dimensions.y / this->m_dimensions.y };
+      uv = uv_t { start_uv.x, start_uv.y, end_uv.x, end_uv.y };
+
+      // move cursor over
+      this->m_cursor.x += dimensions.x;
+
+      return true;
+    }
+
+    /// <summary>
+    /// builds key of a rasterized path
+    /// </summary>
+    /// <param name="uuid">uuid of path</param>
+    /// <param name="size">size in pixels</param>
+    /// <returns>key of rasterized path</returns>
+    static uint64_t icon_key ( const uint32_t uuid, const point_t &size ) noexcept
+    {
+      return ( static_cast< uint64_t > ( uuid ) << 32 ) | ( static_cast< uint64_t > ( static_cast< uint16_t > ( size.x ) ) << 16 ) | static_cast< uint16_t > ( size.y );
+    }
+
+  public:
+    c_texatlas ( c_daisy_context &context = daisy_t::s_context ) noexcept
+        : c_daisy_resettable_object ( context ), m_coords ( context.resource ( ) ), m_icons ( context.resource ( ) ), m_shadows ( context.resource ( ) ), m_cursor ( { 0.f, 0.f } ),
+          m_dimensions ( { 0.f, 0.f } ), m_texture_handle ( nullptr ), m_max_height ( 0.f )
+    {
+    }
+
+    // disable copying
+    c_texatlas ( const c_texatlas & ) = delete;
+    c_texatlas &operator= ( const c_texatlas & ) = delete;
+
+    /// <summary>
+    /// creates a texture atlas
+    /// </summary>
+    /// <param name="dimensions">texture atlas dimensions</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const point_t &dimensions ) noexcept
+    {
+      if ( !this->m_context->device ( ) )
+        return false;
+
+      this->m_dimensions = dimensions;
+      this->m_cursor = point_t { 0.f, 0.f };
+      this->m_max_height = 0.f;
+
+      // the texture is blank again, rasterized paths and shadows need to be appended again
+      this->m_icons.clear ( );
+      this->m_shadows.clear ( );
+
+      if ( this->m_context->device ( )->CreateTexture ( static_cast< UINT > ( dimensions.x ), static_cast< UINT > ( dimensions.y ), 1, D3DUSAGE_DYNAMIC, D3DFMT_A8R8G8B8, D3DPOOL_DEFAULT, &this->m_texture_handle, nullptr ) != D3D_OK )
+        return false;
+
+      return true;
+    }
+
+    /// <summary>
+    /// called on device reset (pre/post). the texture is recreated blank, shadow falloffs are rebuilt right away since they only depend on
+    /// their radius. appended textures and rasterized paths aren't kept around, so they have to be appended again after the reset
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    {
+      if ( pre_reset )
+      {
+        if ( this->m_texture_handle )
+          this->m_texture_handle->Release ( );
+
+        return true;
+      }
+
+      try
+      {
+        // create() forgets the shadows, rebuild them in a fixed order (the map doesn't have one)
+        stl::pmr::vector< uint32_t > radii ( this->m_context->resource ( ) );
+        radii.reserve ( this->m_shadows.size ( ) );
+
+        for ( const auto &shadow : this->m_shadows )
+          radii.push_back ( shadow.first );
+
+        stl::sort ( radii.begin ( ), radii.end ( ) );
+
+        if ( !this->create ( this->m_dimensions ) )
+          return false;
+
+        for ( const auto radius : radii )
+          if ( !this->append_shadow ( radius ) )
+            return false;
+      }
+      catch ( ... )
+      {
+        return false;
+      }
+
+      return true;
+    }
+
+    /// <summary>
+    /// appends a texture to the texture atlas
+    /// </summary>
+    /// <param name="uuid">uuid of texture (can be whatever you want as long as it's unique per texture)</param>
+    /// <param name="dimensions">dimensions of texture in pixels</param>
+    /// <param name="tex_data">A8R8G8B8 texture data</param>
+    /// <param name="tex_size">size of texture data in bytes</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool append ( const uint32_t uuid, const point_t &dimensions, uint8_t *tex_data, uint32_t tex_size ) noexcept
+    {
+      uv_t uv;
+      if ( !this->place ( dimensions, tex_data, tex_size, uv ) )
+        return false;
+
+      this->m_coords[ uuid ] = uv;
+
+      return true;
+    }
+
+    /// <summary>
+    /// rasterizes a filled path into the texture atlas with anti-aliased edges, so it can be drawn as a single textured quad.
+    /// results are cached per uuid and size, appending an already rasterized path is a no-op. the path isn't kept, so after a device reset
+    /// it has to be appended again (path_coords returns zero UV coordinates until then)
+    /// </summary>
+    /// <param name="uuid">uuid of path (can be whatever you want as long as it's unique per path)</param>
+    /// <param name="path">path to rasterize, subpaths are filled with the non-zero rule</param>
+    /// <param name="view_size">size of the area the path is defined in, in path units (eg. 24x24 for most icon sets)</param>
+    /// <param name="size">size to rasterize the path at, in pixels (at most 65535x65535)</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool append_path ( const uint32_t uuid, c_path &path, const point_t &view_size, const point_t &size )
+    {
+      if ( size.x < 1.f || size.y < 1.f || view_size.x <= 0.f || view_size.y <= 0.f )
+        return false;
+
+      const auto key = icon_key ( uuid, size );
+      if ( this->m_icons.find ( key ) != this->m_icons.end ( ) )
+        return true;
+
+      // keep a transparent border around the path so bilinear filtering doesn't bleed in neighbouring textures
+      constexpr uint32_t padding = 1;
+
+      const auto width = static_cast< uint32_t > ( size.x );
+      const auto height = static_cast< uint32_t > ( size.y );
+      const auto padded_width = width + padding * 2;
+      const auto padded_height = height + padding * 2;
+
+      const auto transform = transform_t::translation ( { static_cast< float > ( padding ), static_cast< float > ( padding ) } ) *
+                             transform_t::scaling ( { static_cast< float > ( width ) / view_size.x, static_cast< float > ( height ) / view_size.y } );
+
+      if ( !path.tessellate ( 0.1f / transform.max_scale ( ), false ) )
+        return false;
+
+      stl::pmr::vector< float > acc ( padded_width * padded_height + 2, 0.f, this->m_context->resource ( ) );
+
+      // every subpath is implicitly closed when filling
+      const auto &points = path.points ( );
+      for ( uint32_t i = 0; i < path.subpath_count ( ); ++i )
+      {
+        uint32_t first, count;
+        bool closed;
+        path.subpath ( i, first, count, closed );
+
+        for ( uint32_t j = 0; j < count; ++j )
+          detail::accumulate_line ( acc.data ( ), padded_width, padded_height, transform.apply ( points[ first + j ] ), transform.apply ( points[ first + ( j + 1 ) % count ] ) );
+      }
+
+      // resolve coverage into white texels, the vertex color tints them when drawing
+      stl::pmr::vector< uint8_t > texels ( padded_width * padded_height * 4, this->m_context->resource ( ) );
+
+      float coverage = 0.f;
+      for ( uint32_t i = 0; i < padded_width * padded_height; ++i )
+      {
+        coverage += acc[ i ];
+
+        const float alpha = stl::fabsf ( coverage );
+
+        texels[ i * 4 + 0 ] = texels[ i * 4 + 1 ] = texels[ i * 4 + 2 ] = 255;
+        texels[ i * 4 + 3 ] = static_cast< uint8_t > ( ( alpha < 1.f ? alpha : 1.f ) * 255.f + 0.5f );
+      }
+
+      uv_t uv;
+      if ( !this->place ( { static_cast< float > ( padded_width ), static_cast< float > ( padded_height ) }, texels.data ( ), static_cast< uint32_t > ( texels.size ( ) ), uv ) )
+        return false;
+
+      // strip padding from UV coordinates
+      const float pad_u = static_cast< float > ( padding ) / this->m_dimensions.x;
+      const float pad_v = static_cast< float > ( padding ) / this->m_dimensions.y;
+      this->m_icons[ key ] = uv_t { uv[ 0 ] + pad_u, uv[ 1 ] + pad_v, uv[ 2 ] - pad_u, uv[ 3 ] - pad_v };
+
+      return true;
+    }
+
+    /// <summary>
+    /// precomputes a gaussian falloff for soft shadows and glows of a given radius into the texture atlas.
+    /// only one corner is stored, c_renderqueue::push_shadow_rect mirrors and stretches it into a nine-slice. reset() rebuilds appended falloffs
+    /// </summary>
+    /// <param name="radius">blur radius in pixels, the shadow fades out over radius pixels on either side of the shadowed edge</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool append_shadow ( const uint32_t radius )
+    {
+      if ( !radius )
+        return false;
+
+      if ( this->m_shadows.find ( radius ) != this->m_shadows.end ( ) )
+        return true;
+
+      // transparent padding texel so filtering doesn't bleed in neighbouring textures, then the falloff, then a fully solid texel
+      const uint32_t ramp = radius * 2;
+      const uint32_t dimension = ramp + 2;
+
+      // edge profile of a box blurred with sigma = radius / 2, rescaled so it's exactly 0 and 1 at the ends of the ramp
+      const float sigma = static_cast< float > ( radius ) * 0.5f;
+      const auto cdf = [ sigma ] ( const float x ) {
+        return 0.5f * ( 1.f + stl::erff ( x / ( sigma * 1.41421356f ) ) );
+      };
+
+      const float low = cdf ( -static_cast< float > ( radius ) ), high = cdf ( static_cast< float > ( radius ) );
+
+      stl::pmr::vector< float > profile ( dimension, 0.f, this->m_context->resource ( ) );
+      for ( uint32_t i = 0; i < ramp; ++i )
+        profile[ i + 1 ] = ( cdf ( static_cast< float > ( i ) + 0.5f - static_cast< float > ( radius ) ) - low ) / ( high - low );
+
+      profile[ dimension - 1 ] = 1.f;
+
+      // the falloff of a corner is separable
+      stl::pmr::vector< uint8_t > texels ( dimension * dimension * 4, this->m_context->resource ( ) );
+      for ( uint32_t y = 0; y < dimension; ++y )
+      {
+        for ( uint32_t x = 0; x < dimension; ++x )
+        {
+          uint8_t *texel = &texels[ ( y * dimension + x ) * 4 ];
+
+          texel[ 0 ] = texel[ 1 ] = texel[ 2 ] = 255;
+          texel[ 3 ] = static_cast< uint8_t > ( profile[ x ] * profile[ y ] * 255.f + 0.5f );
+        }
+      }
+
+      uv_t uv;
+      if ( !this->place ( { static_cast< float > ( dimension ), static_cast< float > ( dimension ) }, texels.data ( ), static_cast< uint32_t > ( texels.size ( ) ), uv ) )
+        return false;
+
+      // mins point at the outer edge of the falloff (past the padding texel), maxs at the center of the solid texel
+      this->m_shadows[ radius ] = uv_t { uv[ 0 ] + 1.f / this->m_dimensions.x, uv[ 1 ] + 1.f / this->m_dimensions.y, uv[ 2 ] - 0.5f / this->m_dimensions.x, uv[ 3 ] - 0.5f / this->m_dimensions.y };
+
+      return true;
+    }
+
+    /// <summary>
+    /// get UV coordinates of a shadow falloff corner
+    /// </summary>
+    /// <param name="radius">blur radius the falloff was appended with</param>
+    /// <param name="uv">UV coordinates of falloff corner, mins being the outer edge and maxs the solid interior</param>
+    /// <returns>true if the falloff was appended, false otherwise</returns>
+    bool shadow_coords ( const uint32_t radius, uv_t &uv ) const noexcept
+    {
+      const auto it = this->m_shadows.find ( radius );
+      if ( it == this->m_shadows.end ( ) )
+        return false;
+
+      uv = it->second;
+      return true;
+    }
+
+    /// <summary>
+    /// get UV coordinates of a rasterized path
+    /// </summary>
+    /// <param name="uuid">uuid of path</param>
+    /// <param name="size">size the path was rasterized at, in pixels</param>
+    /// <returns>UV coordinates of rasterized path</returns>
+    const uv_t &path_coords ( const uint32_t uuid, const point_t &size ) const noexcept
+    {
+      const auto it = this->m_icons.find ( icon_key ( uuid, size ) );
+      if ( it != this->m_icons.end ( ) )
+        return it->second;
+
+      static uv_t null_uv { 0.f, 0.f, 0.f, 0.f };
+      return null_uv;
+    }
+
+    /// <summary>
+    /// get UV coordinates of texture
+    /// </summary>
+    /// <param name="glyph">character to get texture UV coordinates for</param>
+    /// <returns>UV coordinates of texture</returns>
+    const uv_t &coords ( uint32_t uuid ) const noexcept
+    {
+      if ( this->m_coords.find ( uuid ) != this->m_coords.end ( ) )
+        return this->m_coords.at ( uuid );
+
+      static uv_t null_uv { 0.f, 0.f, 0.f, 0.f };
+      return null_uv;
+    }
+
+    /// <summary>
+    /// get texture handle
+    /// </summary>
+    /// <returns>texture handle</returns>
+    IDirect3DTexture9 *texture_handle ( ) const noexcept
+    {
+      return this->m_texture_handle;
+    }
+  };
+
+  // texture for pixel data that changes every frame (heatmaps, video etc.)
+  // uploads rotate through a ring of textures so we never lock one the gpu might still be reading from.
+  // changes are staged on the cpu side, which also lets the contents survive device resets
+  class c_streamtexture : public c_daisy_resettable_object
+  {
+  private:
+    constexpr static inline uint32_t MAX_BUFFERS = 3;
+
+    struct buffer_t
+    {
+      IDirect3DTexture9 *m_texture_handle;
+
+      // rows changed since this texture was last written to, empty if first > last
+      uint32_t m_dirty_first, m_dirty_last;
+    };
+
+    stl::array< buffer_t, MAX_BUFFERS > m_buffers;
+    detail::resource_buffer_t< uint8_t > m_staging;
+
+    // used instead of dynamic textures if the device doesn't support them; ring buffers live in system memory and get copied over
+    IDirect3DTexture9 *m_target_handle;
+
+    uint32_t m_width, m_height, m_buffer_count, m_current;
+    bool m_dynamic;
+
+  private:
+    /// <summary>
+    /// marks rows as changed for every texture of the ring
+    /// </summary>
+    /// <param name="first">first changed row</param>
+    /// <param name="last">last changed row</param>
+    void mark_dirty ( const uint32_t first, const uint32_t last ) noexcept
+    {
+      for ( uint32_t i = 0; i < this->m_buffer_count; ++i )
+      {
+        auto &buffer = this->m_buffers[ i ];
+
+        if ( buffer.m_dirty_first > buffer.m_dirty_last )
+        {
+          buffer.m_dirty_first = first;
+          buffer.m_dirty_last = last;
+          continue;
+        }
+
+        if ( first < buffer.m_dirty_first )
+          buffer.m_dirty_first = first;
+
+        if ( last > buffer.m_dirty_last )
+          buffer.m_dirty_last = last;
+      }
+    }
+
+    /// <summary>
+    /// releases all d3d9 textures
+    /// </summary>
+    void release ( ) noexcept
+    {
+      for ( auto &buffer : this->m_buffers )
+      {
+        if ( buffer.m_texture_handle )
+        {
+          buffer.m_texture_handle->Release ( );
+          buffer.m_texture_handle = nullptr;
+        }
+      }
+
+      if ( this->m_target_handle )
+      {
+        this->m_target_handle->Release ( );
+        this->m_target_handle = nullptr;
+      }
+    }
+
+    /// <summary>
+    /// creates d3d9 textures
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool create_ex ( ) noexcept
+    {
+      if ( !this->m_context->device ( ) )
+        return false;
+
+      this->release ( );
+
+      const D3DCAPS9 &caps = this->m_context->caps ( );
+
+      this->m_dynamic = ( caps.Caps2 & D3DCAPS2_DYNAMICTEXTURES ) != 0;
+
+      for ( uint32_t i = 0; i < this->m_buffer_count; ++i )
+      {
+        if ( this->m_context->device ( )->CreateTexture ( this->m_width, this->m_height, 1, this->m_dynamic ? D3DUSAGE_DYNAMIC : 0, D3DFMT_A8R8G8B8, this->m_dynamic ? D3DPOOL_DEFAULT : D3DPOOL_SYSTEMMEM, &this->m_buffers[ i ].m_texture_handle, nullptr ) != D3D_OK )
+          return false;
+      }
+
+      if ( !this->m_dynamic && this->m_context->device ( )->CreateTexture ( this->m_width, this->m_height, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_DEFAULT, &this->m_target_handle, nullptr ) != D3D_OK )
+        return false;
+
+      // textures start out blank, everything has to be uploaded again
+      for ( uint32_t i = 0; i < this->m_buffer_count; ++i )
+      {
+        this->m_buffers[ i ].m_dirty_first = 0;
+        this->m_buffers[ i ].m_dirty_last = this->m_height - 1;
+      }
+
+      return true;
+    }
+
+  public:
+    c_streamtexture ( c_daisy_context &context = daisy_t::s_context ) noexcept
+        : c_daisy_resettable_object ( context ), m_buffers ( { } ), m_target_handle ( nullptr ), m_width ( 0 ), m_height ( 0 ), m_buffer_count ( 0 ), m_current ( 0 ), m_dynamic ( true )
+    {
+    }
+
+    // disallow copying
+    c_streamtexture ( const c_streamtexture & ) = delete;
+    c_streamtexture &operator= ( const c_streamtexture & ) = delete;
+
+    /// <summary>
+    /// creates streaming texture
+    /// </summary>
+    /// <param name="width">width of texture in pixels</param>
+    /// <param name="height">height of texture in pixels</param>
+    /// <param name="buffers">number of textures to rotate through (2 for double buffering, 3 for triple buffering)</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t width, const uint32_t height, const uint32_t buffers = 2 ) noexcept
+    {
+      if ( !width || !height || !buffers || buffers > MAX_BUFFERS )
+        return false;
+
+      this->m_width = width;
+      this->m_height = height;
+      this->m_buffer_count = buffers;
+      this->m_current = 0;
+
+      this->m_staging = detail::make_buffer< uint8_t > ( this->m_context->resource ( ), width * height * 4 );
+      if ( !this->m_staging )
+        return false;
+
+      memset ( this->m_staging.get ( ), 0, width * height * 4 );
+
+      return this->create_ex ( );
+    }
+
+    /// <summary>
+    /// called on device reset (pre/post)
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    {
+      if ( !pre_reset )
+        return this->create_ex ( );
+
+      this->release ( );
+
+      return true;
+    }
+
+    /// <summary>
+    /// replaces the whole image, the next commit uploads it with D3DLOCK_DISCARD
+    /// </summary>
+    /// <param name="data">pixel data</param>
+    /// <param name="pitch">size of a row of pixel data in bytes</param>
+    /// <param name="format">format of pixel data</param>
+    void update ( const uint8_t *data, const uint32_t pitch, const daisy_stream_format format = daisy_stream_format::STREAM_BGRA ) noexcept
+    {
+      this->update_rows ( 0, this->m_height, data, pitch, format );
+    }
+
+    /// <summary>
+    /// replaces a range of rows, only those rows are uploaded on the next commit
+    /// </summary>
+    /// <param name="first_row">first row to replace</param>
+    /// <param name="rows">number of rows to replace</param>
+    /// <param name="data">pixel data, starting at first_row</param>
+    /// <param name="pitch">size of a row of pixel data in bytes</param>
+    /// <param name="format">format of pixel data</param>
+    void update_rows ( const uint32_t first_row, uint32_t rows, const uint8_t *data, const uint32_t pitch, const daisy_stream_format format = daisy_stream_format::STREAM_BGRA ) noexcept
+    {
+      if ( !data || !this->m_staging || first_row >= this->m_height || !rows )
+        return;
+
+      if ( first_row + rows > this->m_height )
+        rows = this->m_height - first_row;
+
+      for ( uint32_t y = 0; y < rows; ++y )
+        detail::convert_row ( data + pitch * y, this->m_staging.get ( ) + ( first_row + y ) * this->m_width * 4, this->m_width, format );
+
+      this->mark_dirty ( first_row, first_row + rows - 1 );
+    }
+
+    /// <summary>
+    /// uploads pending changes into the next texture of the ring and makes it current, call from the d3d9 rendering thread before drawing
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool commit ( ) noexcept
+    {
+      if ( !this->m_buffer_count || !this->m_buffers[ 0 ].m_texture_handle )
+        return false;
+
+      const uint32_t next = ( this->m_current + 1 ) % this->m_buffer_count;
+      auto &buffer = this->m_buffers[ next ];
+
+      // changes are marked on every texture of the ring, if the next one is clean there's nothing pending
+      if ( buffer.m_dirty_first > buffer.m_dirty_last )
+        return true;
+
+      const bool full = buffer.m_dirty_first == 0 && buffer.m_dirty_last == this->m_height - 1;
+
+      // only lock changed rows; if the whole image changed, let the driver hand us fresh memory instead of waiting on the gpu
+      D3DLOCKED_RECT locked_rect;
+      RECT dirty_rect { 0, static_cast< LONG > ( buffer.m_dirty_first ), static_cast< LONG > ( this->m_width ), static_cast< LONG > ( buffer.m_dirty_last + 1 ) };
+
+      if ( buffer.m_texture_handle->LockRect ( 0, &locked_rect, full ? nullptr : &dirty_rect, ( full && this->m_dynamic ) ? D3DLOCK_DISCARD : 0 ) != D3D_OK )
+        return false;
+
+      uint8_t *dst_row = static_cast< uint8_t * > ( locked_rect.pBits );
+      for ( uint32_t y = buffer.m_dirty_first; y <= buffer.m_dirty_last; ++y )
+      {
+        memcpy ( dst_row, this->m_staging.get ( ) + y * this->m_width * 4, this->m_width * 4 );
+        dst_row += locked_rect.Pitch;
+      }
+
+      buffer.m_texture_handle->UnlockRect ( 0 );
+
+      buffer.m_dirty_first = 1;
+      buffer.m_dirty_last = 0;
+
+      // system memory fallback, copy over to the texture we actually draw with
+      if ( !this->m_dynamic && this->m_context->device ( )->UpdateTexture ( buffer.m_texture_handle, this->m_target_handle ) != D3D_OK )
+        return false;
+
+      this->m_current = next;
+
+      return true;
+    }
+
+    // getters
+
+    /// <summary>
+    /// get texture handle of the most recently committed texture, pass this to push_* calls
+    /// </summary>
+    /// <returns>texture handle</returns>
+    IDirect3DTexture9 *texture_handle ( ) const noexcept
+    {
+      return this->m_dynamic ? this->m_buffers[ this->m_current ].m_texture_handle : this->m_target_handle;
+    }
+
+    /// <summary>
+    /// get width of texture
+    /// </summary>
+    /// <returns>width in pixels</returns>
+    uint32_t width ( ) const noexcept
+    {
+      return this->m_width;
+    }
+
+    /// <summary>
+    /// get height of texture
+    /// </summary>
+    /// <returns>height in pixels</returns>
+    uint32_t height ( ) const noexcept
+    {
+      return this->m_height;
+    }
+  };
+
+  // a few large d3d9 buffers that c_renderqueue instances created in it suballocate their vertices and indices from, instead of owning buffers
+  // each. queues sharing a pool that get flushed back to back (see c_renderqueue::flush_all) only bind the buffers once.
+  // freed ranges are only reused a few frames later (see begin_frame), queues that get rebuilt every frame move to a new range each time,
+  // so the pool needs room for about RETIRED_FRAMES + 1 times their capacity. the pool has to outlive its queues
+  class c_bufferpool : public c_daisy_resettable_object
+  {
+  public:
+    // frames a freed range is held back for. d3d9 lets the cpu queue up to 3 frames ahead of the gpu by default
+    constexpr static inline uint32_t RETIRED_FRAMES = 3;
+
+  private:
+    // range of elements in one of the buffers
+    struct range_t
+    {
+      uint32_t m_first, m_count;
+    };
+
+    // range freed on m_frame, the gpu may still be drawing from it
+    struct retired_range_t
+    {
+      range_t m_range;
+      uint32_t m_frame;
+    };
+
+    IDirect3DVertexBuffer9 *m_vertex_buffer;
+    IDirect3DIndexBuffer9 *m_index_buffer;
+
+    // unused ranges, sorted by position
+    stl::pmr::vector< range_t > m_free_vtxs, m_free_idxs;
+
+    // freed ranges waiting for the gpu, oldest first
+    stl::pmr::vector< retired_range_t > m_retired_vtxs, m_retired_idxs;
+
+    uint32_t m_max_vtxs, m_max_idxs;
+
+    // frames begun so far
+    uint32_t m_frame;
+
+  private:
+    /// <summary>
+    /// takes a range out of free ranges, first fit
+    /// </summary>
+    /// <param name="ranges">free ranges</param>
+    /// <param name="count">elements needed</param>
+    /// <param name="first">first element of range</param>
+    /// <returns>true on success, false if there's no free range big enough</returns>
+    static bool allocate_range ( stl::pmr::vector< range_t > &ranges, const uint32_t count, uint32_t &first ) noexcept
+    {
+      for ( size_t i = 0; i < ranges.size ( ); ++i )
+      {
+        if ( ranges[ i ].m_count < count )
+          continue;
+
+        first = ranges[ i ].m_first;
+
+        ranges[ i ].m_first += count;
+        ranges[ i ].m_count -= count;
+
+        if ( !ranges[ i ].m_count )
+          ranges.erase ( ranges.begin ( ) + i );
+
+        return true;
+      }
+
+      return false;
+    }
+
+    /// <summary>
+    /// returns a range to free ranges, merging it with its neighbours
+    /// </summary>
+    /// <param name="ranges">free ranges</param>
+    /// <param name="first">first element of range</param>
+    /// <param name="count">elements in range</param>
+    static void free_range ( stl::pmr::vector< range_t > &ranges, const uint32_t first, const uint32_t count ) noexcept
+    {
+      if ( !count )
+        return;
+
+      size_t i = 0;
+      while ( i < ranges.size ( ) && ranges[ i ].m_first < first )
+        ++i;
+
+      ranges.insert ( ranges.begin ( ) + i, range_t { first, count } );
+
+      // merge with next, then with previous
+      if ( i + 1 < ranges.size ( ) && ranges[ i ].m_first + ranges[ i ].m_count == ranges[ i + 1 ].m_first )
+      {
+        ranges[ i ].m_count += ranges[ i + 1 ].m_count;
+        ranges.erase ( ranges.begin ( ) + i + 1 );
+      }
+
+      if ( i > 0 && ranges[ i - 1 ].m_first + ranges[ i - 1 ].m_count == ranges[ i ].m_first )
+      {
+        ranges[ i - 1 ].m_count += ranges[ i ].m_count;
+        ranges.erase ( ranges.begin ( ) + i );
+      }
+    }
+
+    /// <summary>
+    /// returns retired ranges to free ranges
+    /// </summary>
+    /// <param name="retired">retired ranges</param>
+    /// <param name="ranges">free ranges</param>
+    /// <param name="frames">frames a range has to be retired for, 0 returns all of them</param>
+    void reclaim_ranges ( stl::pmr::vector< retired_range_t > &retired, stl::pmr::vector< range_t > &ranges, const uint32_t frames ) noexcept
+    {
+      size_t reclaimed = 0;
+      while ( reclaimed < retired.size ( ) && this->m_frame - retired[ reclaimed ].m_frame >= frames )
+      {
+        free_range ( ranges, retired[ reclaimed ].m_range.m_first, retired[ reclaimed ].m_range.m_count );
+        ++reclaimed;
+      }
+
+      retired.erase ( retired.begin ( ), retired.begin ( ) + reclaimed );
+    }
+
+    /// <summary>
+    /// creates d3d9 buffers
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool create_ex ( ) noexcept
+    {
+      if ( !this->m_vertex_buffer )
+        if ( this->m_context->device ( )->CreateVertexBuffer ( static_cast< UINT > ( sizeof ( daisy_vtx_t ) * this->m_max_vtxs ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, ( D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 ), D3DPOOL_DEFAULT, &this->m_vertex_buffer, nullptr ) < 0 )
+          return false;
+
+      if ( !this->m_index_buffer )
+        if ( this->m_context->device ( )->CreateIndexBuffer ( static_cast< UINT > ( sizeof ( uint16_t ) * this->m_max_idxs ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &this->m_index_buffer, nullptr ) < 0 )
+          return false;
+
+      return true;
+    }
+
+  public:
+    c_bufferpool ( c_daisy_context &context = daisy_t::s_context ) noexcept
+        : c_daisy_resettable_object ( context ), m_vertex_buffer ( nullptr ), m_index_buffer ( nullptr ), m_free_vtxs ( context.resource ( ) ), m_free_idxs ( context.resource ( ) ),
+          m_retired_vtxs ( context.resource ( ) ), m_retired_idxs ( context.resource ( ) ), m_max_vtxs ( 0 ), m_max_idxs ( 0 ), m_frame ( 0 )
+    {
+    }
+
+    // disallow copying
+    c_bufferpool ( const c_bufferpool & ) = delete;
+    c_bufferpool &operator= ( const c_bufferpool & ) = delete;
+
+    /// <summary>
+    /// initializes pool by creating the shared vertex and index buffers. vertices of a queue are addressed relative to its range,
+    /// so the pool can hold more than 16 bit indices can address
+    /// </summary>
+    /// <param name="max_verts">capacity of shared vertex buffer</param>
+    /// <param name="max_indices">capacity of shared index buffer</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t max_verts = 262144, const uint32_t max_indices = 524288 ) noexcept
+    {
+      if ( !this->m_context->device ( ) )
+        return false;
+
+      this->release ( );
+
+      this->m_max_vtxs = max_verts;
+      this->m_max_idxs = max_indices;
+
+      this->m_free_vtxs = { range_t { 0, max_verts } };
+      this->m_free_idxs = { range_t { 0, max_indices } };
+      this->m_retired_vtxs.clear ( );
+      this->m_retired_idxs.clear ( );
+
+      return this->create_ex ( );
+    }
+
+    /// <summary>
+    /// releases d3d9 buffers, queues drop their references on their own pre-reset
+    /// </summary>
+    void release ( ) noexcept
+    {
+      if ( this->m_vertex_buffer )
+      {
+        this->m_vertex_buffer->Release ( );
+        this->m_vertex_buffer = nullptr;
+      }
+
+      if ( this->m_index_buffer )
+      {
+        this->m_index_buffer->Release ( );
+        this->m_index_buffer = nullptr;
+      }
+    }
+
+    /// <summary>
+    /// called on device reset (pre/post). suballocated ranges are kept, queues upload their content again after the reset
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    {
+      if ( pre_reset )
+      {
+        this->release ( );
+
+        // the buffers are gone, nothing can be drawing from retired ranges anymore
+        this->reclaim_ranges ( this->m_retired_vtxs, this->m_free_vtxs, 0 );
+        this->reclaim_ranges ( this->m_retired_idxs, this->m_free_idxs, 0 );
+        return true;
+      }
+
+      return this->m_context->device ( ) && this->create_ex ( );
+    }
+
+    /// <summary>
+    /// suballocates vertices
+    /// </summary>
+    /// <param name="count">vertices needed</param>
+    /// <param name="first">first vertex of range</param>
+    /// <returns>true on success, false if the pool is full</returns>
+    bool allocate_vertices ( const uint32_t count, uint32_t &first ) noexcept
+    {
+      return allocate_range ( this->m_free_vtxs, count, first );
+    }
+
+    /// <summary>
+    /// suballocates indices
+    /// </summary>
+    /// <param name="count">indices needed</param>
+    /// <param name="first">first index of range</param>
+    /// <returns>true on success, false if the pool is full</returns>
+    bool allocate_indices ( const uint32_t count, uint32_t &first ) noexcept
+    {
+      return allocate_range ( this->m_free_idxs, count, first );
+    }
+
+    /// <summary>
+    /// returns suballocated vertices to the pool. they can be allocated again RETIRED_FRAMES calls to begin_frame later
+    /// </summary>
+    /// <param name="first">first vertex of range</param>
+    /// <param name="count">vertices in range</param>
+    void free_vertices ( const uint32_t first, const uint32_t count ) noexcept
+    {
+      if ( count )
+        this->m_retired_vtxs.push_back ( retired_range_t { range_t { first, count }, this->m_frame } );
+    }
+
+    /// <summary>
+    /// returns suballocated indices to the pool. they can be allocated again RETIRED_FRAMES calls to begin_frame later
+    /// </summary>
+    /// <param name="first">first index of range</param>
+    /// <param name="count">indices in range</param>
+    void free_indices ( const uint32_t first, const uint32_t count ) noexcept
+    {
+      if ( count )
+        this->m_retired_idxs.push_back ( retired_range_t { range_t { first, count }, this->m_frame } );
+    }
+
+    /// <summary>
+    /// starts a new frame, ranges freed RETIRED_FRAMES frames ago can be allocated again. call this once per frame (eg. right before
+    /// filling the queues), otherwise freed ranges never come back and queues moving to new ones eventually fail to update
+    /// </summary>
+    void begin_frame ( ) noexcept
+    {
+      ++this->m_frame;
+
+      this->reclaim_ranges ( this->m_retired_vtxs, this->m_free_vtxs, RETIRED_FRAMES );
+      this->reclaim_ranges ( this->m_retired_idxs, this->m_free_idxs, RETIRED_FRAMES );
+    }
+
+    // getters
+
+    /// <summary>
+    /// get shared vertex buffer
+    /// </summary>
+    /// <returns>vertex buffer, nullptr while the device is lost</returns>
+    IDirect3DVertexBuffer9 *vertex_buffer ( ) const noexcept
+    {
+      return this->m_vertex_buffer;
+    }
+
+    /// <summary>
+    /// get shared index buffer
+    /// </summary>
+    /// <returns>index buffer, nullptr while the device is lost</returns>
+    IDirect3DIndexBuffer9 *index_buffer ( ) const noexcept
+    {
+      return this->m_index_buffer;
+    }
+  };
+
+  class c_renderqueue : public c_drawlist, public c_daisy_resettable_object
+  {
+  private:
+    constexpr static inline uint32_t STREAM_STRIDES[ STREAM_COUNT ] = { sizeof ( float ) * 4, sizeof ( D3DCOLOR ), sizeof ( float ) * 2 };
+
+    IDirect3DVertexBuffer9 *m_vertex_buffer;
+    IDirect3DIndexBuffer9 *m_index_buffer;
+
+    // used instead of m_vertex_buffer for LAYOUT_STREAMS
+    stl::array< IDirect3DVertexBuffer9 *, STREAM_COUNT > m_stream_buffers;
+    IDirect3DVertexDeclaration9 *m_declaration;
+    daisy_vertex_layout m_layout;
+
+    // vertices and indices the d3d9 buffers already hold, pushes made after the last upload get appended behind them
+    uint32_t m_uploaded_vtxs, m_uploaded_idxs;
+
+    // pool the buffers are suballocated from, nullptr if we own them. m_vertex_buffer and m_index_buffer then reference the shared ones
+    c_bufferpool *m_pool;
+    uint32_t m_pool_vtx_first, m_pool_idx_first, m_pool_vtxs, m_pool_idxs;
+
+    // ranges were written since they were allocated, the gpu may still be drawing from them
+    bool m_pool_vtxs_used, m_pool_idxs_used;
+
+    // baked into write-once buffers, see bake()
+    bool m_static;
+    D3DPOOL m_static_pool;
+
+  private:
+    /// <summary>
+    /// creates d3d9 vertex buffers for the current layout
+    /// </summary>
+    /// <param name="capacity">capacity in vertices</param>
+    /// <param name="usage">usage of buffers</param>
+    /// <param name="pool">pool of buffers</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool create_vertex_buffers ( const uint32_t capacity, const DWORD usage = D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, const D3DPOOL pool = D3DPOOL_DEFAULT ) noexcept
+    {
+      if ( this->m_layout == daisy_vertex_layout::LAYOUT_INTERLEAVED )
+        return this->m_vertex_buffer || this->m_context->device ( )->CreateVertexBuffer ( static_cast< UINT > ( sizeof ( daisy_vtx_t ) * capacity ), usage, ( D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 ), pool, &this->m_vertex_buffer, nullptr ) >= 0;
+
+      for ( uint32_t i = 0; i < STREAM_COUNT; ++i )
+        if ( !this->m_stream_buffers[ i ] )
+          if ( this->m_context->device ( )->CreateVertexBuffer ( static_cast< UINT > ( STREAM_STRIDES[ i ] * capacity ), usage, 0, pool, &this->m_stream_buffers[ i ], nullptr ) < 0 )
+            return false;
+
+      // declarations aren't lost on device resets
+      if ( !this->m_declaration )
+      {
+        const D3DVERTEXELEMENT9 elements[] = {
+            { STREAM_POSITION, 0, D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITIONT, 0 },
+            { STREAM_COLOR, 0, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 0 },
+            { STREAM_UV, 0, D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
+            D3DDECL_END ( ) };
+
+        if ( this->m_context->device ( )->CreateVertexDeclaration ( elements, &this->m_declaration ) < 0 )
+          return false;
+      }
+
+      return true;
+    }
+
+    /// <summary>
+    /// releases d3d9 index buffer
+    /// </summary>
+    void release_index_buffer ( ) noexcept
+    {
+      if ( this->m_index_buffer )
+      {
+        this->m_index_buffer->Release ( );
+        this->m_index_buffer = nullptr;
+      }
+    }
+
+    /// <summary>
+    /// releases d3d9 vertex buffers
+    /// </summary>
+    void release_vertex_buffers ( ) noexcept
+    {
+      if ( this->m_vertex_buffer )
+      {
+        this->m_vertex_buffer->Release ( );
+        this->m_vertex_buffer = nullptr;
+      }
+
+      for ( auto &buffer : this->m_stream_buffers )
+      {
+        if ( buffer )
+        {
+          buffer->Release ( );
+          buffer = nullptr;
+        }
+      }
+    }
+
+    /// <summary>
+    /// references the buffers of our pool, if we don't already
+    /// </summary>
+    /// <returns>true if we hold both buffers, false otherwise (eg. the pool wasn't reset yet)</returns>
+    bool reference_pool_buffers ( ) noexcept
+    {
+      if ( !this->m_vertex_buffer && ( this->m_vertex_buffer = this->m_pool->vertex_buffer ( ) ) )
+        this->m_vertex_buffer->AddRef ( );
+
+      if ( !this->m_index_buffer && ( this->m_index_buffer = this->m_pool->index_buffer ( ) ) )
+        this->m_index_buffer->AddRef ( );
+
+      return this->m_vertex_buffer && this->m_index_buffer;
+    }
+
+    /// <summary>
+    /// moves our vertices to a range of the pool that fits the current capacity
+    /// </summary>
+    /// <returns>true on success, false if the pool is full</returns>
+    bool allocate_pool_vertices ( ) noexcept
+    {
+      this->m_pool->free_vertices ( this->m_pool_vtx_first, this->m_pool_vtxs );
+      this->m_pool_vtxs = 0;
+
+      if ( !this->m_pool->allocate_vertices ( this->m_vtxs.m_capacity, this->m_pool_vtx_first ) )
+        return false;
+
+      this->m_pool_vtxs = this->m_vtxs.m_capacity;
+      this->m_pool_vtxs_used = false;
+
+      return true;
+    }
+
+    /// <summary>
+    /// moves our indices to a range of the pool that fits the current capacity
+    /// </summary>
+    /// <returns>true on success, false if the pool is full</returns>
+    bool allocate_pool_indices ( ) noexcept
+    {
+      this->m_pool->free_indices ( this->m_pool_idx_first, this->m_pool_idxs );
+      this->m_pool_idxs = 0;
+
+      if ( !this->m_pool->allocate_indices ( this->m_idxs.m_capacity, this->m_pool_idx_first ) )
+        return false;
+
+      this->m_pool_idxs = this->m_idxs.m_capacity;
+      this->m_pool_idxs_used = false;
+
+      return true;
+    }
+
+    /// <summary>
+    /// copies a range of local vertices to d3d9 buffers, split into streams for LAYOUT_STREAMS
+    /// </summary>
+    /// <param name="first">first vertex to copy</param>
+    /// <param name="count">vertices to copy</param>
+    /// <param name="streams">mask of vertex streams to copy (1 &lt;&lt; STREAM_*), ignored for LAYOUT_INTERLEAVED</param>
+    /// <param name="flags">lock flags</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool upload_vertices ( const uint32_t first, const uint32_t count, const uint8_t streams, const DWORD flags ) noexcept
+    {
+      const daisy_vtx_t *src = reinterpret_cast< const daisy_vtx_t * > ( this->m_vtxs.m_data.get ( ) ) + first;
+      void *data;
+
+      if ( this->m_layout == daisy_vertex_layout::LAYOUT_INTERLEAVED )
+      {
+        if ( this->m_vertex_buffer->Lock ( static_cast< UINT > ( ( this->m_pool_vtx_first + first ) * sizeof ( daisy_vtx_t ) ), static_cast< UINT > ( count * sizeof ( daisy_vtx_t ) ), &data, flags ) < 0 )
+          return false;
+
+        memcpy ( data, src, sizeof ( daisy_vtx_t ) * count );
+
+        this->m_vertex_buffer->Unlock ( );
+        return true;
+      }
+
+      for ( uint32_t i = 0; i < STREAM_COUNT; ++i )
+      {
+        if ( !( streams & ( 1 << i ) ) )
+          continue;
+
+        if ( this->m_stream_buffers[ i ]->Lock ( static_cast< UINT > ( first * STREAM_STRIDES[ i ] ), static_cast< UINT > ( count * STREAM_STRIDES[ i ] ), &data, flags ) < 0 )
+          return false;
+
+        switch ( i )
+        {
+        case STREAM_POSITION:
+          for ( uint32_t j = 0; j < count; ++j )
+            memcpy ( static_cast< float * > ( data ) + j * 4, src[ j ].m_pos, sizeof ( float ) * 4 );
+          break;
+        case STREAM_COLOR:
+          for ( uint32_t j = 0; j < count; ++j )
+            static_cast< D3DCOLOR * > ( data )[ j ] = src[ j ].m_col;
+          break;
+        case STREAM_UV:
+          for ( uint32_t j = 0; j < count; ++j )
+            memcpy ( static_cast< float * > ( data ) + j * 2, src[ j ].m_uv, sizeof ( float ) * 2 );
+          break;
+        }
+
+        this->m_stream_buffers[ i ]->Unlock ( );
+      }
+
+      return true;
+    }
+
+    /// <summary>
+    /// copies patched vertices to d3d9 buffers
+    /// </summary>
+    void update_dirty ( ) noexcept
+    {
+      // static buffers can't be locked with D3DLOCK_NOOVERWRITE, plain locks are slower but patches to static queues should be rare anyway
+      const DWORD flags = this->m_static ? 0 : D3DLOCK_NOOVERWRITE;
+
+      // the rest of the buffer is left as is, so we can't discard it.
+      // the previous frame may still be drawing from these vertices; worst case it picks up the new values a frame early
+      if ( this->m_layout == daisy_vertex_layout::LAYOUT_INTERLEAVED )
+      {
+        dirty_range_t range { UINT32_MAX, 0 };
+        for ( const auto &stream_range : this->m_dirty )
+        {
+          if ( stream_range.m_first < range.m_first )
+            range.m_first = stream_range.m_first;
+
+          if ( stream_range.m_last > range.m_last )
+            range.m_last = stream_range.m_last;
+        }
+
+        if ( !this->upload_vertices ( range.m_first, range.m_last - range.m_first + 1, ALL_STREAMS, flags ) )
+          return;
+      }
+      // only streams that were patched get uploaded, eg. a fade only touches the 4 byte color stream
+      else
+      {
+        for ( uint32_t i = 0; i < STREAM_COUNT; ++i )
+        {
+          const auto &range = this->m_dirty[ i ];
+
+          if ( range.m_first <= range.m_last && !this->upload_vertices ( range.m_first, range.m_last - range.m_first + 1, static_cast< uint8_t > ( 1 << i ), flags ) )
+            return;
+        }
+      }
+
+      this->reset_dirty ( );
+    }
+
+    /// <summary>
+    /// flushes vertices and indices to d3d9 buffer if an update is required and actually draws primitives
+    /// </summary>
+    /// <param name="bind_buffers">if d3d9 buffers have to be bound, not needed if the previous queue was created in the same pool</param>
+    /// <returns>true if anything was drawn, false otherwise</returns>
+    bool flush_ex ( const bool bind_buffers ) noexcept
+    {
+      // no-op if the queue was prepared and left untouched since
+      if ( !this->prepare ( ) )
+        return false;
+
+      if ( bind_buffers )
+      {
+        if ( this->m_layout == daisy_vertex_layout::LAYOUT_INTERLEAVED )
+        {
+          this->m_context->device ( )->SetStreamSource ( 0, this->m_vertex_buffer, 0, sizeof ( daisy_vtx_t ) );
+          this->m_context->device ( )->SetFVF ( ( D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 ) );
+        }
+        else
+        {
+          for ( uint32_t i = 0; i < STREAM_COUNT; ++i )
+            this->m_context->device ( )->SetStreamSource ( i, this->m_stream_buffers[ i ], 0, STREAM_STRIDES[ i ] );
+
+          this->m_context->device ( )->SetVertexDeclaration ( this->m_declaration );
+        }
+
+        this->m_context->device ( )->SetIndices ( this->m_index_buffer );
+      }
+
+      const auto kinds = this->m_drawcalls.kinds ( );
+      const auto handles = this->m_drawcalls.handles ( );
+      const auto ranges = this->m_drawcalls.ranges ( );
+
+      // render commands
+      for ( uint32_t i = 0; i < this->m_drawcalls.size ( ); ++i )
+      {
+        // @todo: more proper support for shaders
+        switch ( kinds[ i ] )
+        {
+        case daisy_call_kind::CALL_TRI:
+          this->m_context->device ( )->SetTexture ( 0, static_cast< IDirect3DTexture9 * > ( handles[ i ] ) );
+          this->m_context->device ( )->DrawIndexedPrimitive ( D3DPT_TRIANGLELIST, this->m_pool_vtx_first + ranges[ i ].m_first_vertex, 0, ranges[ i ].m_vertices,
+                                                              this->m_pool_idx_first + ranges[ i ].m_first_index, ranges[ i ].m_indices / 3 );
+          break;
+        case daisy_call_kind::CALL_VTXSHADER:
+          this->m_context->device ( )->SetVertexShader ( static_cast< IDirect3DVertexShader9 * > ( handles[ i ] ) );
+          break;
+        case daisy_call_kind::CALL_PIXSHADER:
+          this->m_context->device ( )->SetPixelShader ( static_cast< IDirect3DPixelShader9 * > ( handles[ i ] ) );
+          break;
+        case daisy_call_kind::CALL_SCISSOR: {
+          point_t position, size;
+          this->m_drawcalls.scissor ( i, position, size );
+
+          RECT r { static_cast< LONG > ( position.x ), static_cast< LONG > ( position.y ), static_cast< LONG > ( position.x + size.x ), static_cast< LONG > ( position.y + size.y ) };
+
+          this->m_context->device ( )->SetScissorRect ( &r );
+        }
+        break;
+        }
+      }
+
+      return true;
+    }
+
+  public:
+    c_renderqueue ( c_daisy_context &context = daisy_t::s_context, stl::pmr::memory_resource *resource = nullptr ) noexcept
+        : c_drawlist ( resource ? resource : context.resource ( ) ), c_daisy_resettable_object ( context ), m_vertex_buffer ( nullptr ), m_index_buffer ( nullptr ), m_stream_buffers { }, m_declaration ( nullptr ),
+          m_layout ( daisy_vertex_layout::LAYOUT_INTERLEAVED ), m_uploaded_vtxs ( 0 ), m_uploaded_idxs ( 0 ), m_pool ( nullptr ), m_pool_vtx_first ( 0 ), m_pool_idx_first ( 0 ),
+          m_pool_vtxs ( 0 ), m_pool_idxs ( 0 ), m_pool_vtxs_used ( false ), m_pool_idxs_used ( false ), m_static ( false ), m_static_pool ( D3DPOOL_DEFAULT )
+    {
+    }
+
+    // disallow copying
+    c_renderqueue ( const c_renderqueue & ) = delete;
+    c_renderqueue &operator= ( const c_renderqueue & ) = delete;
+
+    /// <summary>
+    /// initializes current queue by initializing vertex and index buffers
+    /// </summary>
+    /// <param name="max_verts">max capacity of vertex buffer</param>
+    /// <param name="max_indices">max capacity of index buffer</param>
+    /// <param name="layout">layout of vertices on the gpu, LAYOUT_STREAMS pays off for queues whose colors get patched a lot (fades, highlights)</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t max_verts = 32767, const uint32_t max_indices = 65535, const daisy_vertex_layout layout = daisy_vertex_layout::LAYOUT_INTERLEAVED ) noexcept
+    {
+      if ( !this->m_context->device ( ) )
+        return false;
+
+      // switching layouts drops the buffers of the old one
+      if ( layout != this->m_layout )
+      {
+        this->release_vertex_buffers ( );
+        this->m_layout = layout;
+        this->m_update = true;
+        this->m_uploaded_vtxs = 0;
+      }
+
+      // create d3d9 buffers
+      if ( !this->create_vertex_buffers ( max_verts ) )
+        return false;
+
+      if ( !this->m_index_buffer )
+        if ( this->m_context->device ( )->CreateIndexBuffer ( sizeof ( uint16_t ) * max_indices, D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &this->m_index_buffer, nullptr ) < 0 )
+          return false;
+
+      // create local buffers
+      return this->create_staging ( max_verts, max_indices );
+    }
+
+    /// <summary>
+    /// initializes current queue with vertices and indices suballocated from a pool instead of own d3d9 buffers. always LAYOUT_INTERLEAVED
+    /// </summary>
+    /// <param name="pool">pool to suballocate from, has to outlive the queue</param>
+    /// <param name="max_verts">max capacity of vertex buffer</param>
+    /// <param name="max_indices">max capacity of index buffer</param>
+    /// <returns>true on success, false otherwise (eg. the pool is full)</returns>
+    [[nodiscard]] bool create ( c_bufferpool &pool, const uint32_t max_verts = 4096, const uint32_t max_indices = 8192 ) noexcept
+    {
+      if ( !this->m_context->device ( ) || this->m_static )
+        return false;
+
+      // drop own buffers, or references to a previous pool
+      this->release_vertex_buffers ( );
+      this->release_index_buffer ( );
+
+      if ( this->m_pool )
+      {
+        this->m_pool->free_vertices ( this->m_pool_vtx_first, this->m_pool_vtxs );
+        this->m_pool->free_indices ( this->m_pool_idx_first, this->m_pool_idxs );
+        this->m_pool_vtxs = this->m_pool_idxs = 0;
+      }
+
+      this->m_pool = &pool;
+      this->m_layout = daisy_vertex_layout::LAYOUT_INTERLEAVED;
+      this->m_update = true;
+      this->m_realloc_vtx = this->m_realloc_idx = false;
+      this->m_uploaded_vtxs = this->m_uploaded_idxs = 0;
+
+      return this->create_staging ( max_verts, max_indices ) && this->allocate_pool_vertices ( ) && this->allocate_pool_indices ( ) && this->reference_pool_buffers ( );
+    }
+
+    /// <summary>
+    /// uploads everything pushed so far once into write-once (non-dynamic) d3d9 buffers, for geometry that never changes (eg. static decorations).
+    /// flushing a baked queue just draws, until clear() turns it back into a regular queue. don't push to a baked queue before clearing it.
+    /// queues created in a c_bufferpool can't be baked
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool bake ( ) noexcept
+    {
+      if ( !this->m_context->device ( ) || this->m_pool || !this->m_vtxs.m_data || !this->m_idxs.m_data )
+        return false;
+
+      this->release_vertex_buffers ( );
+      this->release_index_buffer ( );
+
+      const auto vertices = this->m_vtxs.m_size ? this->m_vtxs.m_size : 1;
+      const auto indices = this->m_idxs.m_size ? this->m_idxs.m_size : 1;
+
+      // managed buffers get restored by the runtime after device resets, devices without a managed pool (d3d9ex) get default pool buffers
+      // that reset() fills again from our cpu copy
+      for ( const auto pool : { D3DPOOL_MANAGED, D3DPOOL_DEFAULT } )
+      {
+        if ( this->create_vertex_buffers ( vertices, D3DUSAGE_WRITEONLY, pool ) &&
+             this->m_context->device ( )->CreateIndexBuffer ( static_cast< UINT > ( sizeof ( uint16_t ) * indices ), D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, pool, &this->m_index_buffer, nullptr ) >= 0 )
+        {
+          this->m_static_pool = pool;
+          break;
+        }
+
+        this->release_vertex_buffers ( );
+        this->release_index_buffer ( );
+      }
+
+      if ( !this->m_index_buffer )
+        return false;
+
+      uint16_t *indx;
+
+      if ( !this->upload_vertices ( 0, this->m_vtxs.m_size, ALL_STREAMS, 0 ) || this->m_index_buffer->Lock ( 0, static_cast< UINT > ( this->m_idxs.m_size * sizeof ( uint16_t ) ), ( void ** ) &indx, 0 ) < 0 )
+        return false;
 
-      // we can just memcpy these
-      memcpy ( vert, this->m_vtxs.m_data.get ( ), sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size );
       memcpy ( indx, this->m_idxs.m_data.get ( ), sizeof ( uint16_t ) * this->m_idxs.m_size );
 
-      // unlock and ret
-      this->m_vertex_buffer->Unlock ( );
-      this->m_index_buffer->Unlock ( );
+      this->m_index_buffer->Unlock ( );
+
+      this->m_static = true;
+      this->m_update = this->m_realloc_vtx = this->m_realloc_idx = false;
+      this->m_uploaded_vtxs = this->m_vtxs.m_size;
+      this->m_uploaded_idxs = this->m_idxs.m_size;
+      this->reset_dirty ( );
+
+      return true;
+    }
+
+    /// <summary>
+    /// frees the cpu copy of a baked queue. only possible if it was baked into managed buffers, as default pool buffers need it to be restored after device resets.
+    /// handles can't be patched afterwards
+    /// </summary>
+    /// <returns>true if the cpu copy was freed, false otherwise</returns>
+    bool release_staging ( ) noexcept
+    {
+      if ( !this->m_static || this->m_static_pool != D3DPOOL_MANAGED )
+        return false;
+
+      // sizes are kept, they're still needed to draw
+      this->m_vtxs.m_data.reset ( );
+      this->m_idxs.m_data.reset ( );
+
+      return true;
+    }
+
+    /// <summary>
+    /// wipes data from local buffers
+    /// </summary>
+    void clear ( ) noexcept
+    {
+      // baked queues turn back into regular ones, their buffers get recreated as dynamic ones on the next upload
+      if ( this->m_static )
+      {
+        this->m_static = false;
+        this->release_vertex_buffers ( );
+        this->release_index_buffer ( );
+        this->m_realloc_vtx = this->m_realloc_idx = true;
+
+        if ( !this->m_vtxs.m_data )
+          this->m_vtxs.m_data = detail::make_buffer< uint8_t > ( this->m_resource, sizeof ( daisy_vtx_t ) * this->m_vtxs.m_capacity );
+
+        if ( !this->m_idxs.m_data )
+          this->m_idxs.m_data = detail::make_buffer< uint8_t > ( this->m_resource, sizeof ( uint16_t ) * this->m_idxs.m_capacity );
+      }
+
+      // the gpu might still be drawing from the old contents, next upload starts over in a discarded buffer
+      this->m_uploaded_vtxs = this->m_uploaded_idxs = 0;
+
+      c_drawlist::clear ( );
+    }
+
+    /// <summary>
+    /// replaces everything in the queue with a snapshot, see c_drawlist::adopt_snapshot. baked queues have to be cleared first
+    /// </summary>
+    /// <typeparam name="fn_t">callable turning an id back into a texture</typeparam>
+    /// <param name="blob">blob made by save_snapshot(), eg. a c_snapshotfile</param>
+    /// <param name="size">size of blob in bytes</param>
+    /// <param name="handle">called for every id stored in the blob</param>
+    /// <returns>true on success, false otherwise</returns>
+    template < typename fn_t >
+    [[nodiscard]] bool adopt_snapshot ( void *blob, const size_t size, fn_t &&handle )
+    {
+      if ( this->m_static || !c_drawlist::adopt_snapshot ( blob, size, handle ) )
+        return false;
+
+      this->m_uploaded_vtxs = this->m_uploaded_idxs = 0;
+
+      return true;
+    }
+
+    /// <summary>
+    /// called on device reset (pre/post)
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    {
+      // managed buffers survive resets on their own
+      if ( this->m_static && this->m_static_pool == D3DPOOL_MANAGED )
+        return true;
+
+      if ( !pre_reset )
+      {
+        if ( this->m_static )
+          return this->bake ( );
+
+        // recreated buffers are empty
+        this->m_update = true;
+        this->m_uploaded_vtxs = this->m_uploaded_idxs = 0;
+
+        // our ranges are kept, the pool may just not be reset yet. in that case its buffers get referenced on the next flush
+        if ( this->m_pool )
+        {
+          this->m_pool_vtxs_used = this->m_pool_idxs_used = false;
+          this->reference_pool_buffers ( );
+          return true;
+        }
+
+        return this->create ( this->m_vtxs.m_capacity, this->m_idxs.m_capacity, this->m_layout );
+      }
+      else
+      {
+        this->release_vertex_buffers ( );
+        this->release_index_buffer ( );
+      }
+
+      return true;
+    }
+
+    /// <summary>
+    /// copies data from local buffer to d3d9 buffers
+    /// </summary>
+    void update ( ) noexcept
+    {
+      if ( !this->m_context->device ( ) )
+        return;
+
+      // checking realloc
+      if ( this->m_realloc_vtx )
+      {
+        // pooled queues move to a bigger range of the shared buffers instead
+        if ( this->m_pool )
+        {
+          if ( !this->allocate_pool_vertices ( ) )
+            return;
+        }
+        else
+        {
+          this->release_vertex_buffers ( );
+
+          if ( !this->create_vertex_buffers ( this->m_vtxs.m_capacity ) )
+            return;
+        }
+
+        this->m_realloc_vtx = false;
+        this->m_uploaded_vtxs = 0;
+      }
+
+      if ( this->m_realloc_idx )
+      {
+        if ( this->m_pool )
+        {
+          if ( !this->allocate_pool_indices ( ) )
+            return;
+        }
+        else
+        {
+          this->release_index_buffer ( );
+
+          if ( this->m_context->device ( )->CreateIndexBuffer ( static_cast< UINT > ( this->m_idxs.m_capacity * sizeof ( uint16_t ) ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &this->m_index_buffer, nullptr ) < 0 )
+            return;
+        }
+
+        this->m_realloc_idx = false;
+        this->m_uploaded_idxs = 0;
+      }
+
+      // pushes only ever append, so whatever the gpu already has stays valid until the queue is cleared. in that case we only copy what was
+      // appended since, into a part of the buffer the gpu isn't using yet. otherwise everything gets copied into a discarded buffer.
+      // discarding shared buffers would throw away the other queues' data, so pooled queues move to a new range of the pool instead,
+      // the old one is only reused once the gpu is done with it
+      const DWORD rewrite_flags = this->m_pool ? D3DLOCK_NOOVERWRITE : D3DLOCK_DISCARD;
+      if ( this->m_uploaded_vtxs && this->m_uploaded_vtxs <= this->m_vtxs.m_size )
+      {
+        if ( this->is_dirty ( ) )
+          this->update_dirty ( );
+
+        if ( this->m_vtxs.m_size > this->m_uploaded_vtxs && !this->upload_vertices ( this->m_uploaded_vtxs, this->m_vtxs.m_size - this->m_uploaded_vtxs, ALL_STREAMS, D3DLOCK_NOOVERWRITE ) )
+          return;
+      }
+      else
+      {
+        if ( this->m_pool && this->m_pool_vtxs_used && this->m_vtxs.m_size && !this->allocate_pool_vertices ( ) )
+          return;
+
+        if ( !this->upload_vertices ( 0, this->m_vtxs.m_size, ALL_STREAMS, rewrite_flags ) )
+          return;
+
+        // patches went up with everything else
+        this->reset_dirty ( );
+      }
+
+      this->m_uploaded_vtxs = this->m_vtxs.m_size;
+      this->m_pool_vtxs_used |= this->m_vtxs.m_size != 0;
+
+      // indices we can just memcpy
+      const bool append_idxs = this->m_uploaded_idxs && this->m_uploaded_idxs <= this->m_idxs.m_size;
+      const uint32_t first_idx = append_idxs ? this->m_uploaded_idxs : 0;
+
+      if ( this->m_idxs.m_size > first_idx )
+      {
+        uint16_t *indx;
+
+        if ( this->m_pool && this->m_pool_idxs_used && !append_idxs && !this->allocate_pool_indices ( ) )
+          return;
+
+        if ( this->m_index_buffer->Lock ( static_cast< UINT > ( ( this->m_pool_idx_first + first_idx ) * sizeof ( uint16_t ) ), static_cast< UINT > ( ( this->m_idxs.m_size - first_idx ) * sizeof ( uint16_t ) ), ( void ** ) &indx, append_idxs ? D3DLOCK_NOOVERWRITE : rewrite_flags ) < 0 )
+          return;
+
+        memcpy ( indx, reinterpret_cast< uint16_t * > ( this->m_idxs.m_data.get ( ) ) + first_idx, sizeof ( uint16_t ) * ( this->m_idxs.m_size - first_idx ) );
+
+        // unlock and ret
+        this->m_index_buffer->Unlock ( );
+      }
+
+      this->m_uploaded_idxs = this->m_idxs.m_size;
+      this->m_pool_idxs_used |= this->m_idxs.m_size != 0;
+
+      // we no longer need to update
+      this->m_update = false;
+    }
+
+    /// <summary>
+    /// flushes vertices and indices to d3d9 buffer if an update is required. call this early in the frame (eg. right after the queue is filled)
+    /// so that flushing it later on only has to submit draw calls
+    /// </summary>
+    /// <returns>true if queue has anything to draw, false otherwise</returns>
+    bool prepare ( ) noexcept
+    {
+      if ( this->m_drawcalls.empty ( ) )
+        return false;
+
+      // references to pool buffers are dropped on resets
+      if ( this->m_pool && !this->reference_pool_buffers ( ) )
+        return false;
+
+      // modify buffers only if required, baked queues only ever get patched
+      if ( this->m_update && !this->m_static )
+      {
+        this->update ( );
+
+        // nothing valid to draw from if the upload failed (eg. the pool is full)
+        if ( this->m_update )
+          return false;
+      }
+      else if ( this->is_dirty ( ) )
+        this->update_dirty ( );
+
+      return true;
+    }
+
+    /// <summary>
+    /// prepares several queues, see prepare
+    /// </summary>
+    /// <param name="queues">queues to prepare</param>
+    static void upload_all ( const stl::initializer_list< c_renderqueue * > queues ) noexcept
+    {
+      for ( const auto queue : queues )
+        queue->prepare ( );
+    }
+
+    /// <summary>
+    /// flushes vertices and indices to d3d9 buffer if an update is required and actually draws primitives. if the queue was prepared and not
+    /// modified since, this only submits draw calls
+    /// </summary>
+    void flush ( ) noexcept
+    {
+      this->flush_ex ( true );
+    }
+
+    /// <summary>
+    /// flushes several queues in order. consecutive queues created in the same c_bufferpool only bind its buffers once
+    /// </summary>
+    /// <param name="queues">queues to flush</param>
+    static void flush_all ( const stl::initializer_list< c_renderqueue * > queues ) noexcept
+    {
+      const c_bufferpool *bound = nullptr;
+
+      for ( const auto queue : queues )
+        if ( queue->flush_ex ( !queue->m_pool || queue->m_pool != bound ) )
+          bound = queue->m_pool;
+    }
+    /// <summary>
+    /// get layout of vertices on the gpu
+    /// </summary>
+    /// <returns>vertex layout</returns>
+    daisy_vertex_layout layout ( ) const noexcept
+    {
+      return this->m_layout;
+    }
+
+    /// <summary>
+    /// check if queue was baked into write-once buffers
+    /// </summary>
+    /// <returns>true if queue is baked</returns>
+    bool is_static ( ) const noexcept
+    {
+      return this->m_static;
+    }
+  };
+
+  class c_doublebuffer_queue : public c_daisy_resettable_object
+  {
+  private:
+    c_renderqueue m_front_queue, m_back_queue;
+    stl::atomic< bool > m_swap_drawlists;
+
+  public:
+    c_doublebuffer_queue ( c_daisy_context &context = daisy_t::s_context ) noexcept
+        : c_daisy_resettable_object ( context ), m_front_queue ( context ), m_back_queue ( context ), m_swap_drawlists ( false )
+    {
+    }
+
+    /// <summary>
+    /// initializes current queue by initializing vertex and index buffers
+    /// </summary>
+    /// <param name="max_verts">max capacity of vertex buffer</param>
+    /// <param name="max_indices">max capacity of index buffer</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t max_verts = 32767, const uint32_t max_indices = 65535 ) noexcept
+    {
+      if ( !this->m_front_queue.create ( max_verts, max_indices ) )
+        return false;
+
+      if ( !this->m_back_queue.create ( max_verts, max_indices ) )
+        return false;
+
+      return true;
+    }
+
+    /// <summary>
+    /// called on device reset (pre/post)
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    {
+      return this->m_front_queue.reset ( pre_reset ) && this->m_back_queue.reset ( pre_reset );
+    }
+
+    /// <summary>
+    /// swap back and front drawlists
+    /// </summary>
+    void swap ( ) noexcept
+    {
+      this->m_swap_drawlists = !this->m_swap_drawlists;
+    }
+
+    /// <summary>
+    /// access currently safe render queue
+    /// </summary>
+    /// <returns>queue</returns>
+    c_renderqueue *queue ( ) noexcept
+    {
+      return ( !this->m_swap_drawlists ? &this->m_front_queue : &this->m_back_queue );
+    }
+
+    /// <summary>
+    /// uploads currently filled queue ahead of flushing it, see c_renderqueue::prepare
+    /// </summary>
+    /// <returns>true if queue has anything to draw, false otherwise</returns>
+    bool prepare ( ) noexcept
+    {
+      return this->m_swap_drawlists ? this->m_front_queue.prepare ( ) : this->m_back_queue.prepare ( );
+    }
+
+    /// <summary>
+    /// flushes currently filled queue
+    /// </summary>
+    void flush ( )
+    {
+      this->m_swap_drawlists ? this->m_front_queue.flush ( ) : this->m_back_queue.flush ( );
+    }
+  };
+
+  // batch of identical markers (scatter plots, map markers etc.), drawn as point sprites or hardware instances where possible.
+  // each marker only costs 12 bytes (position and color) on the cpu side and 12-20 bytes of upload instead of 4 vertices and 6 indices
+  class c_markerbatch : public c_daisy_resettable_object
+  {
+  private:
+    struct marker_t
+    {
+      float m_pos[ 2 ];
+      D3DCOLOR m_col;
+    };
+
+    // point sprite vertex
+    struct sprite_vtx_t
+    {
+      float m_pos[ 4 ]; // x,y,z,rhw
+      D3DCOLOR m_col;
+    };
+
+    constexpr static inline DWORD SPRITE_FVF = D3DFVF_XYZRHW | D3DFVF_DIFFUSE;
+    constexpr static inline uint32_t DISC_SIZE = 64;
+
+    stl::pmr::vector< marker_t > m_markers;
+
+    // instance or point sprite data
+    IDirect3DVertexBuffer9 *m_vertex_buffer;
+    uint32_t m_vertex_capacity;
+
+    // static quad for instancing
+    IDirect3DVertexBuffer9 *m_quad_buffer;
+    IDirect3DIndexBuffer9 *m_quad_indices;
+    IDirect3DVertexDeclaration9 *m_declaration;
+    IDirect3DVertexShader9 *m_vertex_shader;
+    IDirect3DPixelShader9 *m_pixel_shader;
+
+    // built-in anti-aliased disc, used when no marker texture is set
+    IDirect3DTexture9 *m_disc_texture;
+
+    // marker shape
+    IDirect3DTexture9 *m_texture_handle;
+    point_t m_uv_mins, m_uv_maxs, m_size;
+
+    // fallback for devices without point sprites or instancing
+    c_renderqueue m_quads;
+
+    float m_max_point_size;
+    bool m_instancing, m_update;
+
+  private:
+    /// <summary>
+    /// releases all d3d9 resources
+    /// </summary>
+    void release ( ) noexcept
+    {
+      const auto release_one = [ ] ( auto *&resource ) {
+        if ( resource )
+        {
+          resource->Release ( );
+          resource = nullptr;
+        }
+      };
+
+      release_one ( this->m_vertex_buffer );
+      release_one ( this->m_quad_buffer );
+      release_one ( this->m_quad_indices );
+      release_one ( this->m_declaration );
+      release_one ( this->m_vertex_shader );
+      release_one ( this->m_pixel_shader );
+      release_one ( this->m_disc_texture );
+
+      this->m_vertex_capacity = 0;
+    }
+
+    /// <summary>
+    /// creates d3d9 resources
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool create_ex ( ) noexcept
+    {
+      if ( !this->m_context->device ( ) )
+        return false;
+
+      this->release ( );
+
+      const D3DCAPS9 &caps = this->m_context->caps ( );
+
+      this->m_max_point_size = caps.MaxPointSize;
+      this->m_instancing = caps.VertexShaderVersion >= D3DVS_VERSION ( 3, 0 ) && caps.PixelShaderVersion >= D3DPS_VERSION ( 3, 0 );
+
+      if ( !this->create_disc ( ) )
+        return false;
+
+      if ( this->m_instancing )
+      {
+        // corners are centered around 0 so the shader can scale them by marker size directly
+        const float corners[] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f };
+        const uint16_t indices[] = { 0, 1, 3, 3, 2, 1 };
+
+        const D3DVERTEXELEMENT9 elements[] = {
+            { 0, 0, D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
+            { 1, 0, D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 1 },
+            { 1, 8, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 0 },
+            D3DDECL_END ( ) };
+
+        void *data;
+
+        // any failure here just means we fall back to point sprites or quads
+        this->m_instancing = this->m_context->device ( )->CreateVertexBuffer ( sizeof ( corners ), D3DUSAGE_WRITEONLY, 0, D3DPOOL_DEFAULT, &this->m_quad_buffer, nullptr ) == D3D_OK &&
+                             this->m_context->device ( )->CreateIndexBuffer ( sizeof ( indices ), D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &this->m_quad_indices, nullptr ) == D3D_OK &&
+                             this->m_context->device ( )->CreateVertexDeclaration ( elements, &this->m_declaration ) == D3D_OK &&
+                             this->m_context->device ( )->CreateVertexShader ( detail::MARKER_VS, &this->m_vertex_shader ) == D3D_OK &&
+                             this->m_context->device ( )->CreatePixelShader ( detail::TEXTURED_PS, &this->m_pixel_shader ) == D3D_OK;
+
+        if ( this->m_instancing && this->m_quad_buffer->Lock ( 0, 0, &data, 0 ) == D3D_OK )
+        {
+          memcpy ( data, corners, sizeof ( corners ) );
+          this->m_quad_buffer->Unlock ( );
+        }
+
+        if ( this->m_instancing && this->m_quad_indices->Lock ( 0, 0, &data, 0 ) == D3D_OK )
+        {
+          memcpy ( data, indices, sizeof ( indices ) );
+          this->m_quad_indices->Unlock ( );
+        }
+      }
+
+      this->m_update = true;
+
+      return true;
+    }
+
+    /// <summary>
+    /// rasterizes built-in disc marker texture
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool create_disc ( ) noexcept
+    {
+      if ( this->m_context->device ( )->CreateTexture ( DISC_SIZE, DISC_SIZE, 1, D3DUSAGE_DYNAMIC, D3DFMT_A8R8G8B8, D3DPOOL_DEFAULT, &this->m_disc_texture, nullptr ) != D3D_OK )
+        return false;
+
+      stl::array< float, DISC_SIZE * DISC_SIZE + 2 > acc { };
+
+      // leave a pixel of transparent border so edges stay smooth when filtered
+      constexpr int segments = 64;
+      constexpr float radius = DISC_SIZE * 0.5f - 1.f;
+
+      for ( int i = 0; i < segments; ++i )
+      {
+        const float a1 = 2.f * detail::PI * static_cast< float > ( i ) / segments;
+        const float a2 = 2.f * detail::PI * static_cast< float > ( i + 1 ) / segments;
+
+        detail::accumulate_line ( acc.data ( ), DISC_SIZE, DISC_SIZE,
+                                  { DISC_SIZE * 0.5f + radius * stl::cosf ( a1 ), DISC_SIZE * 0.5f + radius * stl::sinf ( a1 ) },
+                                  { DISC_SIZE * 0.5f + radius * stl::cosf ( a2 ), DISC_SIZE * 0.5f + radius * stl::sinf ( a2 ) } );
+      }
+
+      D3DLOCKED_RECT locked_rect;
+      if ( this->m_disc_texture->LockRect ( 0, &locked_rect, nullptr, D3DLOCK_DISCARD ) != D3D_OK )
+        return false;
+
+      float coverage = 0.f;
+      for ( uint32_t y = 0; y < DISC_SIZE; ++y )
+      {
+        uint32_t *dst = reinterpret_cast< uint32_t * > ( static_cast< uint8_t * > ( locked_rect.pBits ) + locked_rect.Pitch * y );
+
+        for ( uint32_t x = 0; x < DISC_SIZE; ++x )
+        {
+          coverage += acc[ y * DISC_SIZE + x ];
+
+          const float alpha = stl::fabsf ( coverage );
+          dst[ x ] = ( static_cast< uint32_t > ( ( alpha < 1.f ? alpha : 1.f ) * 255.f + 0.5f ) << 24 ) | 0x00ffffff;
+        }
+      }
+
+      this->m_disc_texture->UnlockRect ( 0 );
+
+      return true;
+    }
+
+    /// <summary>
+    /// picks how markers get drawn
+    /// </summary>
+    /// <returns>draw mode</returns>
+    daisy_marker_mode pick_mode ( ) const noexcept
+    {
+      const bool whole_texture = !this->m_texture_handle || ( this->m_uv_mins.x == 0.f && this->m_uv_mins.y == 0.f && this->m_uv_maxs.x == 1.f && this->m_uv_maxs.y == 1.f );
+
+      // point sprites always map the whole texture and are square
+      if ( whole_texture && this->m_size.x == this->m_size.y && this->m_size.x <= this->m_max_point_size )
+        return daisy_marker_mode::MARKER_POINTSPRITE;
+
+      if ( this->m_instancing )
+        return daisy_marker_mode::MARKER_INSTANCED;
+
+      return daisy_marker_mode::MARKER_QUADS;
+    }
+
+    /// <summary>
+    /// uploads markers to the d3d9 buffer in the layout used by given mode
+    /// </summary>
+    /// <param name="mode">draw mode</param>
+    /// <returns>true on success, false otherwise</returns>
+    bool upload ( const daisy_marker_mode mode ) noexcept
+    {
+      const auto count = static_cast< uint32_t > ( this->m_markers.size ( ) );
+
+      // grow buffer, sized for the bigger of both layouts
+      if ( count > this->m_vertex_capacity || !this->m_vertex_buffer )
+      {
+        if ( this->m_vertex_buffer )
+          this->m_vertex_buffer->Release ( );
+
+        this->m_vertex_buffer = nullptr;
+        this->m_vertex_capacity = 64;
+
+        while ( this->m_vertex_capacity < count )
+          this->m_vertex_capacity *= 2;
+
+        if ( this->m_context->device ( )->CreateVertexBuffer ( this->m_vertex_capacity * sizeof ( sprite_vtx_t ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY | D3DUSAGE_POINTS, 0, D3DPOOL_DEFAULT, &this->m_vertex_buffer, nullptr ) != D3D_OK )
+          return false;
+      }
+
+      const uint32_t stride = mode == daisy_marker_mode::MARKER_POINTSPRITE ? sizeof ( sprite_vtx_t ) : sizeof ( marker_t );
+
+      void *data;
+      if ( this->m_vertex_buffer->Lock ( 0, count * stride, &data, D3DLOCK_DISCARD ) != D3D_OK )
+        return false;
+
+      if ( mode == daisy_marker_mode::MARKER_POINTSPRITE )
+      {
+        auto vtx = static_cast< sprite_vtx_t * > ( data );
+
+        for ( const auto &marker : this->m_markers )
+          *vtx++ = sprite_vtx_t { { marker.m_pos[ 0 ], marker.m_pos[ 1 ], 0.f, 1.f }, marker.m_col };
+      }
+      // instance data is uploaded as-is
+      else
+        memcpy ( data, this->m_markers.data ( ), count * sizeof ( marker_t ) );
+
+      this->m_vertex_buffer->Unlock ( );
+
+      return true;
+    }
+
+  public:
+    c_markerbatch ( c_daisy_context &context = daisy_t::s_context ) noexcept
+        : c_daisy_resettable_object ( context ), m_markers ( context.resource ( ) ), m_vertex_buffer ( nullptr ), m_vertex_capacity ( 0 ), m_quad_buffer ( nullptr ), m_quad_indices ( nullptr ), m_declaration ( nullptr ), m_vertex_shader ( nullptr ), m_pixel_shader ( nullptr ),
+          m_disc_texture ( nullptr ), m_texture_handle ( nullptr ), m_uv_mins ( { 0.f, 0.f } ), m_uv_maxs ( { 1.f, 1.f } ), m_size ( { 4.f, 4.f } ), m_quads ( context ), m_max_point_size ( 0.f ), m_instancing ( false ), m_update ( true )
+    {
+    }
+
+    // disallow copying
+    c_markerbatch ( const c_markerbatch & ) = delete;
+    c_markerbatch &operator= ( const c_markerbatch & ) = delete;
+
+    /// <summary>
+    /// creates marker batch
+    /// </summary>
+    /// <param name="max_markers">initial marker capacity (grows as needed)</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t max_markers = 4096 ) noexcept
+    {
+      this->m_markers.reserve ( max_markers );
+
+      return this->create_ex ( ) && this->m_quads.create ( );
+    }
+
+    /// <summary>
+    /// called on device reset (pre/post)
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    {
+      if ( !pre_reset )
+        return this->create_ex ( ) && this->m_quads.reset ( false );
+
+      this->release ( );
+
+      return this->m_quads.reset ( true );
+    }
+
+    /// <summary>
+    /// sets marker shape and size, shared by all markers of the batch
+    /// </summary>
+    /// <param name="size">size of markers in pixels</param>
+    /// <param name="texture_handle">texture handle (by default nullptr, means the built-in disc is used)</param>
+    /// <param name="uv_mins">uv mins of marker in texture (by default {0, 0})</param>
+    /// <param name="uv_maxs">uv maxs of marker in texture (by default {1, 1})</param>
+    void set_marker ( const point_t &size, IDirect3DTexture9 *texture_handle = nullptr, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } ) noexcept
+    {
+      this->m_size = size;
+      this->m_texture_handle = texture_handle;
+      this->m_uv_mins = uv_mins;
+      this->m_uv_maxs = uv_maxs;
+
+      this->m_update = true;
+    }
+
+    /// <summary>
+    /// push marker to batch
+    /// </summary>
+    /// <param name="position">center of marker</param>
+    /// <param name="col">color of marker</param>
+    void push ( const point_t &position, const color_t &col )
+    {
+      this->m_markers.push_back ( marker_t { { position.x, position.y }, col.bgra } );
+      this->m_update = true;
+    }
+
+    /// <summary>
+    /// wipes all markers
+    /// </summary>
+    void clear ( ) noexcept
+    {
+      this->m_markers.clear ( );
+      this->m_quads.clear ( );
+      this->m_update = true;
+    }
+
+    /// <summary>
+    /// uploads markers if needed and draws them
+    /// </summary>
+    void flush ( ) noexcept
+    {
+      if ( this->m_markers.empty ( ) || !this->m_context->device ( ) )
+        return;
+
+      const auto mode = this->pick_mode ( );
+      const auto count = static_cast< uint32_t > ( this->m_markers.size ( ) );
+      IDirect3DTexture9 *texture_handle = this->m_texture_handle ? this->m_texture_handle : this->m_disc_texture;
+
+      if ( mode == daisy_marker_mode::MARKER_QUADS )
+      {
+        if ( this->m_update )
+        {
+          this->m_quads.clear ( );
+
+          for ( const auto &marker : this->m_markers )
+          {
+            color_t col;
+            col.bgra = marker.m_col;
+
+            this->m_quads.push_filled_rectangle ( { marker.m_pos[ 0 ] - this->m_size.x * 0.5f, marker.m_pos[ 1 ] - this->m_size.y * 0.5f }, this->m_size, col, texture_handle, this->m_uv_mins, this->m_uv_maxs );
+          }
+
+          this->m_update = false;
+        }
+
+        this->m_quads.flush ( );
+        return;
+      }
+
+      if ( this->m_update )
+      {
+        if ( !this->upload ( mode ) )
+          return;
+
+        this->m_update = false;
+      }
+
+      this->m_context->device ( )->SetTexture ( 0, texture_handle );
+
+      if ( mode == daisy_marker_mode::MARKER_POINTSPRITE )
+      {
+        this->m_context->device ( )->SetRenderState ( D3DRS_POINTSPRITEENABLE, TRUE );
+        this->m_context->device ( )->SetRenderState ( D3DRS_POINTSCALEENABLE, FALSE );
+        this->m_context->device ( )->SetRenderState ( D3DRS_POINTSIZE, detail::float_bits ( this->m_size.x ) );
+        this->m_context->device ( )->SetRenderState ( D3DRS_POINTSIZE_MIN, detail::float_bits ( 0.f ) );
+        this->m_context->device ( )->SetRenderState ( D3DRS_POINTSIZE_MAX, detail::float_bits ( this->m_max_point_size ) );
+
+        this->m_context->device ( )->SetStreamSource ( 0, this->m_vertex_buffer, 0, sizeof ( sprite_vtx_t ) );
+        this->m_context->device ( )->SetFVF ( SPRITE_FVF );
+
+        // keep draws within what every driver accepts as a primitive count
+        for ( uint32_t first = 0; first < count; first += 0xffff )
+          this->m_context->device ( )->DrawPrimitive ( D3DPT_POINTLIST, first, ( count - first ) < 0xffff ? ( count - first ) : 0xffff );
+
+        this->m_context->device ( )->SetRenderState ( D3DRS_POINTSPRITEENABLE, FALSE );
+      }
+      else
+      {
+        D3DVIEWPORT9 viewport;
+        this->m_context->device ( )->GetViewport ( &viewport );
+
+        const float width = static_cast< float > ( viewport.Width ), height = static_cast< float > ( viewport.Height );
+        const float constants[ 4 ][ 4 ] = {
+            { 2.f / width, -2.f / height, 1.f / width - 1.f, 1.f - 1.f / height },
+            { this->m_size.x, this->m_size.y, 0.f, 0.f },
+            { ( this->m_uv_mins.x + this->m_uv_maxs.x ) * 0.5f, ( this->m_uv_mins.y + this->m_uv_maxs.y ) * 0.5f, this->m_uv_maxs.x - this->m_uv_mins.x, this->m_uv_maxs.y - this->m_uv_mins.y },
+            { 0.f, 0.f, 0.f, 1.f } };
+
+        this->m_context->device ( )->SetVertexDeclaration ( this->m_declaration );
+        this->m_context->device ( )->SetVertexShader ( this->m_vertex_shader );
+        this->m_context->device ( )->SetPixelShader ( this->m_pixel_shader );
+        this->m_context->device ( )->SetVertexShaderConstantF ( 0, &constants[ 0 ][ 0 ], 4 );
+
+        this->m_context->device ( )->SetStreamSource ( 0, this->m_quad_buffer, 0, sizeof ( float ) * 2 );
+        this->m_context->device ( )->SetStreamSourceFreq ( 0, D3DSTREAMSOURCE_INDEXEDDATA | count );
+        this->m_context->device ( )->SetStreamSource ( 1, this->m_vertex_buffer, 0, sizeof ( marker_t ) );
+        this->m_context->device ( )->SetStreamSourceFreq ( 1, D3DSTREAMSOURCE_INSTANCEDATA | 1u );
+        this->m_context->device ( )->SetIndices ( this->m_quad_indices );
+
+        this->m_context->device ( )->DrawIndexedPrimitive ( D3DPT_TRIANGLELIST, 0, 0, 4, 0, 2 );
+
+        // back to regular drawing
+        this->m_context->device ( )->SetStreamSourceFreq ( 0, 1 );
+        this->m_context->device ( )->SetStreamSourceFreq ( 1, 1 );
+        this->m_context->device ( )->SetStreamSource ( 1, nullptr, 0, 0 );
+        this->m_context->device ( )->SetVertexShader ( nullptr );
+        this->m_context->device ( )->SetPixelShader ( nullptr );
+      }
+    }
+
+    // getters
+
+    /// <summary>
+    /// get number of markers in batch
+    /// </summary>
+    /// <returns>number of markers</returns>
+    uint32_t size ( ) const noexcept
+    {
+      return static_cast< uint32_t > ( this->m_markers.size ( ) );
+    }
+
+    /// <summary>
+    /// get mode markers are drawn with on the next flush
+    /// </summary>
+    /// <returns>draw mode</returns>
+    daisy_marker_mode mode ( ) const noexcept
+    {
+      return this->pick_mode ( );
+    }
+  };
+
+  // queue for rectangles, sprites and glyphs that uploads one compact record per quad and expands it in a vertex shader (hardware instancing, needs vs_3_0/ps_3_0)
+  // a quad costs 36 bytes instead of 4 vertices and 6 indices (124 bytes) in c_renderqueue; devices without instancing fall back to an internal c_renderqueue
+  class c_instancedqueue : public c_daisy_resettable_object
+  {
+  private:
+    struct instance_t
+    {
+      float m_rect[ 4 ]; // x,y,w,h
+      float m_uv[ 4 ];   // u1,v1,u2,v2
+      D3DCOLOR m_col;
+    };
+
+    // run of instances sharing a texture
+    struct batch_t
+    {
+      IDirect3DTexture9 *m_texture_handle;
+      uint32_t m_first, m_count;
+    };
+
+    stl::pmr::vector< instance_t > m_instances;
+    stl::pmr::vector< batch_t > m_batches;
+
+    IDirect3DVertexBuffer9 *m_instance_buffer;
+    uint32_t m_instance_capacity;
+
+    // static quad
+    IDirect3DVertexBuffer9 *m_quad_buffer;
+    IDirect3DIndexBuffer9 *m_quad_indices;
+    IDirect3DVertexDeclaration9 *m_declaration;
+    IDirect3DVertexShader9 *m_vertex_shader;
+    IDirect3DPixelShader9 *m_pixel_shader;
+
+    // fallback for devices without instancing
+    c_renderqueue m_quads;
+
+    bool m_instancing, m_update;
+
+  private:
+    /// <summary>
+    /// releases all d3d9 resources
+    /// </summary>
+    void release ( ) noexcept
+    {
+      const auto release_one = [ ] ( auto *&resource ) {
+        if ( resource )
+        {
+          resource->Release ( );
+          resource = nullptr;
+        }
+      };
+
+      release_one ( this->m_instance_buffer );
+      release_one ( this->m_quad_buffer );
+      release_one ( this->m_quad_indices );
+      release_one ( this->m_declaration );
+      release_one ( this->m_vertex_shader );
+      release_one ( this->m_pixel_shader );
+
+      this->m_instance_capacity = 0;
+    }
+
+    /// <summary>
+    /// creates d3d9 resources
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool create_ex ( ) noexcept
+    {
+      if ( !this->m_context->device ( ) )
+        return false;
+
+      this->release ( );
+
+      const D3DCAPS9 &caps = this->m_context->caps ( );
+
+      this->m_instancing = caps.VertexShaderVersion >= D3DVS_VERSION ( 3, 0 ) && caps.PixelShaderVersion >= D3DPS_VERSION ( 3, 0 );
+      this->m_update = true;
+
+      if ( !this->m_instancing )
+        return true;
+
+      const float corners[] = { 0.f, 0.f, 1.f, 0.f, 1.f, 1.f, 0.f, 1.f };
+      const uint16_t indices[] = { 0, 1, 3, 3, 2, 1 };
+
+      const D3DVERTEXELEMENT9 elements[] = {
+          { 0, 0, D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
+          { 1, 0, D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 1 },
+          { 1, 16, D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 2 },
+          { 1, 32, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 0 },
+          D3DDECL_END ( ) };
+
+      void *data;
+
+      // any failure here just means we fall back to regular quads
+      this->m_instancing = this->m_context->device ( )->CreateVertexBuffer ( sizeof ( corners ), D3DUSAGE_WRITEONLY, 0, D3DPOOL_DEFAULT, &this->m_quad_buffer, nullptr ) == D3D_OK &&
+                           this->m_context->device ( )->CreateIndexBuffer ( sizeof ( indices ), D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &this->m_quad_indices, nullptr ) == D3D_OK &&
+                           this->m_context->device ( )->CreateVertexDeclaration ( elements, &this->m_declaration ) == D3D_OK &&
+                           this->m_context->device ( )->CreateVertexShader ( detail::QUAD_VS, &this->m_vertex_shader ) == D3D_OK &&
+                           this->m_context->device ( )->CreatePixelShader ( detail::TEXTURED_PS, &this->m_pixel_shader ) == D3D_OK;
+
+      if ( this->m_instancing && this->m_quad_buffer->Lock ( 0, 0, &data, 0 ) == D3D_OK )
+      {
+        memcpy ( data, corners, sizeof ( corners ) );
+        this->m_quad_buffer->Unlock ( );
+      }
+
+      if ( this->m_instancing && this->m_quad_indices->Lock ( 0, 0, &data, 0 ) == D3D_OK )
+      {
+        memcpy ( data, indices, sizeof ( indices ) );
+        this->m_quad_indices->Unlock ( );
+      }
+
+      if ( !this->m_instancing )
+        this->release ( );
+
+      return true;
+    }
+
+    /// <summary>
+    /// appends instance, merging it into the last batch if it uses the same texture
+    /// </summary>
+    /// <param name="instance">instance to append</param>
+    /// <param name="texture_handle">texture handle</param>
+    void append ( const instance_t &instance, IDirect3DTexture9 *texture_handle )
+    {
+      if ( this->m_batches.empty ( ) || this->m_batches.back ( ).m_texture_handle != texture_handle )
+        this->m_batches.push_back ( batch_t { texture_handle, static_cast< uint32_t > ( this->m_instances.size ( ) ), 0 } );
+
+      this->m_instances.push_back ( instance );
+      this->m_batches.back ( ).m_count++;
+
+      this->m_update = true;
+    }
+
+    /// <summary>
+    /// copies instances to d3d9 buffer
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool upload ( ) noexcept
+    {
+      const auto count = static_cast< uint32_t > ( this->m_instances.size ( ) );
+
+      if ( count > this->m_instance_capacity || !this->m_instance_buffer )
+      {
+        if ( this->m_instance_buffer )
+          this->m_instance_buffer->Release ( );
+
+        this->m_instance_buffer = nullptr;
+        this->m_instance_capacity = this->m_instance_capacity ? this->m_instance_capacity : 256;
+
+        while ( this->m_instance_capacity < count )
+          this->m_instance_capacity *= 2;
+
+        if ( this->m_context->device ( )->CreateVertexBuffer ( this->m_instance_capacity * sizeof ( instance_t ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, 0, D3DPOOL_DEFAULT, &this->m_instance_buffer, nullptr ) != D3D_OK )
+          return false;
+      }
+
+      void *data;
+      if ( this->m_instance_buffer->Lock ( 0, count * sizeof ( instance_t ), &data, D3DLOCK_DISCARD ) != D3D_OK )
+        return false;
+
+      memcpy ( data, this->m_instances.data ( ), count * sizeof ( instance_t ) );
+
+      this->m_instance_buffer->Unlock ( );
+
+      return true;
+    }
+
+  public:
+    c_instancedqueue ( c_daisy_context &context = daisy_t::s_context ) noexcept
+        : c_daisy_resettable_object ( context ), m_instances ( context.resource ( ) ), m_batches ( context.resource ( ) ), m_instance_buffer ( nullptr ), m_instance_capacity ( 0 ), m_quad_buffer ( nullptr ), m_quad_indices ( nullptr ), m_declaration ( nullptr ), m_vertex_shader ( nullptr ), m_pixel_shader ( nullptr ), m_quads ( context ),
+          m_instancing ( false ), m_update ( true )
+    {
+    }
+
+    // disallow copying
+    c_instancedqueue ( const c_instancedqueue & ) = delete;
+    c_instancedqueue &operator= ( const c_instancedqueue & ) = delete;
+
+    /// <summary>
+    /// creates instanced queue
+    /// </summary>
+    /// <param name="max_quads">initial quad capacity (grows as needed)</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool create ( const uint32_t max_quads = 4096 ) noexcept
+    {
+      this->m_instances.reserve ( max_quads );
+
+      if ( !this->create_ex ( ) )
+        return false;
+
+      // fallback queue is only needed without instancing
+      return this->m_instancing || this->m_quads.create ( max_quads * 4, max_quads * 6 );
+    }
+
+    /// <summary>
+    /// called on device reset (pre/post)
+    /// </summary>
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    {
+      if ( !pre_reset )
+        // the fallback queue keeps its (possibly grown) capacities
+        return this->create_ex ( ) && ( this->m_instancing || this->m_quads.reset ( false ) );
 
-      // we no longer need to update
-      this->m_update = false;
+      this->release ( );
+
+      return this->m_quads.reset ( true );
     }
 
     /// <summary>
-    /// flushes vertices and indices to d3d9 buffer if an update is required and actually draws primitives
+    /// wipes all quads
+    /// </summary>
+    void clear ( ) noexcept
+    {
+      this->m_instances.clear ( );
+      this->m_batches.clear ( );
+      this->m_quads.clear ( );
+
+      this->m_update = true;
+    }
+
+    /// <summary>
+    /// uploads quads if needed and draws them
     /// </summary>
     void flush ( ) noexcept
     {
-      if ( this->m_drawcalls.empty ( ) )
+      if ( this->m_instances.empty ( ) || !this->m_context->device ( ) )
         return;
 
-      // modify buffers only if required
-      if ( this->m_update )
-        this->update ( );
+      if ( !this->m_instancing )
+      {
+        if ( this->m_update )
+        {
+          this->m_quads.clear ( );
+
+          for ( const auto &batch : this->m_batches )
+          {
+            for ( uint32_t i = batch.m_first; i < batch.m_first + batch.m_count; ++i )
+            {
+              const auto &instance = this->m_instances[ i ];
 
-      daisy_t::s_device->SetStreamSource ( 0, this->m_vertex_buffer, 0, sizeof ( daisy_vtx_t ) );
-      daisy_t::s_device->SetIndices ( this->m_index_buffer );
-      daisy_t::s_device->SetFVF ( ( D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 ) );
+              color_t col;
+              col.bgra = instance.m_col;
 
-      uint32_t vertex_idx { 0 }, index_idx { 0 };
+              this->m_quads.push_quad ( { instance.m_rect[ 0 ], instance.m_rect[ 1 ] }, { instance.m_rect[ 0 ] + instance.m_rect[ 2 ], instance.m_rect[ 1 ] + instance.m_rect[ 3 ] }, col, batch.m_texture_handle,
+                                        { instance.m_uv[ 0 ], instance.m_uv[ 1 ] }, { instance.m_uv[ 2 ], instance.m_uv[ 3 ] } );
+            }
+          }
 
-      // render commands
-      for ( const auto &cmd : this->m_drawcalls )
+          this->m_update = false;
+        }
+
+        this->m_quads.flush ( );
+        return;
+      }
+
+      if ( this->m_update )
       {
-        // @todo: more proper support for shaders
-        switch ( cmd.m_kind )
-        {
-        case daisy_call_kind::CALL_TRI:
-          daisy_t::s_device->SetTexture ( 0, cmd.m_tri.m_texture_handle );
-          daisy_t::s_device->DrawIndexedPrimitive ( D3DPT_TRIANGLELIST, vertex_idx, 0, cmd.m_tri.m_vertices, index_idx, cmd.m_tri.m_primitives );
+        if ( !this->upload ( ) )
+          return;
 
-          vertex_idx += cmd.m_tri.m_vertices;
-          index_idx += cmd.m_tri.m_indices;
-          break;
-        case daisy_call_kind::CALL_VTXSHADER:
-          daisy_t::s_device->SetVertexShader ( reinterpret_cast< IDirect3DVertexShader9 * > ( cmd.m_shader.m_shader_handle ) );
-          break;
-        case daisy_call_kind::CALL_PIXSHADER:
-          daisy_t::s_device->SetPixelShader ( reinterpret_cast< IDirect3DPixelShader9 * > ( cmd.m_shader.m_shader_handle ) );
-          break;
-        case daisy_call_kind::CALL_SCISSOR: {
-          RECT r { static_cast< LONG > ( cmd.m_scissor.m_position.x ), static_cast< LONG > ( cmd.m_scissor.m_position.y ),
-                   static_cast< LONG > ( cmd.m_scissor.m_position.x + cmd.m_scissor.m_size.x ),
-                   static_cast< LONG > ( cmd.m_scissor.m_position.y + cmd.m_scissor.m_size.y ) };
+        this->m_update = false;
+      }
 
-          daisy_t::s_device->SetScissorRect ( &r );
-        }
-        break;
-        }
+      D3DVIEWPORT9 viewport;
+      this->m_context->device ( )->GetViewport ( &viewport );
+
+      const float width = static_cast< float > ( viewport.Width ), height = static_cast< float > ( viewport.Height );
+      const float constants[ 2 ][ 4 ] = {
+          { 2.f / width, -2.f / height, 1.f / width - 1.f, 1.f - 1.f / height },
+          { 0.f, 0.f, 0.f, 1.f } };
+
+      this->m_context->device ( )->SetVertexDeclaration ( this->m_declaration );
+      this->m_context->device ( )->SetVertexShader ( this->m_vertex_shader );
+      this->m_context->device ( )->SetPixelShader ( this->m_pixel_shader );
+      this->m_context->device ( )->SetVertexShaderConstantF ( 0, &constants[ 0 ][ 0 ], 2 );
+
+      this->m_context->device ( )->SetStreamSource ( 0, this->m_quad_buffer, 0, sizeof ( float ) * 2 );
+      this->m_context->device ( )->SetIndices ( this->m_quad_indices );
+      this->m_context->device ( )->SetStreamSourceFreq ( 1, D3DSTREAMSOURCE_INSTANCEDATA | 1u );
+
+      for ( const auto &batch : this->m_batches )
+      {
+        this->m_context->device ( )->SetTexture ( 0, batch.m_texture_handle );
+        this->m_context->device ( )->SetStreamSource ( 1, this->m_instance_buffer, batch.m_first * sizeof ( instance_t ), sizeof ( instance_t ) );
+        this->m_context->device ( )->SetStreamSourceFreq ( 0, D3DSTREAMSOURCE_INDEXEDDATA | batch.m_count );
+
+        this->m_context->device ( )->DrawIndexedPrimitive ( D3DPT_TRIANGLELIST, 0, 0, 4, 0, 2 );
       }
+
+      // back to regular drawing
+      this->m_context->device ( )->SetStreamSourceFreq ( 0, 1 );
+      this->m_context->device ( )->SetStreamSourceFreq ( 1, 1 );
+      this->m_context->device ( )->SetStreamSource ( 1, nullptr, 0, 0 );
+      this->m_context->device ( )->SetVertexShader ( nullptr );
+      this->m_context->device ( )->SetPixelShader ( nullptr );
     }
 
     /// <summary>
-    /// clips viewport to a certain rectangle
+    /// push filled rectangle to queue
     /// </summary>
     /// <param name="position">rectangle position</param>
     /// <param name="size">rectangle size</param>
-    void push_scissor ( point_t &position, point_t &size ) noexcept
+    /// <param name="col">rectangle color</param>
+    /// <param name="texture_handle">texture handle (by default nullptr, means no texture is applied)</param>
+    /// <param name="uv_mins">uv mins of rectangle in texture (by default {0, 0})</param>
+    /// <param name="uv_maxs">uv maxs of rectangle in texture (by default {1, 1})</param>
+    void push_filled_rectangle ( const point_t &position, const point_t &size, const color_t col, IDirect3DTexture9 *texture_handle = nullptr, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } )
     {
-      daisy_drawcall_t d { };
-      d.m_kind = daisy_call_kind::CALL_SCISSOR;
-      d.m_scissor.m_position = position;
-      d.m_scissor.m_size = size;
+      // snapped the same way as c_renderqueue::push_gradient_rectangle
+      const float x1 = stl::floorf ( position.x ), y1 = stl::floorf ( position.y );
+      const float x2 = stl::floorf ( position.x + size.x ), y2 = stl::floorf ( position.y + size.y );
 
-      this->m_drawcalls.push_back ( stl::move ( d ) );
+      this->append ( instance_t { { x1, y1, x2 - x1, y2 - y1 }, { uv_mins.x, uv_mins.y, uv_maxs.x, uv_maxs.y }, col.bgra }, texture_handle );
     }
 
     /// <summary>
-    /// push gradient rectangle to drawlist
+    /// push a string with a given font to queue
+    /// </summary>
+    /// <typeparam name="t">iteratable text container (only char and wchar_t accepted currently)</typeparam>
+    /// <param name="font">initialized c_fontwrapper instance</param>
+    /// <param name="position">position of text</param>
+    /// <param name="text">text to draw</param>
+    /// <param name="color">color of text to draw</param>
+    /// <param name="alignment">alignment of text to draw</param>
+    template < typename t = stl::string_view >
+    void push_text ( c_fontwrapper &font, const point_t &position, const t text, const color_t &color, uint16_t alignment = TEXT_ALIGN_DEFAULT )
+    {
+      this->m_instances.reserve ( this->m_instances.size ( ) + text.size ( ) );
+
+      font.for_each_glyph ( position, text, alignment, [ & ] ( const point_t &glyph_position, const point_t &glyph_size, const uv_t &coords ) {
+        this->append ( instance_t { { glyph_position.x - 0.5f, glyph_position.y - 0.5f, glyph_size.x, glyph_size.y }, { coords[ 0 ], coords[ 1 ], coords[ 2 ], coords[ 3 ] }, color.bgra }, font.texture_handle ( ) );
+      } );
+    }
+
+    // getters
+
+    /// <summary>
+    /// get number of quads in queue
+    /// </summary>
+    /// <returns>number of quads</returns>
+    uint32_t size ( ) const noexcept
+    {
+      return static_cast< uint32_t > ( this->m_instances.size ( ) );
+    }
+
+    /// <summary>
+    /// get if quads are drawn with hardware instancing
+    /// </summary>
+    /// <returns>true if instancing is used, false if quads fall back to a c_renderqueue</returns>
+    bool instanced ( ) const noexcept
+    {
+      return this->m_instancing;
+    }
+  };
+
+  // producer side of a draw list shared between processes. writes geometry straight into a named shared memory section, which a c_sharedqueue in
+  // the process owning the device draws from. doesn't need a device (or daisy to be initialized) at all. textures are referred to by ids that
+  // the consuming process registers with c_sharedqueue::register_texture, 0 means untextured
+  class c_sharedqueue_producer
+  {
+  private:
+    HANDLE m_mapping;
+    uint8_t *m_view;
+    detail::shared_header_t *m_header;
+
+    // capacities we created (or checked) the section with
+    detail::shared_layout_t m_layout;
+
+    // slot we're filling
+    uint32_t m_write;
+
+  private:
+    /// <summary>
+    /// appends geometry to the slot we're filling, batching it with the last draw call if possible
+    /// </summary>
+    /// <param name="texture">texture id</param>
+    /// <param name="vertices">vertices to append</param>
+    /// <param name="vertex_count">number of vertices</param>
+    /// <param name="indices">indices to append, relative to the first appended vertex</param>
+    /// <param name="index_count">number of indices</param>
+    /// <returns>true on success, false if the slot is full</returns>
+    bool push_geometry ( const uint32_t texture, const daisy_vtx_t *vertices, const uint32_t vertex_count, const uint16_t *indices, const uint32_t index_count ) noexcept
+    {
+      if ( !this->m_view )
+        return false;
+
+      auto slot = detail::shared_slot ( this->m_view, this->m_layout, this->m_write );
+      auto drawcalls = detail::shared_drawcalls ( this->m_layout, slot );
+
+      if ( slot->m_vertices + vertex_count > this->m_layout.m_max_vertices || slot->m_indices + index_count > this->m_layout.m_max_indices )
+        return false;
+
+      // attempt to batch drawcall, same rules as c_renderqueue
+      detail::shared_drawcall_t *call = slot->m_drawcalls ? &drawcalls[ slot->m_drawcalls - 1 ] : nullptr;
+      if ( !call || call->m_texture != texture || call->m_vertices + vertex_count > 0x10000 )
+      {
+        if ( slot->m_drawcalls >= this->m_layout.m_max_drawcalls )
+          return false;
+
+        call = &drawcalls[ slot->m_drawcalls++ ];
+        *call = detail::shared_drawcall_t { texture, 0, 0, 0 };
+      }
+
+      memcpy ( detail::shared_vertices ( slot ) + slot->m_vertices, vertices, sizeof ( daisy_vtx_t ) * vertex_count );
+
+      uint16_t *idx = detail::shared_indices ( this->m_layout, slot ) + slot->m_indices;
+      for ( uint32_t i = 0; i < index_count; ++i )
+        idx[ i ] = static_cast< uint16_t > ( call->m_vertices + indices[ i ] );
+
+      call->m_vertices += vertex_count;
+      call->m_indices += index_count;
+      call->m_primitives += index_count / 3;
+
+      slot->m_vertices += vertex_count;
+      slot->m_indices += index_count;
+
+      return true;
+    }
+
+  public:
+    c_sharedqueue_producer ( ) noexcept : m_mapping ( nullptr ), m_view ( nullptr ), m_header ( nullptr ), m_layout { }, m_write ( 0 ) { }
+
+    // disallow copying
+    c_sharedqueue_producer ( const c_sharedqueue_producer & ) = delete;
+    c_sharedqueue_producer &operator= ( const c_sharedqueue_producer & ) = delete;
+
+    /// <summary>
+    /// creates (or re-attaches to) the named shared memory section
+    /// </summary>
+    /// <param name="name">name of section, for example "Local\\my_overlay"</param>
+    /// <param name="max_verts">max vertices per frame</param>
+    /// <param name="max_indices">max indices per frame</param>
+    /// <param name="max_drawcalls">max draw calls per frame</param>
+    /// <returns>true on success, false otherwise (eg. the section already exists with different capacities)</returns>
+    [[nodiscard]] bool create ( const char *name, const uint32_t max_verts = 32767, const uint32_t max_indices = 65535, const uint32_t max_drawcalls = 256 ) noexcept
+    {
+      this->release ( );
+
+      const detail::shared_layout_t layout { max_verts, max_indices, max_drawcalls, 0 };
+
+      const uint64_t slot_size = detail::shared_slot_size ( layout );
+      if ( detail::shared_section_size ( slot_size ) > UINT32_MAX )
+        return false;
+
+      const uint32_t size = static_cast< uint32_t > ( detail::shared_section_size ( slot_size ) );
+
+      this->m_mapping = CreateFileMappingA ( INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, size, name );
+      if ( !this->m_mapping )
+        return false;
+
+      this->m_view = static_cast< uint8_t * > ( MapViewOfFile ( this->m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size ) );
+      if ( !this->m_view )
+      {
+        this->release ( );
+        return false;
+      }
+
+      this->m_header = reinterpret_cast< detail::shared_header_t * > ( this->m_view );
+      this->m_layout = detail::shared_layout_t { max_verts, max_indices, max_drawcalls, static_cast< uint32_t > ( slot_size ) };
+
+      // a previous producer left the section behind, continue in a slot neither the consumer nor the ready frame use
+      if ( this->m_header->m_magic == detail::SHARED_QUEUE_MAGIC )
+      {
+        if ( this->m_header->m_vertex_size != sizeof ( daisy_vtx_t ) || this->m_header->m_max_vertices != max_verts || this->m_header->m_max_indices != max_indices ||
+             this->m_header->m_max_drawcalls != max_drawcalls || this->m_header->m_slot_size != slot_size )
+        {
+          this->release ( );
+          return false;
+        }
+
+        // slots the consumer wrote are only used for comparing here, m_write always ends up in range
+        const uint32_t ready = this->m_header->m_ready & ( detail::SHARED_QUEUE_FRESH - 1 ), reading = this->m_header->m_reading;
+
+        this->m_write = 0;
+        while ( this->m_write == ready || this->m_write == reading )
+          ++this->m_write;
+      }
+      else
+      {
+        new ( this->m_view ) detail::shared_header_t { };
+
+        this->m_header->m_vertex_size = sizeof ( daisy_vtx_t );
+        this->m_header->m_max_vertices = max_verts;
+        this->m_header->m_max_indices = max_indices;
+        this->m_header->m_max_drawcalls = max_drawcalls;
+        this->m_header->m_slot_size = static_cast< uint32_t > ( slot_size );
+        this->m_header->m_ready = 1;
+        this->m_header->m_reading = 2;
+
+        for ( uint32_t i = 0; i < detail::SHARED_QUEUE_SLOTS; ++i )
+          *detail::shared_slot ( this->m_view, this->m_layout, i ) = detail::shared_slot_t { 0, 0, 0 };
+
+        this->m_write = 0;
+
+        // consumers only open the section once this is set, so everything above has to be visible before it
+        stl::atomic_thread_fence ( stl::memory_order_release );
+        this->m_header->m_magic = detail::SHARED_QUEUE_MAGIC;
+      }
+
+      this->clear ( );
+
+      return true;
+    }
+
+    /// <summary>
+    /// unmaps and closes the section
+    /// </summary>
+    void release ( ) noexcept
+    {
+      if ( this->m_view )
+      {
+        UnmapViewOfFile ( this->m_view );
+        this->m_view = nullptr;
+        this->m_header = nullptr;
+      }
+
+      if ( this->m_mapping )
+      {
+        CloseHandle ( this->m_mapping );
+        this->m_mapping = nullptr;
+      }
+    }
+
+    /// <summary>
+    /// wipes the frame that's being filled
+    /// </summary>
+    void clear ( ) noexcept
+    {
+      if ( this->m_view )
+        *detail::shared_slot ( this->m_view, this->m_layout, this->m_write ) = detail::shared_slot_t { 0, 0, 0 };
+    }
+
+    /// <summary>
+    /// publishes the filled frame as the latest complete one and starts a new, empty one. frames the consumer didn't pick up in time are dropped
+    /// </summary>
+    void submit ( ) noexcept
+    {
+      if ( !this->m_view )
+        return;
+
+      this->m_write = this->m_header->m_ready.exchange ( this->m_write | detail::SHARED_QUEUE_FRESH, stl::memory_order_acq_rel ) & ( detail::SHARED_QUEUE_FRESH - 1 );
+
+      // the consumer lives in another process, a slot it swapped in may not exist
+      if ( this->m_write >= detail::SHARED_QUEUE_SLOTS )
+      {
+        this->release ( );
+        return;
+      }
+
+      this->clear ( );
+    }
+
+    /// <summary>
+    /// push gradient rectangle to frame
     /// </summary>
     /// <param name="position">rectangle position</param>
     /// <param name="size">rectangle size</param>
@@ -1076,441 +7765,535 @@ namespace daisy
     /// <param name="c2">top right rectangle color</param>
     /// <param name="c3">bottom left rectangle color</param>
     /// <param name="c4">bottom right rectangle color</param>
-    /// <param name="texture_handle">texture handle (by default nullptr, means no texture is applied)</param>
+    /// <param name="texture">texture id registered by the consumer (by default 0, means no texture is applied)</param>
     /// <param name="uv_mins">uv mins of rectangle in texture (by default {0, 0})</param>
     /// <param name="uv_maxs">uv maxs of rectangle in texture (by default {1, 1})</param>
-    void push_gradient_rectangle ( const point_t &position, const point_t &size, const color_t c1, const color_t c2, const color_t c3, const color_t c4, IDirect3DTexture9 *texture_handle = nullptr, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } ) noexcept
+    /// <returns>true on success, false if the frame is full</returns>
+    bool push_gradient_rectangle ( const point_t &position, const point_t &size, const color_t c1, const color_t c2, const color_t c3, const color_t c4, const uint32_t texture = 0, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } ) noexcept
     {
-      this->ensure_buffers_capacity ( 4, 6 );
-
-      uint32_t additional_indices = this->begin_batch ( texture_handle );
-
-      auto vtx_counter = 0, idx_counter = 0;
-
-      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
-      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
-
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( position.x ), stl::floorf ( position.y ), 0.0f, 1.f }, c1.bgra, { uv_mins.x, uv_mins.y } };
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( position.x + size.x ), stl::floorf ( position.y ), 0.0f, 1.f }, c2.bgra, { uv_maxs.x, uv_mins.y } };
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( position.x + size.x ), stl::floorf ( position.y + size.y ), 0.0f, 1.f }, c4.bgra, { uv_maxs.x, uv_maxs.y } };
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( position.x ), stl::floorf ( position.y + size.y ), 0.0f, 1.f }, c3.bgra, { uv_mins.x, uv_maxs.y } };
-
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 3 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 3 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
-
-      this->m_vtxs.m_size += 4;
-      this->m_idxs.m_size += 6;
-
-      this->end_batch ( additional_indices, 4, 6, 2, texture_handle );
+      const daisy_vtx_t vtx[] = {
+          { { stl::floorf ( position.x ), stl::floorf ( position.y ), 0.0f, 1.f }, c1.bgra, { uv_mins.x, uv_mins.y } },
+          { { stl::floorf ( position.x + size.x ), stl::floorf ( position.y ), 0.0f, 1.f }, c2.bgra, { uv_maxs.x, uv_mins.y } },
+          { { stl::floorf ( position.x + size.x ), stl::floorf ( position.y + size.y ), 0.0f, 1.f }, c4.bgra, { uv_maxs.x, uv_maxs.y } },
+          { { stl::floorf ( position.x ), stl::floorf ( position.y + size.y ), 0.0f, 1.f }, c3.bgra, { uv_mins.x, uv_maxs.y } } };
+      const uint16_t idx[] = { 0, 1, 3, 3, 2, 1 };
+
+      return this->push_geometry ( texture, vtx, 4, idx, 6 );
     }
 
     /// <summary>
-    /// push filled rectangle to drawlist
+    /// push filled rectangle to frame
     /// </summary>
     /// <param name="position">rectangle position</param>
     /// <param name="size">rectangle size</param>
     /// <param name="col">rectangle color</param>
-    /// <param name="texture_handle">texture handle (by default nullptr, means no texture is applied)</param>
+    /// <param name="texture">texture id registered by the consumer (by default 0, means no texture is applied)</param>
     /// <param name="uv_mins">uv mins of rectangle in texture (by default {0, 0})</param>
     /// <param name="uv_maxs">uv maxs of rectangle in texture (by default {1, 1})</param>
-    void push_filled_rectangle ( const point_t &position, const point_t &size, const color_t col, IDirect3DTexture9 *texture_handle = nullptr, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } ) noexcept
+    /// <returns>true on success, false if the frame is full</returns>
+    bool push_filled_rectangle ( const point_t &position, const point_t &size, const color_t col, const uint32_t texture = 0, const point_t &uv_mins = { 0.f, 0.f }, const point_t &uv_maxs = { 1.f, 1.f } ) noexcept
     {
-      this->push_gradient_rectangle ( position, size, col, col, col, col, texture_handle, uv_mins, uv_maxs );
+      return this->push_gradient_rectangle ( position, size, col, col, col, col, texture, uv_mins, uv_maxs );
     }
 
     /// <summary>
-    /// push filled triangle to drawlist
+    /// push filled triangle to frame
     /// </summary>
-    /// <param name="p1">point 1 of triangle</param>
-    /// <param name="p2">point 2 of triangle</param>
-    /// <param name="p3">point 3 of triangle</param>
-    /// <param name="c1">color 1 of triangle</param>
-    /// <param name="c2">color 2 of triangle</param>
-    /// <param name="c3">color 3 of triangle</param>
-    /// <param name="texture_handle">texture handle (by default nullptr, means no texture is applied)</param>
-    /// <param name="uv1">uv bounds for the 1st point</param>
-    /// <param name="uv2">uv bounds for the 2nd point</param>
-    /// <param name="uv3">uv bounds for the 3rd point</param>
-    void push_filled_triangle ( const point_t &p1, const point_t &p2, const point_t &p3, const color_t c1, const color_t c2, const color_t c3, IDirect3DTexture9 *texture_handle = nullptr, const point_t &uv1 = { 0.f, 0.f }, const point_t &uv2 = { 0.f, 0.f }, const point_t &uv3 = { 0.f, 0.f } ) noexcept
+    /// <param name="p1">first point of triangle</param>
+    /// <param name="p2">second point of triangle</param>
+    /// <param name="p3">third point of triangle</param>
+    /// <param name="c1">color of first point</param>
+    /// <param name="c2">color of second point</param>
+    /// <param name="c3">color of third point</param>
+    /// <returns>true on success, false if the frame is full</returns>
+    bool push_filled_triangle ( const point_t &p1, const point_t &p2, const point_t &p3, const color_t c1, const color_t c2, const color_t c3 ) noexcept
+    {
+      const daisy_vtx_t vtx[] = {
+          { { p1.x, p1.y, 0.0f, 1.f }, c1.bgra, { 0.f, 0.f } },
+          { { p2.x, p2.y, 0.0f, 1.f }, c2.bgra, { 0.f, 0.f } },
+          { { p3.x, p3.y, 0.0f, 1.f }, c3.bgra, { 0.f, 0.f } } };
+      const uint16_t idx[] = { 0, 1, 2 };
+
+      return this->push_geometry ( 0, vtx, 3, idx, 3 );
+    }
+
+    /// <summary>
+    /// push line to frame
+    /// </summary>
+    /// <param name="p1">start point of line</param>
+    /// <param name="p2">end point of line</param>
+    /// <param name="col">color of line</param>
+    /// <param name="width">width of line</param>
+    /// <returns>true on success, false if the frame is full</returns>
+    bool push_line ( const point_t &p1, const point_t &p2, const color_t &col, const float width = 1.f ) noexcept
+    {
+      // same as c_renderqueue::push_line
+      point_t delta = { p2.x - p1.x, p2.y - p1.y };
+      float length = stl::sqrtf ( delta.x * delta.x + delta.y * delta.y ) + FLT_EPSILON;
+
+      float scale = width / ( 2.f * length );
+      point_t radius = { -scale * delta.y, scale * delta.x };
+
+      const daisy_vtx_t vtx[] = {
+          { { p1.x - radius.x, p1.y - radius.y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } },
+          { { p1.x + radius.x, p1.y + radius.y, 0.0f, 1.f }, col.bgra, { 1.f, 0.f } },
+          { { p2.x - radius.x, p2.y - radius.y, 0.0f, 1.f }, col.bgra, { 1.f, 1.f } },
+          { { p2.x + radius.x, p2.y + radius.y, 0.0f, 1.f }, col.bgra, { 0.f, 1.f } } };
+      const uint16_t idx[] = { 0, 1, 2, 2, 3, 1 };
+
+      return this->push_geometry ( 0, vtx, 4, idx, 6 );
+    }
+
+    /// <summary>
+    /// check if section is mapped
+    /// </summary>
+    /// <returns>true if section is mapped</returns>
+    bool valid ( ) const noexcept
+    {
+      return this->m_view != nullptr;
+    }
+  };
+
+  // consumer side of a draw list shared between processes, see c_sharedqueue_producer. flushing draws the latest complete frame the producer
+  // submitted, uploading it to the gpu straight from shared memory
+  class c_sharedqueue : public c_daisy_resettable_object
+  {
+  private:
+    HANDLE m_mapping;
+    uint8_t *m_view;
+    detail::shared_header_t *m_header;
+
+    // capacities checked by open(), the producer can still change the header afterwards
+    detail::shared_layout_t m_layout;
+
+    // slot we're drawing from, the producer never writes to it
+    uint32_t m_read;
+
+    IDirect3DVertexBuffer9 *m_vertex_buffer;
+    IDirect3DIndexBuffer9 *m_index_buffer;
+
+    // d3d9 buffers hold the frame in m_read
+    bool m_uploaded;
+
+    stl::pmr::unordered_map< uint32_t, IDirect3DTexture9 * > m_textures;
+
+  private:
+    /// <summary>
+    /// creates d3d9 buffers big enough for a frame
+    /// </summary>
+    /// <returns>true on success, false otherwise</returns>
+    bool create_ex ( ) noexcept
     {
-      this->ensure_buffers_capacity ( 3, 3 );
-
-      uint32_t additional_indices = this->begin_batch ( texture_handle );
+      if ( !this->m_context->device ( ) || !this->m_header )
+        return false;
 
-      auto vtx_counter = 0, idx_counter = 0;
+      this->m_uploaded = false;
 
-      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
-      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+      if ( !this->m_vertex_buffer )
+        if ( this->m_context->device ( )->CreateVertexBuffer ( static_cast< UINT > ( sizeof ( daisy_vtx_t ) * this->m_layout.m_max_vertices ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, ( D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 ), D3DPOOL_DEFAULT, &this->m_vertex_buffer, nullptr ) < 0 )
+          return false;
 
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( p1.x ), stl::floorf ( p1.y ), 0.0f, 1.f }, c1.bgra, { uv1.x, uv1.y } };
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( p2.x ), stl::floorf ( p2.y ), 0.0f, 1.f }, c2.bgra, { uv2.x, uv2.y } };
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { stl::floorf ( p3.x ), stl::floorf ( p3.y ), 0.0f, 1.f }, c3.bgra, { uv3.x, uv3.y } };
+      if ( !this->m_index_buffer )
+        if ( this->m_context->device ( )->CreateIndexBuffer ( static_cast< UINT > ( sizeof ( uint16_t ) * this->m_layout.m_max_indices ), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &this->m_index_buffer, nullptr ) < 0 )
+          return false;
 
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
+      return true;
+    }
 
-      this->m_vtxs.m_size += 3;
-      this->m_idxs.m_size += 3;
+    /// <summary>
+    /// releases d3d9 buffers
+    /// </summary>
+    void release_buffers ( ) noexcept
+    {
+      if ( this->m_vertex_buffer )
+      {
+        this->m_vertex_buffer->Release ( );
+        this->m_vertex_buffer = nullptr;
+      }
 
-      this->end_batch ( additional_indices, 3, 3, 1, texture_handle );
+      if ( this->m_index_buffer )
+      {
+        this->m_index_buffer->Release ( );
+        this->m_index_buffer = nullptr;
+      }
     }
 
     /// <summary>
-    /// push line to drawlist
+    /// copies the frame in m_read to d3d9 buffers
     /// </summary>
-    /// <param name="p1">point 1 of line</param>
-    /// <param name="p2">point 2 of line</param>
-    /// <param name="col">color of line</param>
-    /// <param name="width">width of line</param>
-    void push_line ( const point_t &p1, const point_t &p2, const color_t &col, const float width = 1.f ) noexcept
+    /// <returns>true on success, false otherwise</returns>
+    bool upload ( ) noexcept
     {
-      this->ensure_buffers_capacity ( 4, 6 );
+      const auto slot = detail::shared_slot ( this->m_view, this->m_layout, this->m_read );
 
-      uint32_t additional_indices = this->begin_batch ( nullptr );
-
-      // shoutout 8th grade math
-      point_t delta = { p2.x - p1.x, p2.y - p1.y };
-      float length = stl::sqrtf ( delta.x * delta.x + delta.y * delta.y ) + FLT_EPSILON;
+      // the producer lives in another process, don't trust it
+      const uint32_t vertices = slot->m_vertices < this->m_layout.m_max_vertices ? slot->m_vertices : this->m_layout.m_max_vertices;
+      const uint32_t indices = slot->m_indices < this->m_layout.m_max_indices ? slot->m_indices : this->m_layout.m_max_indices;
 
-      float scale = width / ( 2.f * length );
-      point_t radius = { -scale * delta.y, scale * delta.x };
+      void *data;
 
-      auto vtx_counter = 0, idx_counter = 0;
+      if ( vertices )
+      {
+        if ( this->m_vertex_buffer->Lock ( 0, static_cast< UINT > ( sizeof ( daisy_vtx_t ) * vertices ), &data, D3DLOCK_DISCARD ) < 0 )
+          return false;
 
-      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
-      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+        memcpy ( data, detail::shared_vertices ( slot ), sizeof ( daisy_vtx_t ) * vertices );
+        this->m_vertex_buffer->Unlock ( );
+      }
 
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { p1.x - radius.x, p1.y - radius.y, 0.0f, 1.f }, col.bgra, { 0.f, 0.f } };
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { p1.x + radius.x, p1.y + radius.y, 0.0f, 1.f }, col.bgra, { 1.f, 0.f } };
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { p2.x - radius.x, p2.y - radius.y, 0.0f, 1.f }, col.bgra, { 1.f, 1.f } };
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { p2.x + radius.x, p2.y + radius.y, 0.0f, 1.f }, col.bgra, { 0.f, 1.f } };
+      if ( indices )
+      {
+        if ( this->m_index_buffer->Lock ( 0, static_cast< UINT > ( sizeof ( uint16_t ) * indices ), &data, D3DLOCK_DISCARD ) < 0 )
+          return false;
 
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 2 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 3 );
-      idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + 1 );
+        memcpy ( data, detail::shared_indices ( this->m_layout, slot ), sizeof ( uint16_t ) * indices );
+        this->m_index_buffer->Unlock ( );
+      }
 
-      this->m_vtxs.m_size += 4;
-      this->m_idxs.m_size += 6;
+      return true;
+    }
 
-      this->end_batch ( additional_indices, 4, 6, 2, nullptr );
+  public:
+    c_sharedqueue ( c_daisy_context &context = daisy_t::s_context ) noexcept
+        : c_daisy_resettable_object ( context ), m_mapping ( nullptr ), m_view ( nullptr ), m_header ( nullptr ), m_layout { }, m_read ( 0 ), m_vertex_buffer ( nullptr ), m_index_buffer ( nullptr ), m_uploaded ( false ),
+          m_textures ( context.resource ( ) )
+    {
     }
 
+    // disallow copying
+    c_sharedqueue ( const c_sharedqueue & ) = delete;
+    c_sharedqueue &operator= ( const c_sharedqueue & ) = delete;
+
     /// <summary>
-    /// push filled arc of circle to drawlist
-    /// to note: it would be more efficient to use a pixel shader and draw a quad to draw the circle
+    /// opens a section created by a c_sharedqueue_producer. fails until the producer created it, so it can be retried every frame
     /// </summary>
-    /// <param name="center">center of circle</param>
-    /// <param name="radius">radius of circle</param>
-    /// <param name="segments">how many points are used to draw the circle (less = circle is less accurate, more = more vertices and indicies used, increased memory usage, slower to compute)</param>
-    /// <param name="factor">how much of the circle arc to draw [0.0, 1.0]</param>
-    /// <param name="center_color">the color of the center of the circle</param>
-    /// <param name="outer_color">the color of the outside of the circle</param>
-    void push_filled_arc ( const point_t &center, const float radius, const int segments, const float factor, const color_t &center_color, const color_t &outer_color )
+    /// <param name="name">name of section the producer created</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool open ( const char *name ) noexcept
     {
-      // sanity checks
-      if ( segments < 3 || factor <= 0.f || factor > 1.f )
-        return;
+      this->close ( );
 
-      int segments_to_draw = static_cast< int > ( static_cast< float > ( segments ) * factor );
-
-      this->ensure_buffers_capacity ( static_cast< uint32_t > ( segments_to_draw + 2 ), static_cast< uint32_t > ( ( segments_to_draw + 1 ) * 3 ) );
+      this->m_mapping = OpenFileMappingA ( FILE_MAP_ALL_ACCESS, FALSE, name );
+      if ( !this->m_mapping )
+        return false;
 
-      uint32_t additional_indices = this->begin_batch ( nullptr );
+      // the size of the section isn't known yet, map all of it
+      this->m_view = static_cast< uint8_t * > ( MapViewOfFile ( this->m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0 ) );
+      this->m_header = reinterpret_cast< detail::shared_header_t * > ( this->m_view );
 
-      auto vtx_counter = 0, idx_counter = 0, primitive_counter = 0;
+      // and ask how big it turned out, so a header from another process can't make us read past its end
+      MEMORY_BASIC_INFORMATION info { };
+      if ( !this->m_view || !VirtualQuery ( this->m_view, &info, sizeof ( info ) ) || info.RegionSize < sizeof ( detail::shared_header_t ) ||
+           this->m_header->m_magic != detail::SHARED_QUEUE_MAGIC || this->m_header->m_vertex_size != sizeof ( daisy_vtx_t ) )
+      {
+        this->close ( );
+        return false;
+      }
 
-      // write directly to the end of the buffer as we know we have more than enough space - need to start doing this everywhere
-      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
-      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+      stl::atomic_thread_fence ( stl::memory_order_acquire );
 
-      // center point
-      vtx[ vtx_counter++ ] = daisy_vtx_t { { center.x, center.y, 0.0f, 1.f }, center_color.bgra, { 0.f, 0.f } };
+      // read the capacities once and only ever use this copy, checking the header and reading it again later would let the producer change them in between
+      this->m_layout = detail::shared_layout_t { this->m_header->m_max_vertices, this->m_header->m_max_indices, this->m_header->m_max_drawcalls, this->m_header->m_slot_size };
 
-      auto seg = segments_to_draw;
+      const uint64_t slot_size = detail::shared_slot_size ( this->m_layout );
+      if ( this->m_layout.m_slot_size != slot_size || detail::shared_section_size ( slot_size ) > info.RegionSize )
+      {
+        this->close ( );
+        return false;
+      }
 
-      // outer points
-      for ( int i = 0; i <= seg + 1; ++i )
+      this->m_read = this->m_header->m_reading;
+      if ( this->m_read >= detail::SHARED_QUEUE_SLOTS )
       {
-        float tetha = 2.f * detail::PI * static_cast< float > ( i ) / static_cast< float > ( segments );
-        float x = center.x + ( radius * stl::cosf ( tetha ) );
-        float y = center.y - ( radius * stl::sinf ( tetha ) );
+        this->close ( );
+        return false;
+      }
 
-        // circle outer point
-        vtx[ vtx_counter++ ] = daisy_vtx_t { { x, y, 0.0f, 1.f }, outer_color.bgra, { 0.f, 0.f } };
+      return this->create_ex ( );
+    }
 
-        // indices
-        if ( i > 0 )
-        {
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices );         // center
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + i );     // current outer
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + i - 1 ); // last outer
+    /// <summary>
+    /// releases d3d9 buffers and unmaps the section
+    /// </summary>
+    void close ( ) noexcept
+    {
+      this->release_buffers ( );
 
-          primitive_counter++;
-        }
+      if ( this->m_view )
+      {
+        UnmapViewOfFile ( this->m_view );
+        this->m_view = nullptr;
+        this->m_header = nullptr;
       }
 
-      this->m_vtxs.m_size += vtx_counter;
-      this->m_idxs.m_size += idx_counter;
+      if ( this->m_mapping )
+      {
+        CloseHandle ( this->m_mapping );
+        this->m_mapping = nullptr;
+      }
+    }
 
-      this->end_batch ( additional_indices, vtx_counter, idx_counter, primitive_counter, nullptr );
+    /// <summary>
+    /// maps a texture id the producer uses to a texture
+    /// </summary>
+    /// <param name="id">texture id, 0 is reserved for untextured geometry</param>
+    /// <param name="texture_handle">texture handle</param>
+    void register_texture ( const uint32_t id, IDirect3DTexture9 *texture_handle ) noexcept
+    {
+      if ( id )
+        this->m_textures[ id ] = texture_handle;
     }
 
     /// <summary>
-    /// push filled circle to drawlist
-    /// to note: it would be more efficient to use a pixel shader and draw a quad to draw the circle
+    /// removes a texture id, geometry using it is drawn untextured
     /// </summary>
-    /// <param name="center">center of circle</param>
-    /// <param name="radius">radius of circle</param>
-    /// <param name="segments">how many points are used to draw the circle (less = circle is less accurate, more = more vertices and indicies used, increased memory usage, slower to compute)</param>
-    /// <param name="center_color">the color of the center of the circle</param>
-    /// <param name="outer_color">the color of the outside of the circle</param>
-    void push_filled_circle ( const point_t &center, const float radius, const int segments, const color_t &center_color, const color_t &outer_color )
+    /// <param name="id">texture id</param>
+    void unregister_texture ( const uint32_t id ) noexcept
     {
-      this->push_filled_arc ( center, radius, segments, 1.f, center_color, outer_color );
+      this->m_textures.erase ( id );
     }
 
     /// <summary>
-    /// push a string with a given font to drawlist
+    /// called on device reset (pre/post)
     /// </summary>
-    /// <typeparam name="t">iteratable text container (only char and wchar_t accepted currently)</typeparam>
-    /// <param name="font">initialized c_fontwrapper instance</param>
-    /// <param name="position">position of text</param>
-    /// <param name="text">text to draw</param>
-    /// <param name="color">color of text to draw</param>
-    /// <param name="alignment">alignment of text to draw</param>
-    template < typename t = stl::string_view >
-    void push_text ( c_fontwrapper &font, const point_t &position, const t text, const color_t &color, uint16_t alignment = TEXT_ALIGN_DEFAULT ) noexcept
+    /// <param name="pre_reset">if this is called before device is reset</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
     {
-      // this is a rough approximate, best we can do without passing through the entire string twice.
-      this->ensure_buffers_capacity ( static_cast< uint32_t > ( text.size ( ) * 4 ), static_cast< uint32_t > ( text.size ( ) * 6 ) );
+      if ( pre_reset )
+      {
+        this->release_buffers ( );
+        return true;
+      }
 
-      uint32_t additional_indices = this->begin_batch ( font.texture_handle ( ) );
-      uint32_t cont_vertices = 0, cont_indices = 0, cont_primitives = 0;
+      // nothing to recreate if we weren't opened yet
+      return !this->m_view || this->create_ex ( );
+    }
 
-      point_t corrected_position { position };
+    /// <summary>
+    /// picks up the latest frame the producer submitted (if there's a new one) and draws it
+    /// </summary>
+    void flush ( ) noexcept
+    {
+      if ( !this->m_view || !this->m_vertex_buffer || !this->m_index_buffer )
+        return;
 
-      if ( alignment != TEXT_ALIGN_DEFAULT )
+      // swap our slot with the ready one, the producer only ever swaps its own slot in
+      if ( this->m_header->m_ready.load ( stl::memory_order_acquire ) & detail::SHARED_QUEUE_FRESH )
       {
-        const auto size = font.text_extent ( text );
+        this->m_read = this->m_header->m_ready.exchange ( this->m_read, stl::memory_order_acq_rel ) & ( detail::SHARED_QUEUE_FRESH - 1 );
 
-        if ( alignment & TEXT_ALIGNX_CENTER )
-          corrected_position.x -= stl::floorf ( 0.5f * size.x );
-        else if ( alignment & TEXT_ALIGNX_RIGHT )
-          corrected_position.x -= stl::floorf ( size.x );
+        // the mask still lets through a slot that doesn't exist, the section can't be trusted anymore
+        if ( this->m_read >= detail::SHARED_QUEUE_SLOTS )
+        {
+          this->close ( );
+          return;
+        }
 
-        if ( alignment & TEXT_ALIGNY_CENTER )
-          corrected_position.y -= stl::floorf ( 0.5f * size.y );
-        else if ( alignment & TEXT_ALIGNY_BOTTOM )
-          corrected_position.y -= stl::floorf ( size.y );
+        this->m_header->m_reading = this->m_read;
+        this->m_uploaded = false;
       }
 
-      corrected_position.x -= font.spacing ( );
-
-      float start_x = corrected_position.x;
-      auto space_coords = font.coords ( 'A' );
-
-      auto vtx_counter = 0, idx_counter = 0;
+      if ( !this->m_uploaded )
+        this->m_uploaded = this->upload ( );
 
-      daisy_vtx_t *vtx = reinterpret_cast< daisy_vtx_t * > ( reinterpret_cast< uintptr_t > ( this->m_vtxs.m_data.get ( ) ) + ( sizeof ( daisy_vtx_t ) * this->m_vtxs.m_size ) );
-      uint16_t *idx = reinterpret_cast< uint16_t * > ( reinterpret_cast< uintptr_t > ( this->m_idxs.m_data.get ( ) ) + ( sizeof ( uint16_t ) * this->m_idxs.m_size ) );
+      if ( !this->m_uploaded )
+        return;
 
-      for ( const auto c : text )
-      {
-        if ( c == '\n' )
-        {
-          corrected_position.x = start_x;
-          corrected_position.y += ( space_coords[ 3 ] - space_coords[ 1 ] ) * font.height ( );
+      const auto slot = detail::shared_slot ( this->m_view, this->m_layout, this->m_read );
+      const auto drawcalls = detail::shared_drawcalls ( this->m_layout, slot );
+      const uint32_t drawcall_count = slot->m_drawcalls < this->m_layout.m_max_drawcalls ? slot->m_drawcalls : this->m_layout.m_max_drawcalls;
 
-          continue;
-        }
+      this->m_context->device ( )->SetStreamSource ( 0, this->m_vertex_buffer, 0, sizeof ( daisy_vtx_t ) );
+      this->m_context->device ( )->SetFVF ( ( D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 ) );
+      this->m_context->device ( )->SetIndices ( this->m_index_buffer );
 
-        if ( c < ' ' )
-          continue;
+      uint32_t vertex_idx { 0 }, index_idx { 0 };
 
-        auto is_space = ( c == ' ' );
-        auto coords = font.coords ( c );
+      for ( uint32_t i = 0; i < drawcall_count; ++i )
+      {
+        const auto call = drawcalls[ i ];
 
-        float tx1 = coords[ 0 ];
-        float ty1 = coords[ 1 ];
-        float tx2 = coords[ 2 ];
-        float ty2 = coords[ 3 ];
+        // calls pointing past the uploaded geometry
+        if ( uint64_t { vertex_idx } + call.m_vertices > this->m_layout.m_max_vertices || uint64_t { index_idx } + call.m_indices > this->m_layout.m_max_indices ||
+             uint64_t { call.m_primitives } * 3 > call.m_indices )
+          break;
 
-        float w = ( tx2 - tx1 ) * font.width ( ) / font.scale ( );
-        float h = ( ty2 - ty1 ) * font.height ( ) / font.scale ( );
+        const auto texture = this->m_textures.find ( call.m_texture );
 
-        if ( !is_space )
-        {
-          daisy_vtx_t v[] = {
-              { { corrected_position.x - 0.5f, corrected_position.y - 0.5f + h, 0.f, 1.f }, color.bgra, { tx1, ty2 } },
-              { { corrected_position.x - 0.5f, corrected_position.y - 0.5f, 0.f, 1.f }, color.bgra, { tx1, ty1 } },
-              { { corrected_position.x - 0.5f + w, corrected_position.y - 0.5f + h, 0.f, 1.f }, color.bgra, { tx2, ty2 } },
-              { { corrected_position.x - 0.5f + w, corrected_position.y - 0.5f, 0.f, 1.f }, color.bgra, { tx2, ty1 } } };
-
-          vtx[ vtx_counter++ ] = daisy_vtx_t { { corrected_position.x - 0.5f, corrected_position.y - 0.5f + h, 0.f, 1.f }, color.bgra, { tx1, ty2 } };
-          vtx[ vtx_counter++ ] = daisy_vtx_t { { corrected_position.x - 0.5f, corrected_position.y - 0.5f, 0.f, 1.f }, color.bgra, { tx1, ty1 } };
-          vtx[ vtx_counter++ ] = daisy_vtx_t { { corrected_position.x - 0.5f + w, corrected_position.y - 0.5f + h, 0.f, 1.f }, color.bgra, { tx2, ty2 } };
-          vtx[ vtx_counter++ ] = daisy_vtx_t { { corrected_position.x - 0.5f + w, corrected_position.y - 0.5f, 0.f, 1.f }, color.bgra, { tx2, ty1 } };
-
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices );
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 1 );
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 2 );
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 3 );
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 2 );
-          idx[ idx_counter++ ] = static_cast< uint16_t > ( additional_indices + cont_vertices + 1 );
-
-          this->m_vtxs.m_size += 4;
-          this->m_idxs.m_size += 6;
-
-          cont_vertices += 4;
-          cont_indices += 6;
-          cont_primitives += 2;
-        }
+        this->m_context->device ( )->SetTexture ( 0, texture != this->m_textures.end ( ) ? texture->second : nullptr );
+        this->m_context->device ( )->DrawIndexedPrimitive ( D3DPT_TRIANGLELIST, vertex_idx, 0, call.m_vertices, index_idx, call.m_primitives );
 
-        corrected_position.x += w - ( 2.f * font.spacing ( ) );
+        vertex_idx += call.m_vertices;
+        index_idx += call.m_indices;
       }
+    }
 
-      this->end_batch ( additional_indices, cont_vertices, cont_indices, cont_primitives, font.texture_handle ( ) );
+    /// <summary>
+    /// check if section is opened
+    /// </summary>
+    /// <returns>true if section is opened</returns>
+    bool valid ( ) const noexcept
+    {
+      return this->m_view != nullptr;
     }
   };
 
-  class c_doublebuffer_queue : public c_daisy_resettable_object
+  // snapshot file (see c_drawlist::save_snapshot), mapped copy-on-write so render queues can adopt it in place and still patch their vertices
+  // without touching the file. has to stay open as long as a queue uses it
+  class c_snapshotfile
   {
   private:
-    c_renderqueue m_front_queue, m_back_queue;
-    stl::atomic< bool > m_swap_drawlists;
+    HANDLE m_file, m_mapping;
+    uint8_t *m_view;
+    size_t m_size;
 
   public:
+    c_snapshotfile ( ) noexcept : m_file ( INVALID_HANDLE_VALUE ), m_mapping ( nullptr ), m_view ( nullptr ), m_size ( 0 ) { }
+
+    // disallow copying
+    c_snapshotfile ( const c_snapshotfile & ) = delete;
+    c_snapshotfile &operator= ( const c_snapshotfile & ) = delete;
+
     /// <summary>
-    /// initializes current queue by initializing vertex and index buffers
+    /// writes a snapshot to a file, replacing it
     /// </summary>
-    /// <param name="max_verts">max capacity of vertex buffer</param>
-    /// <param name="max_indices">max capacity of index buffer</param>
+    /// <param name="path">path of file</param>
+    /// <param name="blob">blob made by save_snapshot()</param>
     /// <returns>true on success, false otherwise</returns>
-    [[nodiscard]] bool create ( const uint32_t max_verts = 32767, const uint32_t max_indices = 65535 ) noexcept
+    [[nodiscard]] static bool write ( const char *path, const stl::pmr::vector< uint8_t > &blob ) noexcept
     {
-      if ( !this->m_front_queue.create ( max_verts, max_indices ) )
+      const HANDLE file = CreateFileA ( path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
+      if ( file == INVALID_HANDLE_VALUE )
         return false;
 
-      if ( !this->m_back_queue.create ( max_verts, max_indices ) )
+      DWORD written = 0;
+      const bool result = WriteFile ( file, blob.data ( ), static_cast< DWORD > ( blob.size ( ) ), &written, nullptr ) && written == blob.size ( );
+
+      CloseHandle ( file );
+
+      return result;
+    }
+
+    /// <summary>
+    /// maps a snapshot file
+    /// </summary>
+    /// <param name="path">path of file</param>
+    /// <returns>true on success, false otherwise</returns>
+    [[nodiscard]] bool open ( const char *path ) noexcept
+    {
+      this->close ( );
+
+      this->m_file = CreateFileA ( path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+      if ( this->m_file == INVALID_HANDLE_VALUE )
+        return false;
+
+      LARGE_INTEGER size;
+      if ( !GetFileSizeEx ( this->m_file, &size ) || size.QuadPart <= 0 || size.QuadPart > UINT32_MAX )
+      {
+        this->close ( );
+        return false;
+      }
+
+      this->m_mapping = CreateFileMappingA ( this->m_file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+      if ( !this->m_mapping )
+      {
+        this->close ( );
+        return false;
+      }
+
+      this->m_view = static_cast< uint8_t * > ( MapViewOfFile ( this->m_mapping, FILE_MAP_COPY, 0, 0, 0 ) );
+      if ( !this->m_view )
+      {
+        this->close ( );
         return false;
+      }
+
+      this->m_size = static_cast< size_t > ( size.QuadPart );
 
       return true;
     }
 
     /// <summary>
-    /// called on device reset (pre/post)
+    /// unmaps and closes the file
     /// </summary>
-    /// <param name="pre_reset">if this is called before device is reset</param>
-    /// <returns>true on success, false otherwise</returns>
-    [[nodiscard]] virtual bool reset ( bool pre_reset = false ) noexcept override
+    void close ( ) noexcept
     {
-      return this->m_front_queue.reset ( pre_reset ) && this->m_back_queue.reset ( pre_reset );
+      if ( this->m_view )
+      {
+        UnmapViewOfFile ( this->m_view );
+        this->m_view = nullptr;
+      }
+
+      if ( this->m_mapping )
+      {
+        CloseHandle ( this->m_mapping );
+        this->m_mapping = nullptr;
+      }
+
+      if ( this->m_file != INVALID_HANDLE_VALUE )
+      {
+        CloseHandle ( this->m_file );
+        this->m_file = INVALID_HANDLE_VALUE;
+      }
+
+      this->m_size = 0;
     }
 
     /// <summary>
-    /// swap back and front drawlists
+    /// get mapped snapshot
     /// </summary>
-    void swap ( ) noexcept
+    /// <returns>start of snapshot, nullptr if no file is mapped</returns>
+    uint8_t *data ( ) const noexcept
     {
-      this->m_swap_drawlists = !this->m_swap_drawlists;
+      return this->m_view;
     }
 
     /// <summary>
-    /// access currently safe render queue
+    /// get size of mapped snapshot
     /// </summary>
-    /// <returns>queue</returns>
-    c_renderqueue *queue ( ) noexcept
+    /// <returns>size in bytes</returns>
+    size_t size ( ) const noexcept
     {
-      return ( !this->m_swap_drawlists ? &this->m_front_queue : &this->m_back_queue );
+      return this->m_size;
     }
 
     /// <summary>
-    /// flushes currently filled queue
+    /// check if a file is mapped
     /// </summary>
-    void flush ( )
+    /// <returns>true if a file is mapped</returns>
+    bool valid ( ) const noexcept
     {
-      this->m_swap_drawlists ? this->m_front_queue.flush ( ) : this->m_back_queue.flush ( );
+      return this->m_view != nullptr;
     }
   };
 
   /// <summary>
-  /// initializes daisy
+  /// initializes daisy on the default context
   /// </summary>
   /// <param name="device">d3d9 device handle</param>
-  inline static void daisy_initialize ( IDirect3DDevice9 *device ) noexcept
+  /// <returns>true on success, false otherwise</returns>
+  inline static bool daisy_initialize ( IDirect3DDevice9 *device ) noexcept
   {
-    daisy_t::s_device = device;
-    daisy_t::s_device->AddRef ( );
+    return daisy_t::s_context.create ( device );
   }
 
   /// <summary>
-  /// prepares render state for daisy
+  /// prepares render state for daisy on the default context
   /// </summary>
   inline static void daisy_prepare ( ) noexcept
   {
-    daisy_t::s_device->SetRenderState ( D3DRS_ZENABLE, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_ALPHABLENDENABLE, TRUE );
-    daisy_t::s_device->SetRenderState ( D3DRS_SRCBLEND, D3DBLEND_SRCALPHA );
-    daisy_t::s_device->SetRenderState ( D3DRS_SRCBLENDALPHA, D3DBLEND_INVDESTALPHA );
-    daisy_t::s_device->SetRenderState ( D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA );
-    daisy_t::s_device->SetRenderState ( D3DRS_DESTBLENDALPHA, D3DBLEND_ONE );
-    daisy_t::s_device->SetRenderState ( D3DRS_ALPHATESTENABLE, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_SEPARATEALPHABLENDENABLE, TRUE );
-    daisy_t::s_device->SetRenderState ( D3DRS_ALPHAREF, 0x08 );
-    daisy_t::s_device->SetRenderState ( D3DRS_ALPHAFUNC, D3DCMP_GREATEREQUAL );
-    daisy_t::s_device->SetRenderState ( D3DRS_LIGHTING, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_FILLMODE, D3DFILL_SOLID );
-    daisy_t::s_device->SetRenderState ( D3DRS_CULLMODE, D3DCULL_NONE );
-    daisy_t::s_device->SetRenderState ( D3DRS_SCISSORTESTENABLE, TRUE );
-    daisy_t::s_device->SetRenderState ( D3DRS_ZWRITEENABLE, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_STENCILENABLE, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_CLIPPING, TRUE );
-    daisy_t::s_device->SetRenderState ( D3DRS_CLIPPLANEENABLE, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_VERTEXBLEND, D3DVBF_DISABLE );
-    daisy_t::s_device->SetRenderState ( D3DRS_INDEXEDVERTEXBLENDENABLE, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_FOGENABLE, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_SRGBWRITEENABLE, FALSE );
-    daisy_t::s_device->SetRenderState ( D3DRS_COLORWRITEENABLE, D3DCOLORWRITEENABLE_RED | D3DCOLORWRITEENABLE_GREEN | D3DCOLORWRITEENABLE_BLUE | D3DCOLORWRITEENABLE_ALPHA );
-    daisy_t::s_device->SetRenderState ( D3DRS_ANTIALIASEDLINEENABLE, FALSE );
-
-    daisy_t::s_device->SetTextureStageState ( 0, D3DTSS_COLOROP, D3DTOP_MODULATE );
-    daisy_t::s_device->SetTextureStageState ( 0, D3DTSS_COLORARG1, D3DTA_TEXTURE );
-    daisy_t::s_device->SetTextureStageState ( 0, D3DTSS_COLORARG2, D3DTA_DIFFUSE );
-    daisy_t::s_device->SetTextureStageState ( 0, D3DTSS_ALPHAOP, D3DTOP_MODULATE );
-    daisy_t::s_device->SetTextureStageState ( 0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE );
-    daisy_t::s_device->SetTextureStageState ( 0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE );
-    daisy_t::s_device->SetTextureStageState ( 0, D3DTSS_TEXCOORDINDEX, 0 );
-    daisy_t::s_device->SetTextureStageState ( 0, D3DTSS_TEXTURETRANSFORMFLAGS, D3DTTFF_DISABLE );
-    daisy_t::s_device->SetTextureStageState ( 1, D3DTSS_COLOROP, D3DTOP_DISABLE );
-    daisy_t::s_device->SetTextureStageState ( 1, D3DTSS_ALPHAOP, D3DTOP_DISABLE );
-
-    daisy_t::s_device->SetSamplerState ( 0ul, D3DSAMP_ADDRESSU, D3DTADDRESS_WRAP );
-    daisy_t::s_device->SetSamplerState ( 0ul, D3DSAMP_ADDRESSV, D3DTADDRESS_WRAP );
-    daisy_t::s_device->SetSamplerState ( 0ul, D3DSAMP_ADDRESSW, D3DTADDRESS_WRAP );
-    daisy_t::s_device->SetSamplerState ( 0, D3DSAMP_MINFILTER, D3DTEXF_PYRAMIDALQUAD );
-    daisy_t::s_device->SetSamplerState ( 0, D3DSAMP_MAGFILTER, D3DTEXF_PYRAMIDALQUAD );
-    daisy_t::s_device->SetSamplerState ( 0, D3DSAMP_MIPFILTER, D3DTEXF_PYRAMIDALQUAD );
-
-    daisy_t::s_device->SetVertexShader ( nullptr );
-    daisy_t::s_device->SetPixelShader ( nullptr );
+    daisy_t::s_context.prepare ( );
   }
 
   /// <summary>
-  /// shut down daisy
+  /// shut down daisy on the default context
   /// </summary>
   inline static void daisy_shutdown ( ) noexcept
   {
-    if ( daisy_t::s_device )
-      daisy_t::s_device->Release ( );
+    daisy_t::s_context.release ( );
   }
+#endif // DAISY_NO_D3D9
 } // namespace daisy
 
 #endif // _SSE2_DAISY_INCLUDE_GUARD
@@ -104,11 +104,23 @@ INT WINAPI WinMain (
   MSG msg;
   bool bail = false;
 
+  // queues created in a buffer pool share its d3d9 buffers, instead of each owning their own
+  daisy::c_bufferpool pool;
+  if ( !pool.create ( ) )
+    return EXIT_FAILURE;
+
   // create a normal queue
   daisy::c_renderqueue queue;
-  if ( !queue.create ( 64, 128 ) )
+  if ( !queue.create ( pool, 64, 128 ) )
+    return EXIT_FAILURE;
+
+  // and an overlay that's filled once, living in the same pool
+  daisy::c_renderqueue overlay;
+  if ( !overlay.create ( pool, 64, 128 ) )
     return EXIT_FAILURE;
 
+  overlay.push_filled_rectangle ( { 0, 0 }, { 1280, 4 }, { 255, 255, 255, 24 } );
+
   // create a double buffer queue (you can fill this from a non-rendering thread safely)
   daisy::c_doublebuffer_queue double_buffer_queue;
   if ( !double_buffer_queue.create ( ) )
@@ -119,9 +131,9 @@ INT WINAPI WinMain (
   if ( !font_gothic.create ( "MS UI Gothic", 10, CLEARTYPE_NATURAL_QUALITY, daisy::FONT_DEFAULT ) )
     return EXIT_FAILURE;
 
+  // fonts can also be rasterized on another thread, they're finalized on the render thread below once that's done
   daisy::c_fontwrapper font_logo;
-  if ( !font_logo.create ( "Arial Italic", 26, CLEARTYPE_NATURAL_QUALITY, daisy::FONT_DEFAULT ) )
-    return EXIT_FAILURE;
+  auto font_logo_prepared = font_logo.prepare_async ( "Arial Italic", 26, CLEARTYPE_NATURAL_QUALITY, daisy::FONT_DEFAULT );
 
   // create texture atlas object
   daisy::c_texatlas atlas;
@@ -138,6 +150,72 @@ INT WINAPI WinMain (
     }
   }
 
+  // create a streaming texture for pixel data that changes every frame
+  daisy::c_streamtexture heatmap;
+  if ( !heatmap.create ( 64, 64, 2 ) )
+    return EXIT_FAILURE;
+
+  std::vector< uint8_t > heatmap_pixels ( 64 * 64 );
+
+  // create a marker batch and scatter some static markers; they only get uploaded once
+  daisy::c_markerbatch markers;
+  if ( !markers.create ( 2000 ) )
+    return EXIT_FAILURE;
+
+  markers.set_marker ( { 6, 6 } );
+  for ( int i = 0; i < 2000; ++i )
+    markers.push ( { 700 + 150 * sinf ( i * 0.37f ) * cosf ( i * 0.011f ), 600 + 150 * cosf ( i * 0.53f ) * sinf ( i * 0.007f ) }, daisy::color_t::from_hsv ( fmodf ( i * 0.18f, 360.f ), 0.8f, 1.f ) );
+
+  // text heavy ui goes through the instanced queue, one 36 byte record per glyph on sm3 hardware
+  daisy::c_instancedqueue labels;
+  if ( !labels.create ( ) )
+    return EXIT_FAILURE;
+
+  for ( int i = 0; i < 16; ++i )
+    labels.push_text< std::string_view > ( font_gothic, { 1100, 420 + i * 12.f }, "instanced label row", { 255, 255, 255, 160 } );
+
+  // a retained queue is filled once and patched in place through handles, only patched vertices get uploaded again.
+  // with separate vertex streams, a patch only uploads the parts of vertices it touched (eg. just colors)
+  daisy::c_renderqueue meters;
+  if ( !meters.create ( 64, 128, daisy::daisy_vertex_layout::LAYOUT_STREAMS ) )
+    return EXIT_FAILURE;
+
+  std::array< daisy::daisy_handle_t, 8 > meter_bars;
+  for ( size_t i = 0; i < meter_bars.size ( ); ++i )
+    meter_bars[ i ] = meters.push_filled_rectangle ( { 1100.f + static_cast< float > ( i ) * 16.f, 700 }, { 12, 80 }, { 0, 200, 120 } );
+
+  // geometry that never changes can be baked into write-once buffers, flushing it afterwards is just the draw
+  daisy::c_renderqueue meters_frame;
+  if ( !meters_frame.create ( 64, 128 ) )
+    return EXIT_FAILURE;
+
+  meters_frame.push_filled_rectangle ( { 1094, 694 }, { 132, 92 }, { 20, 20, 20, 200 } );
+  for ( int i = 0; i < 5; ++i )
+    meters_frame.push_line ( { 1096, 700 + i * 20.f }, { 1224, 700 + i * 20.f }, { 255, 255, 255, 40 } );
+
+  if ( !meters_frame.bake ( ) )
+    return EXIT_FAILURE;
+
+  // nothing is pushed to it again, so the cpu copy isn't needed anymore (only possible for managed buffers)
+  meters_frame.release_staging ( );
+
+  // fill up some samples to plot, way more than the plot is wide
+  std::vector< float > samples ( 100000 );
+  for ( size_t i = 0; i < samples.size ( ); ++i )
+    samples[ i ] = sinf ( i * 0.0005f ) * 0.6f + sinf ( i * 0.37f ) * 0.3f;
+
+  // build a vector path once, it's tessellated on first use and re-used every frame after that
+  daisy::c_path badge;
+  badge.move_to ( { -40, -20 } ).line_to ( { 40, -20 } ).quad_to ( { 60, 0 }, { 40, 20 } ).line_to ( { -40, 20 } ).quad_to ( { -60, 0 }, { -40, -20 } ).close ( );
+
+  // rasterize a vector icon (defined in a 24x24 box) into the atlas at 32x32, it's then drawn as a single textured quad
+  daisy::c_path icon;
+  icon.arc_to ( { 12, 12 }, 10, 0.f, 2.f * daisy::detail::PI ).close ( ).move_to ( { 12, 6 } ).line_to ( { 17, 16 } ).line_to ( { 7, 16 } ).close ( );
+  atlas.append_path ( 2, icon, { 24, 24 }, { 32, 32 } );
+
+  // precompute the falloff used for soft shadows
+  atlas.append_shadow ( 12 );
+
   // clang-format off
   // kick off a thread that fills our double buffer queue and swaps every second.
   std::thread {
@@ -188,9 +266,14 @@ INT WINAPI WinMain (
     frametime = clock_to_seconds ( current_time - old_time );
     realtime += frametime;
 
+    // uploads the font once it's rasterized, text pushed with it before that simply doesn't draw
+    font_logo.finalize ( );
+
+    // ranges our queues moved out of a few frames ago can be reused now
+    pool.begin_frame ( );
+
     daisy::color_t col { 0, 0, 0, 255 };
     g_device->Clear ( 0, nullptr, D3DCLEAR_TARGET, col.bgra, 1.0f, 0 );
-    g_device->BeginScene ( );
 
     // push a filled triangle
     queue.push_filled_triangle ( { 0, 720 }, { 1280 / 2, 0 }, { 1280, 720 }, { 255, 0, 0, 72 }, { 0, 255, 0, 72 }, { 0, 0, 255, 72 } );
@@ -210,19 +293,75 @@ INT WINAPI WinMain (
     // push a filled growing circle arc
     queue.push_filled_arc ( { 160, 160 }, 75.f, 90, fmodf ( realtime * 0.3f, 1.f ), { 255, 255, 255 }, daisy::color_t::from_hsv ( fmodf ( realtime * 30.f, 360.f ), 0.6f, 1.f ) );
 
+    // push a cubic bezier curve, like a node graph connection
+    queue.push_cubic_bezier ( { 800, 500 }, { 950 + 100 * sinf ( realtime ), 500 }, { 950 - 100 * sinf ( realtime ), 700 }, { 1100, 700 }, { 255, 255, 255, 192 }, 2.f );
+
+    // push a marching dashed outline around the curve's area
+    static const float dash_pattern[] = { 8.f, 4.f };
+    static const daisy::point_t outline[] = { { 780, 480 }, { 1120, 480 }, { 1120, 720 }, { 780, 720 } };
+    queue.push_dashed_polyline ( outline, 4, dash_pattern, 2, { 255, 255, 255, 128 }, 1.f, true, -realtime * 20.f );
+
+    // push a plot of 100k samples, decimated to one min/max envelope per pixel column
+    queue.push_plot ( samples.data ( ), static_cast< uint32_t > ( samples.size ( ) ), { 20, 600 }, { 300, 100 }, { -1.f, 1.f }, { 0, 255, 128, 192 } );
+
+    // regenerate the heatmap and upload it, then draw it like any other texture
+    for ( int y = 0; y < 64; ++y )
+      for ( int x = 0; x < 64; ++x )
+        heatmap_pixels[ y * 64 + x ] = static_cast< uint8_t > ( 127.f + 127.f * sinf ( x * 0.2f + realtime * 2.f ) * cosf ( y * 0.2f - realtime ) );
+
+    heatmap.update ( heatmap_pixels.data ( ), 64, daisy::daisy_stream_format::STREAM_GRAY );
+    heatmap.commit ( );
+    queue.push_filled_rectangle ( { 340, 600 }, { 100, 100 }, { 255, 128, 64 }, heatmap.texture_handle ( ) );
+
+    // push a concave polygon; its triangulation is cached after the first frame
+    static const daisy::point_t arrow[] = { { 900, 100 }, { 1000, 150 }, { 900, 200 }, { 930, 150 } };
+    queue.push_polygon ( arrow, 4, { 255, 200, 0, 192 } );
+
+    // push the vector path, rotating around its center
+    const auto badge_transform = daisy::transform_t::translation ( { 1100, 300 } ) * daisy::transform_t::rotation ( realtime );
+    queue.push_filled_path ( badge, { 0, 128, 255, 128 }, badge_transform );
+    queue.push_stroked_path ( badge, { 255, 255, 255 }, 2.f, badge_transform );
+
     // push some wide text
+    queue.push_text_shadow< std::wstring_view > ( atlas, font_gothic, { 11, 11 }, L"this is a test for wide text! 朋友你好!\nthis is a test for wide text! 朋友你好!\nthis is a test for wide text! 朋友你好!", 12, { 0, 0, 0, 128 } );
     queue.push_text< std::wstring_view > ( font_gothic, { 10, 10 }, L"this is a test for wide text! 朋友你好!\nthis is a test for wide text! 朋友你好!\nthis is a test for wide text! 朋友你好!", { 255, 255, 255, 192 } );
 
     // push some ascii text
     queue.push_text< std::string_view > ( font_logo, { 1280 / 2, 800 / 2 + 50 * sinf ( realtime * 3.f ) }, "this ascii text is at the center of the window. also, it has a different font!", daisy::color_t::from_hsv ( fmodf ( realtime * 30.f, 360.f ), 0.6f, 1.f ), daisy::TEXT_ALIGNX_CENTER | daisy::TEXT_ALIGNY_CENTER );
 
+    // soft drop shadow behind the logo, it batches with the atlas draws below
+    queue.push_shadow_rect ( atlas, { 510 + 20 * sinf ( realtime * 3.f ), 110 + 20 * sinf ( realtime * 3.f ) }, { 448 + 20 * sinf ( realtime * 3.f ), 93 + 4 * sinf ( realtime * 3.f ) }, 12, { 0, 0, 0, 160 } );
+
+    // patch the meter bars instead of clearing and re-pushing the retained queue
+    for ( size_t i = 0; i < meter_bars.size ( ); ++i )
+    {
+      const float level = 0.5f + 0.5f * sinf ( realtime * 2.f + static_cast< float > ( i ) );
+      meters.set_rectangle ( meter_bars[ i ], { 1100.f + static_cast< float > ( i ) * 16.f, 780 - 80 * level }, { 12, 80 * level } );
+      meters.set_color ( meter_bars[ i ], daisy::color_t::from_hsv ( 120.f * level, 0.8f, 0.9f ) );
+    }
+
     // push the daisy logo from the texture atlas
     auto daisy_image_coords = atlas.coords ( 1 );
     queue.push_filled_rectangle ( { 500 + 20 * sinf ( realtime * 3.f ), 100 + 20 * sinf ( realtime * 3.f ) }, { 448 + 20 * sinf ( realtime * 3.f ), 93 + 4 * sinf ( realtime * 3.f ) }, { 255, 255, 255 }, atlas.texture_handle ( ), { daisy_image_coords[ 0 ], daisy_image_coords[ 1 ] }, { daisy_image_coords[ 2 ], daisy_image_coords[ 3 ] } );
 
+    // push the rasterized icon from the texture atlas
+    auto icon_coords = atlas.path_coords ( 2, { 32, 32 } );
+    queue.push_filled_rectangle ( { 1200, 40 }, { 32, 32 }, { 255, 128, 0 }, atlas.texture_handle ( ), { icon_coords[ 0 ], icon_coords[ 1 ] }, { icon_coords[ 2 ], icon_coords[ 3 ] } );
+
+    // upload everything before the scene starts, so flushing below only has to submit draw calls
+    daisy::c_renderqueue::upload_all ( { &queue, &overlay, &meters } );
+    double_buffer_queue.prepare ( );
+
+    g_device->BeginScene ( );
+
     // flushing of all render queues should happen here
-    queue.flush ( );
+    // queues of the same pool flushed back to back only bind its buffers once
+    daisy::c_renderqueue::flush_all ( { &queue, &overlay } );
     double_buffer_queue.flush ( );
+    markers.flush ( );
+    labels.flush ( );
+    meters_frame.flush ( );
+    meters.flush ( );
 
     // clearing is necessary if your queue has dynamic data
     queue.clear ( );
@@ -0,0 +1,622 @@
+// headless golden image and timing harness for the platform-neutral core (see DAISY_NO_D3D9 in the README)
+// renders a few canonical scenes through c_drawlist into a c_softtarget and compares them against references/*.tga, and times how long building
+// each scene takes against baseline.txt. run with --update to rewrite the references or the baseline after an intended change
+//
+// usage: daisy_harness golden <references directory> [--update]
+//        daisy_harness timing <baseline file> [--update]
+
+#ifndef DAISY_NO_D3D9
+#define DAISY_NO_D3D9
+#endif // DAISY_NO_D3D9
+#include "../daisy.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr uint32_t SCENE_WIDTH = 256;
+  constexpr uint32_t SCENE_HEIGHT = 192;
+
+  // largest per channel difference a pixel may have from its reference
+  constexpr uint8_t PIXEL_TOLERANCE = 2;
+
+  // how much slower than the baseline a scene may get, unless the baseline file says otherwise
+  constexpr double DEFAULT_TIMING_TOLERANCE = 0.5;
+
+  // the baseline is recorded with optimizations, unoptimized builds are too slow to compare against it (the calibration loop doesn't slow
+  // down by the same factor). ctest reports this exit code as skipped
+  constexpr int EXIT_SKIPPED = 77;
+#if defined( __OPTIMIZE__ ) || ( defined( _MSC_VER ) && defined( NDEBUG ) )
+  constexpr bool OPTIMIZED = true;
+#else
+  constexpr bool OPTIMIZED = false;
+#endif
+
+  // deterministic pseudo random numbers, scenes have to look the same on every run and platform
+  struct lcg_t
+  {
+    uint32_t m_state;
+
+    uint32_t next ( ) noexcept
+    {
+      this->m_state = this->m_state * 1664525u + 1013904223u;
+      return this->m_state >> 8;
+    }
+
+    float range ( const float min, const float max ) noexcept
+    {
+      return min + ( max - min ) * static_cast< float > ( this->next ( ) & 0xffff ) / 65535.f;
+    }
+  };
+
+  // monospace bitmap font with procedurally generated glyphs, stands in for c_fontwrapper (which needs GDI)
+  class c_harnessfont
+  {
+  private:
+    constexpr static inline uint32_t CELL_WIDTH = 6, CELL_HEIGHT = 8, COLUMNS = 16, ROWS = 6;
+    constexpr static inline float SCALE = 2.f;
+
+    std::vector< uint32_t > m_pixels;
+    daisy::softtexture_t m_texture;
+
+  public:
+    c_harnessfont ( ) : m_pixels ( COLUMNS * CELL_WIDTH * ROWS * CELL_HEIGHT, 0 ), m_texture { nullptr, COLUMNS * CELL_WIDTH, ROWS * CELL_HEIGHT }
+    {
+      // 5x7 glyph per printable ascii character, bits picked from a hash of the character. space stays empty
+      for ( uint32_t c = 33; c < 128; ++c )
+      {
+        const uint32_t cell_x = ( ( c - 32 ) % COLUMNS ) * CELL_WIDTH, cell_y = ( ( c - 32 ) / COLUMNS ) * CELL_HEIGHT;
+
+        lcg_t bits { c * 2654435761u };
+        for ( uint32_t y = 0; y < 7; ++y )
+        {
+          const uint32_t row = bits.next ( );
+          for ( uint32_t x = 0; x < 5; ++x )
+            if ( row & ( 1u << x ) )
+              this->m_pixels[ ( cell_y + y ) * this->m_texture.m_width + cell_x + x ] = 0xffffffff;
+        }
+      }
+
+      this->m_texture.m_pixels = this->m_pixels.data ( );
+    }
+
+    c_harnessfont ( const c_harnessfont & ) = delete;
+    c_harnessfont &operator= ( const c_harnessfont & ) = delete;
+
+    daisy::daisy_texture_t texture_handle ( ) noexcept
+    {
+      return &this->m_texture;
+    }
+
+    // same contract as c_fontwrapper::for_each_glyph
+    template < typename t, typename fn_t >
+    void for_each_glyph ( const daisy::point_t &position, const t text, uint16_t alignment, fn_t &&fn ) noexcept
+    {
+      const float glyph_width = CELL_WIDTH * SCALE, glyph_height = CELL_HEIGHT * SCALE;
+
+      daisy::point_t pen { position };
+
+      if ( alignment != daisy::TEXT_ALIGN_DEFAULT )
+      {
+        uint32_t columns = 0, lines = 1, current = 0;
+        for ( const auto c : text )
+        {
+          if ( c == '\n' )
+          {
+            ++lines;
+            current = 0;
+          }
+          else
+            columns = std::max ( columns, ++current );
+        }
+
+        if ( alignment & daisy::TEXT_ALIGNX_CENTER )
+          pen.x -= std::floor ( 0.5f * columns * glyph_width );
+
+        if ( alignment & daisy::TEXT_ALIGNY_CENTER )
+          pen.y -= std::floor ( 0.5f * lines * glyph_height );
+      }
+
+      const float start_x = pen.x;
+
+      for ( const auto c : text )
+      {
+        if ( c == '\n' )
+        {
+          pen.x = start_x;
+          pen.y += glyph_height;
+          continue;
+        }
+
+        if ( c < ' ' || c > '~' )
+          continue;
+
+        if ( c != ' ' )
+        {
+          const float u = static_cast< float > ( ( ( c - 32 ) % COLUMNS ) * CELL_WIDTH ) / this->m_texture.m_width;
+          const float v = static_cast< float > ( ( ( c - 32 ) / COLUMNS ) * CELL_HEIGHT ) / this->m_texture.m_height;
+
+          fn ( pen, daisy::point_t { glyph_width, glyph_height },
+               daisy::uv_t { u, v, u + static_cast< float > ( CELL_WIDTH ) / this->m_texture.m_width, v + static_cast< float > ( CELL_HEIGHT ) / this->m_texture.m_height } );
+        }
+
+        pen.x += glyph_width;
+      }
+    }
+  };
+
+  // 2x2 sprites of 32x32 pixels: checkerboard, ring, stripes and diamond
+  class c_harnessatlas
+  {
+  private:
+    std::vector< uint32_t > m_pixels;
+    daisy::softtexture_t m_texture;
+
+  public:
+    c_harnessatlas ( ) : m_pixels ( 64 * 64, 0 ), m_texture { nullptr, 64, 64 }
+    {
+      for ( uint32_t y = 0; y < 64; ++y )
+      {
+        for ( uint32_t x = 0; x < 64; ++x )
+        {
+          const int32_t sx = x % 32, sy = y % 32, dx = sx - 16, dy = sy - 16;
+          bool set = false;
+
+          switch ( ( y / 32 ) * 2 + x / 32 )
+          {
+          case 0:
+            set = ( ( sx / 4 ) + ( sy / 4 ) ) % 2 == 0;
+            break;
+          case 1:
+            set = dx * dx + dy * dy < 225 && dx * dx + dy * dy > 64;
+            break;
+          case 2:
+            set = ( sx + sy ) % 8 < 4;
+            break;
+          default:
+            set = std::abs ( dx ) + std::abs ( dy ) < 14;
+            break;
+          }
+
+          // alpha ramps down the sprite, so blending gets exercised too
+          this->m_pixels[ y * 64 + x ] = set ? ( static_cast< uint32_t > ( 255 - sy * 4 ) << 24 ) | 0x00ffffff : 0;
+        }
+      }
+
+      this->m_texture.m_pixels = this->m_pixels.data ( );
+    }
+
+    c_harnessatlas ( const c_harnessatlas & ) = delete;
+    c_harnessatlas &operator= ( const c_harnessatlas & ) = delete;
+
+    daisy::daisy_texture_t texture_handle ( ) noexcept
+    {
+      return &this->m_texture;
+    }
+  };
+
+  c_harnessfont g_font;
+  c_harnessatlas g_atlas;
+
+  // walls of text in a few colors, one block centered
+  void scene_text_wall ( daisy::c_drawlist &list )
+  {
+    static const char *const lines[] = { "the quick brown fox jumps over the lazy dog", "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG",
+                                         "0123456789 !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~", "daisy renders text in batches of glyph quads" };
+
+    for ( uint32_t i = 0; i < 10; ++i )
+      list.push_text< std::string_view > ( g_font, { 2.f, 2.f + i * 16.f }, lines[ i % 4 ], { static_cast< uint8_t > ( 255 - i * 20 ), 255, static_cast< uint8_t > ( 80 + i * 16 ), 220 } );
+
+    list.push_text< std::string_view > ( g_font, { SCENE_WIDTH / 2.f, 168.f }, "centered\nblock", { 255, 200, 64 }, daisy::TEXT_ALIGNX_CENTER | daisy::TEXT_ALIGNY_CENTER );
+  }
+
+  // grid of the basic primitives, the lower half is drawn through a scissor rectangle
+  void scene_shape_grid ( daisy::c_drawlist &list )
+  {
+    constexpr uint32_t columns = 8, rows = 6;
+    constexpr float cell_w = static_cast< float > ( SCENE_WIDTH ) / columns, cell_h = static_cast< float > ( SCENE_HEIGHT ) / rows;
+
+    for ( uint32_t row = 0; row < rows; ++row )
+    {
+      if ( row == rows / 2 )
+      {
+        daisy::point_t position { 16.f, cell_h * row }, size { SCENE_WIDTH - 32.f, cell_h * ( rows - row ) - 16.f };
+        list.push_scissor ( position, size );
+      }
+
+      for ( uint32_t column = 0; column < columns; ++column )
+      {
+        const float x = column * cell_w + 4.f, y = row * cell_h + 4.f, w = cell_w - 8.f, h = cell_h - 8.f;
+        const daisy::color_t col { static_cast< uint8_t > ( column * 32 ), static_cast< uint8_t > ( row * 40 ), static_cast< uint8_t > ( 255 - column * 24 ), 200 };
+
+        switch ( ( row * columns + column ) % 6 )
+        {
+        case 0:
+          list.push_filled_rectangle ( { x, y }, { w, h }, col );
+          break;
+        case 1:
+          list.push_gradient_rectangle ( { x, y }, { w, h }, col, { 255, 255, 255, 128 }, { 0, 0, 0, 255 }, col );
+          break;
+        case 2:
+          list.push_filled_triangle ( { x, y + h }, { x + w / 2.f, y }, { x + w, y + h }, { 255, 0, 0 }, { 0, 255, 0 }, { 0, 0, 255 } );
+          break;
+        case 3:
+          list.push_line ( { x, y }, { x + w, y + h }, col, 1.f + ( column % 3 ) );
+          break;
+        case 4: {
+          const daisy::point_t hexagon[] = { { x + w * 0.25f, y }, { x + w * 0.75f, y }, { x + w, y + h * 0.5f }, { x + w * 0.75f, y + h }, { x + w * 0.25f, y + h }, { x, y + h * 0.5f } };
+          list.push_convex_polygon ( hexagon, 6, col );
+          break;
+        }
+        default: {
+          const daisy::point_t zigzag[] = { { x, y + h }, { x + w * 0.33f, y }, { x + w * 0.66f, y + h }, { x + w, y } };
+          list.push_polyline ( zigzag, 4, col, 2.f );
+          break;
+        }
+        }
+      }
+    }
+  }
+
+  // arcs of every fill factor and segment count, plus full circles
+  void scene_arcs ( daisy::c_drawlist &list )
+  {
+    for ( uint32_t i = 0; i < 24; ++i )
+    {
+      const float x = 22.f + ( i % 6 ) * 42.f, y = 24.f + ( i / 6 ) * 46.f;
+      const daisy::color_t outer { static_cast< uint8_t > ( i * 10 ), 128, static_cast< uint8_t > ( 255 - i * 10 ), 255 };
+
+      if ( i % 6 == 5 )
+        list.push_filled_circle ( { x, y }, 18.f, 8 + static_cast< int > ( i ), { 255, 255, 255 }, outer );
+      else
+        list.push_filled_arc ( { x, y }, 18.f, 12 + static_cast< int > ( i ) * 2, 0.1f + 0.15f * ( i % 6 ), { 255, 255, 255, 200 }, outer );
+    }
+  }
+
+  // lots of tinted sprites from one atlas, overlapping so blending order matters
+  void scene_atlas_sprites ( daisy::c_drawlist &list )
+  {
+    lcg_t rng { 1234 };
+
+    for ( uint32_t i = 0; i < 400; ++i )
+    {
+      const uint32_t sprite = rng.next ( ) % 4;
+      const float u = ( sprite % 2 ) * 0.5f, v = ( sprite / 2 ) * 0.5f, size = rng.range ( 12.f, 48.f );
+      const daisy::color_t tint { static_cast< uint8_t > ( rng.next ( ) ), static_cast< uint8_t > ( rng.next ( ) ), static_cast< uint8_t > ( rng.next ( ) ), 255 };
+
+      list.push_filled_rectangle ( { rng.range ( -16.f, SCENE_WIDTH - 16.f ), rng.range ( -16.f, SCENE_HEIGHT - 16.f ) }, { size, size }, tint, g_atlas.texture_handle ( ), { u, v },
+                                   { u + 0.5f, v + 0.5f } );
+    }
+  }
+
+  struct scene_t
+  {
+    const char *m_name;
+    void ( *m_build ) ( daisy::c_drawlist &list );
+  };
+
+  const scene_t g_scenes[] = { { "text_wall", scene_text_wall }, { "shape_grid", scene_shape_grid }, { "arcs", scene_arcs }, { "atlas_sprites", scene_atlas_sprites } };
+
+  // writes a run length encoded 32 bit tga, top-left origin
+  bool write_tga ( const std::string &path, const uint32_t *pixels, const uint32_t width, const uint32_t height )
+  {
+    FILE *file = fopen ( path.c_str ( ), "wb" );
+    if ( !file )
+      return false;
+
+    const uint8_t header[ 18 ] = { 0, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, static_cast< uint8_t > ( width ), static_cast< uint8_t > ( width >> 8 ), static_cast< uint8_t > ( height ),
+                                   static_cast< uint8_t > ( height >> 8 ), 32, 0x28 };
+    fwrite ( header, 1, sizeof ( header ), file );
+
+    for ( uint32_t y = 0; y < height; ++y )
+    {
+      const uint32_t *row = pixels + y * width;
+
+      for ( uint32_t x = 0; x < width; )
+      {
+        // packets never cross rows and hold at most 128 pixels
+        uint32_t run = 1;
+        while ( x + run < width && run < 128 && row[ x + run ] == row[ x ] )
+          ++run;
+
+        if ( run > 1 )
+        {
+          fputc ( static_cast< int > ( 0x80 | ( run - 1 ) ), file );
+          fwrite ( &row[ x ], 4, 1, file );
+        }
+        else
+        {
+          while ( x + run < width && run < 128 && row[ x + run ] != row[ x + run - 1 ] )
+            ++run;
+
+          // leave the pixel starting the next repeat to its own packet
+          if ( x + run < width && run > 1 && row[ x + run ] == row[ x + run - 1 ] )
+            --run;
+
+          fputc ( static_cast< int > ( run - 1 ), file );
+          fwrite ( &row[ x ], 4, run, file );
+        }
+
+        x += run;
+      }
+    }
+
+    return fclose ( file ) == 0;
+  }
+
+  // reads a tga written by write_tga
+  bool read_tga ( const std::string &path, std::vector< uint32_t > &pixels, const uint32_t width, const uint32_t height )
+  {
+    FILE *file = fopen ( path.c_str ( ), "rb" );
+    if ( !file )
+      return false;
+
+    uint8_t header[ 18 ];
+    bool result = fread ( header, 1, sizeof ( header ), file ) == sizeof ( header ) && header[ 2 ] == 10 && header[ 16 ] == 32 &&
+                  static_cast< uint32_t > ( header[ 12 ] | header[ 13 ] << 8 ) == width && static_cast< uint32_t > ( header[ 14 ] | header[ 15 ] << 8 ) == height;
+
+    pixels.assign ( static_cast< size_t > ( width ) * height, 0 );
+
+    for ( size_t i = 0; result && i < pixels.size ( ); )
+    {
+      const int packet = fgetc ( file );
+      const size_t count = static_cast< size_t > ( ( packet & 0x7f ) + 1 );
+
+      if ( packet < 0 || i + count > pixels.size ( ) )
+        result = false;
+      else if ( packet & 0x80 )
+      {
+        result = fread ( &pixels[ i ], 4, 1, file ) == 1;
+        std::fill ( pixels.begin ( ) + i + 1, pixels.begin ( ) + i + count, pixels[ i ] );
+      }
+      else
+        result = fread ( &pixels[ i ], 4, count, file ) == count;
+
+      i += count;
+    }
+
+    fclose ( file );
+    return result;
+  }
+
+  // renders every scene and compares it against its reference
+  int run_golden ( const std::string &directory, const bool update )
+  {
+    daisy::c_drawlist list;
+    daisy::c_softtarget target;
+    if ( !list.create ( 1024, 2048 ) || !target.create ( SCENE_WIDTH, SCENE_HEIGHT ) )
+      return EXIT_FAILURE;
+
+    int failures = 0;
+
+    for ( const auto &scene : g_scenes )
+    {
+      list.clear ( );
+      scene.m_build ( list );
+
+      target.clear ( { 24, 24, 32, 255 } );
+      target.draw ( list );
+
+      const std::string path = directory + "/" + scene.m_name + ".tga";
+
+      if ( update )
+      {
+        if ( !write_tga ( path, target.pixels ( ), SCENE_WIDTH, SCENE_HEIGHT ) )
+        {
+          printf ( "%-14s can't write %s\n", scene.m_name, path.c_str ( ) );
+          ++failures;
+        }
+        else
+          printf ( "%-14s updated\n", scene.m_name );
+
+        continue;
+      }
+
+      std::vector< uint32_t > reference;
+      if ( !read_tga ( path, reference, SCENE_WIDTH, SCENE_HEIGHT ) )
+      {
+        printf ( "%-14s FAIL can't read %s\n", scene.m_name, path.c_str ( ) );
+        ++failures;
+        continue;
+      }
+
+      const uint32_t mismatches = target.compare ( reference.data ( ), PIXEL_TOLERANCE );
+      if ( mismatches )
+      {
+        // keep what we rendered around, so it can be diffed against the reference
+        const std::string actual = std::string ( scene.m_name ) + ".actual.tga";
+        write_tga ( actual, target.pixels ( ), SCENE_WIDTH, SCENE_HEIGHT );
+
+        printf ( "%-14s FAIL %u pixels differ, see %s\n", scene.m_name, mismatches, actual.c_str ( ) );
+        ++failures;
+      }
+      else
+        printf ( "%-14s ok (%u calls, %u vertices)\n", scene.m_name, list.drawcalls ( ).size ( ), list.vertex_count ( ) );
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  // median time of a callable in nanoseconds, over several samples of enough iterations to outlast timer noise
+  template < typename fn_t >
+  double median_ns ( fn_t &&fn )
+  {
+    using clock = std::chrono::steady_clock;
+
+    // warm up and pick an iteration count that takes ~2ms
+    uint32_t iterations = 1;
+    for ( ;; )
+    {
+      const auto start = clock::now ( );
+      for ( uint32_t i = 0; i < iterations; ++i )
+        fn ( );
+
+      if ( clock::now ( ) - start > std::chrono::milliseconds ( 2 ) || iterations >= ( 1u << 20 ) )
+        break;
+
+      iterations *= 2;
+    }
+
+    std::vector< double > samples;
+    for ( uint32_t s = 0; s < 21; ++s )
+    {
+      const auto start = clock::now ( );
+      for ( uint32_t i = 0; i < iterations; ++i )
+        fn ( );
+
+      samples.push_back ( std::chrono::duration< double, std::nano > ( clock::now ( ) - start ).count ( ) / iterations );
+    }
+
+    std::nth_element ( samples.begin ( ), samples.begin ( ) + samples.size ( ) / 2, samples.end ( ) );
+    return samples[ samples.size ( ) / 2 ];
+  }
+
+  // fixed amount of scalar work, scene timings are stored relative to it so the baseline carries over to faster or slower machines
+  double calibrate ( )
+  {
+    volatile float sink = 0.f;
+
+    return median_ns ( [ & ] ( ) {
+      lcg_t rng { 42 };
+      float sum = 0.f;
+      for ( uint32_t i = 0; i < 4096; ++i )
+        sum += std::sqrt ( rng.range ( 0.f, 100.f ) ) * 0.5f;
+      sink = sum;
+    } );
+  }
+
+  struct baseline_t
+  {
+    std::string m_name;
+    double m_relative;
+    uint32_t m_calls;
+  };
+
+  // times building every scene and compares it against the baseline. batching is deterministic, so draw call counts mustn't grow (fewer calls
+  // pass, rerun with --update to lock them in)
+  int run_timing ( const std::string &path, const bool update )
+  {
+    if ( !OPTIMIZED )
+    {
+      printf ( "skipped, timings are only compared in optimized builds (eg. CMAKE_BUILD_TYPE=Release)\n" );
+      return EXIT_SKIPPED;
+    }
+
+    daisy::c_drawlist list;
+    if ( !list.create ( 1024, 2048 ) )
+      return EXIT_FAILURE;
+
+    double tolerance = DEFAULT_TIMING_TOLERANCE;
+    std::vector< baseline_t > baseline;
+
+    if ( !update )
+    {
+      FILE *file = fopen ( path.c_str ( ), "r" );
+      if ( !file )
+      {
+        printf ( "can't read %s, run with --update to record a baseline\n", path.c_str ( ) );
+        return EXIT_FAILURE;
+      }
+
+      char line[ 256 ], name[ 64 ];
+      double relative;
+      uint32_t calls;
+
+      while ( fgets ( line, sizeof ( line ), file ) )
+      {
+        if ( line[ 0 ] == '#' )
+          continue;
+
+        if ( sscanf ( line, "tolerance %lf", &relative ) == 1 )
+          tolerance = relative;
+        else if ( sscanf ( line, "%63s %lf %u", name, &relative, &calls ) == 3 )
+          baseline.push_back ( { name, relative, calls } );
+      }
+
+      fclose ( file );
+    }
+
+    const double unit = calibrate ( );
+    printf ( "calibration %.0f ns\n", unit );
+
+    std::vector< baseline_t > measured;
+    int failures = 0;
+
+    for ( const auto &scene : g_scenes )
+    {
+      const double ns = median_ns ( [ & ] ( ) {
+        list.clear ( );
+        scene.m_build ( list );
+      } );
+
+      const baseline_t result { scene.m_name, ns / unit, list.drawcalls ( ).size ( ) };
+      measured.push_back ( result );
+
+      if ( update )
+      {
+        printf ( "%-14s %9.0f ns  %.3f  %u calls\n", scene.m_name, ns, result.m_relative, result.m_calls );
+        continue;
+      }
+
+      const auto expected = std::find_if ( baseline.begin ( ), baseline.end ( ), [ & ] ( const baseline_t &entry ) { return entry.m_name == scene.m_name; } );
+      if ( expected == baseline.end ( ) )
+      {
+        printf ( "%-14s FAIL not in baseline\n", scene.m_name );
+        ++failures;
+        continue;
+      }
+
+      const bool slower = result.m_relative > expected->m_relative * ( 1.0 + tolerance );
+      const bool more_calls = result.m_calls > expected->m_calls;
+
+      printf ( "%-14s %s %9.0f ns  %.3f (baseline %.3f, %+.1f%%)  %u calls (baseline %u)\n", scene.m_name, slower || more_calls ? "FAIL" : "ok  ", ns, result.m_relative,
+               expected->m_relative, ( result.m_relative / expected->m_relative - 1.0 ) * 100.0, result.m_calls, expected->m_calls );
+
+      failures += slower || more_calls;
+    }
+
+    if ( update )
+    {
+      FILE *file = fopen ( path.c_str ( ), "w" );
+      if ( !file )
+        return EXIT_FAILURE;
+
+      fprintf ( file, "# time to build each scene relative to the calibration loop, and its draw call count. written by daisy_harness timing --update\n" );
+      fprintf ( file, "# a scene fails if it gets slower than baseline * (1 + tolerance) or needs more draw calls\n" );
+      fprintf ( file, "tolerance %.2f\n", tolerance );
+
+      for ( const auto &entry : measured )
+        fprintf ( file, "%s %.4f %u\n", entry.m_name.c_str ( ), entry.m_relative, entry.m_calls );
+
+      return fclose ( file ) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+} // namespace
+
+int main ( int argc, char **argv )
+{
+  if ( argc < 3 )
+  {
+    printf ( "usage: %s golden <references directory> [--update]\n       %s timing <baseline file> [--update]\n", argv[ 0 ], argv[ 0 ] );
+    return EXIT_FAILURE;
+  }
+
+  const bool update = argc > 3 && !strcmp ( argv[ 3 ], "--update" );
+
+  if ( !strcmp ( argv[ 1 ], "golden" ) )
+    return run_golden ( argv[ 2 ], update );
+
+  if ( !strcmp ( argv[ 1 ], "timing" ) )
+    return run_timing ( argv[ 2 ], update );
+
+  printf ( "unknown mode %s\n", argv[ 1 ] );
+  return EXIT_FAILURE;
+}